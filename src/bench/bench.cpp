@@ -0,0 +1,85 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+CBenchmark *CBenchmark::ms_pFirst = nullptr;
+const CBenchmark *CBenchmark::ms_pCurrent = nullptr;
+
+CBenchmark::CBenchmark(const char *pGroup, const char *pName, FRun pfnRun)
+{
+	m_pGroup = pGroup;
+	m_pName = pName;
+	m_pfnRun = pfnRun;
+	m_pNext = ms_pFirst;
+	ms_pFirst = this;
+}
+
+int CBenchmark::RunAll(const char *pFilter)
+{
+	// the registration order depends on the link order, sort by name
+	std::vector<const CBenchmark *> vpBenchmarks;
+	for(const CBenchmark *pBenchmark = ms_pFirst; pBenchmark; pBenchmark = pBenchmark->m_pNext)
+		vpBenchmarks.push_back(pBenchmark);
+	std::sort(vpBenchmarks.begin(), vpBenchmarks.end(), [](const CBenchmark *pA, const CBenchmark *pB) {
+		const int Group = str_comp(pA->m_pGroup, pB->m_pGroup);
+		return Group != 0 ? Group < 0 : str_comp(pA->m_pName, pB->m_pName) < 0;
+	});
+
+	int NumRun = 0;
+	for(const CBenchmark *pBenchmark : vpBenchmarks)
+	{
+		char aFullName[128];
+		str_format(aFullName, sizeof(aFullName), "%s.%s", pBenchmark->m_pGroup, pBenchmark->m_pName);
+		if(!str_find_nocase(aFullName, pFilter))
+			continue;
+
+		printf("[ RUN      ] %s\n", aFullName);
+		ms_pCurrent = pBenchmark;
+		const int64_t Start = time_get();
+		pBenchmark->m_pfnRun();
+		printf("[     DONE ] %s (%.0f ms)\n", aFullName, BenchMs(Start));
+		ms_pCurrent = nullptr;
+		NumRun++;
+	}
+	return NumRun;
+}
+
+void CBenchmark::Report(const char *pFormat, ...)
+{
+	printf("[ BENCH    ] %s.%s: ", ms_pCurrent->m_pGroup, ms_pCurrent->m_pName);
+	va_list Args;
+	va_start(Args, pFormat);
+	vprintf(pFormat, Args);
+	va_end(Args);
+	printf("\n");
+}
+
+int main(int argc, const char **argv)
+{
+	cmdline_fix(&argc, &argv);
+	if(argc > 2)
+	{
+		printf("usage: %s [filter]\n", argv[0]);
+		cmdline_free(argc, argv);
+		return 1;
+	}
+
+	const char *pFilter = argc == 2 ? argv[1] : "";
+	const int NumRun = CBenchmark::RunAll(pFilter);
+	if(NumRun == 0)
+		printf("no benchmark matches '%s'\n", pFilter);
+	cmdline_free(argc, argv);
+	return NumRun > 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef BENCH_BENCH_H
+#define BENCH_BENCH_H
+
+#include <base/system.h>
+
+/*
+	Class: Benchmark
+		A timed run, kept out of the testrunner. BENCHMARK(Group, Name)
+		defines one; benchrunner runs every benchmark whose name contains
+		its argument. The unit tests check that the compared paths give
+		the same results, benchmarks only assert what keeps the timing
+		honest.
+*/
+class CBenchmark
+{
+	typedef void (*FRun)();
+
+	const char *m_pGroup;
+	const char *m_pName;
+	FRun m_pfnRun;
+	CBenchmark *m_pNext;
+
+	static CBenchmark *ms_pFirst;
+	static const CBenchmark *ms_pCurrent;
+
+public:
+	CBenchmark(const char *pGroup, const char *pName, FRun pfnRun);
+
+	// returns the number of benchmarks that ran
+	static int RunAll(const char *pFilter);
+	static void Report(const char *pFormat, ...)
+		GNUC_ATTRIBUTE((format(printf, 1, 2)));
+};
+
+// milliseconds since Start, which was taken with time_get
+inline double BenchMs(int64_t Start)
+{
+	return (time_get() - Start) * 1000.0 / time_freq();
+}
+
+#define BENCHMARK(Group, Name) \
+	static void Benchmark_##Group##_##Name(); \
+	static CBenchmark gs_Benchmark_##Group##_##Name(#Group, #Name, Benchmark_##Group##_##Name); \
+	static void Benchmark_##Group##_##Name()
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "bench.h"
+
+#include <game/collision.h>
+#include <test/test.h>
+
+#include <vector>
+
+BENCHMARK(Collision, IntersectLine)
+{
+	static const int NUM_LINES = 200000;
+
+	CCollision Collision;
+	CreateTestMap(&Collision, 200, 100, 0.02f, 3);
+
+	std::vector<vec2> vLines;
+	CTestRandom Random(3);
+	for(int i = 0; i < NUM_LINES; i++)
+	{
+		vec2 Pos0(Random.Range(32.0f, 6368.0f), Random.Range(32.0f, 3168.0f));
+		vLines.push_back(Pos0);
+		vLines.push_back(Pos0 + direction(Random.Range(0.0f, 2 * pi)) * Random.Range(50.0f, 800.0f));
+	}
+
+	vec2 Out, Before;
+	int aHits[2] = {0, 0};
+	double aTime[2];
+
+	int64_t Start = time_get();
+	for(int i = 0; i < NUM_LINES; i++)
+		aHits[0] += IntersectLineSampled(Collision, vLines[i * 2], vLines[i * 2 + 1], &Out, &Before) != 0;
+	aTime[0] = BenchMs(Start);
+
+	Start = time_get();
+	for(int i = 0; i < NUM_LINES; i++)
+		aHits[1] += Collision.IntersectLine(vLines[i * 2], vLines[i * 2 + 1], &Out, &Before) != 0;
+	aTime[1] = BenchMs(Start);
+
+	dbg_assert(aHits[0] == aHits[1], "sampled and skipping lines hit differently");
+	CBenchmark::Report("%d lines: %.2fms sampled, %.2fms skipping", NUM_LINES, aTime[0], aTime[1]);
+}
+
+BENCHMARK(Collision, MoveBox)
+{
+	static const int NUM_BODIES = 200;
+	static const int NUM_TICKS = 1000;
+
+	CCollision Collision;
+	CreateTestMap(&Collision, 200, 100, 0.03f, 5);
+
+	double aTime[3];
+	for(int Mode = 0; Mode < 3; Mode++)
+	{
+		CTestRandom Random(5);
+		std::vector<STestBody> vBodies = CreateTestBodies(&Random, NUM_BODIES, vec2(200 * 32.0f, 100 * 32.0f));
+		Collision.SetSweptMoveBox(Mode == 2);
+		bool Death;
+		const int64_t Start = time_get();
+		for(int Tick = 0; Tick < NUM_TICKS; Tick++)
+		{
+			for(STestBody &Body : vBodies)
+			{
+				KickTestBody(&Random, &Body);
+				if(Mode == 0)
+					MoveBoxStepped(Collision, &Body.m_Pos, &Body.m_Vel, vec2(28.0f, 28.0f), 0.0f, &Death);
+				else
+					Collision.MoveBox(&Body.m_Pos, &Body.m_Vel, vec2(28.0f, 28.0f), 0.0f, &Death);
+			}
+		}
+		aTime[Mode] = BenchMs(Start);
+	}
+
+	CBenchmark::Report("%d boxes, %d ticks: %.2fms stepped, %.2fms exact, %.2fms swept", NUM_BODIES, NUM_TICKS, aTime[0], aTime[1], aTime[2]);
+}
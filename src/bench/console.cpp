@@ -0,0 +1,62 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "bench.h"
+
+#include <base/math.h>
+
+#include <engine/shared/config.h>
+#include <engine/shared/console.h>
+
+#include <string>
+#include <vector>
+
+static void ConCount(IConsole::IResult *pResult, void *pUserData)
+{
+	(*static_cast<int *>(pUserData))++;
+}
+
+BENCHMARK(Console, LargeConfig)
+{
+	static const int NUM_COMMANDS = 1000;
+	static const int NUM_LINES = 20000;
+
+	char aaNames[NUM_COMMANDS][32];
+	std::vector<std::string> vLines;
+	for(int i = 0; i < NUM_LINES; i++)
+	{
+		char aLine[128];
+		// autoexec style: mostly variables, some of them set repeatedly
+		str_format(aLine, sizeof(aLine), "cmd_%d %d", (i * 7) % NUM_COMMANDS, i % 50);
+		vLines.push_back(aLine);
+	}
+
+	double aTime[2];
+	for(int UseCache = 0; UseCache < 2; UseCache++)
+	{
+		CConsole Console(CFGFLAG_SERVER);
+		Console.SetParsedLineCache(UseCache);
+		Console.StoreCommands(false);
+		int NumCalls = 0;
+		for(int i = 0; i < NUM_COMMANDS; i++)
+		{
+			str_format(aaNames[i], sizeof(aaNames[i]), "cmd_%d", i);
+			Console.Register(aaNames[i], "?i", CFGFLAG_SERVER, ConCount, &NumCalls, "");
+		}
+
+		const int64_t Start = time_get();
+		for(const std::string &Line : vLines)
+			Console.ExecuteLine(Line.c_str());
+		aTime[UseCache] = BenchMs(Start);
+		dbg_assert(NumCalls == NUM_LINES, "a config line did not reach its command");
+	}
+
+	CBenchmark::Report("%d lines, %d commands: %.2fms parsing every line, %.2fms with parsed lines",
+		NUM_LINES, NUM_COMMANDS, aTime[0], aTime[1]);
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "bench.h"
+
+#include <game/collision.h>
+#include <game/gamecore.h>
+#include <test/test.h>
+
+#include <memory>
+
+BENCHMARK(CharacterCoreBatch, Tick)
+{
+	static const int MAP_SIZE = 64;
+	static const int NUM_CHARACTERS = 64;
+	static const int NUM_TICKS = 2000;
+
+	CCollision Collision;
+	CreateTestMap(&Collision, MAP_SIZE, MAP_SIZE, 0.06f, 4, 8);
+
+	struct CWorld
+	{
+		CWorldCore m_World;
+		CCharacterCore m_aCores[NUM_CHARACTERS];
+		CCharacterCoreBatch m_Batch;
+	};
+
+	double aTime[2];
+	for(int UseBatch = 0; UseBatch < 2; UseBatch++)
+	{
+		std::unique_ptr<CWorld> pWorld = std::make_unique<CWorld>();
+		CTestRandom Random(4);
+		for(int i = 0; i < NUM_CHARACTERS; i++)
+		{
+			CCharacterCore &Core = pWorld->m_aCores[i];
+			Core.Init(&pWorld->m_World, &Collision);
+			Core.Reset();
+			mem_zero(&Core.m_Input, sizeof(Core.m_Input));
+			Core.m_Pos = vec2(MAP_SIZE * 16.0f, MAP_SIZE * 16.0f) + vec2(Random.Next() - 0.5f, Random.Next() - 0.5f) * 400.0f;
+			pWorld->m_World.m_apCharacters[i] = &Core;
+		}
+		pWorld->m_Batch.Init(&pWorld->m_World);
+
+		const int64_t Start = time_get();
+		for(int Tick = 0; Tick < NUM_TICKS; Tick++)
+		{
+			// both runs draw the same inputs
+			for(CCharacterCore &Core : pWorld->m_aCores)
+			{
+				if(Random.Next() < 0.1f)
+					Core.m_Input.m_Direction = Random.Int(3) - 1;
+				Core.m_Input.m_Jump = Random.Next() < 0.08f;
+				if(Random.Next() < 0.05f)
+					Core.m_Input.m_Hook = !Core.m_Input.m_Hook;
+				if(Random.Next() < 0.1f)
+				{
+					Core.m_Input.m_TargetX = Random.Int(600) - 300;
+					Core.m_Input.m_TargetY = Random.Int(600) - 300;
+				}
+			}
+
+			if(UseBatch)
+			{
+				pWorld->m_Batch.Tick(true);
+				pWorld->m_Batch.Move();
+				continue;
+			}
+			for(CCharacterCore &Core : pWorld->m_aCores)
+				Core.Tick(true);
+			for(CCharacterCore &Core : pWorld->m_aCores)
+			{
+				Core.AddDragVelocity();
+				Core.ResetDragVelocity();
+				Core.Move();
+				Core.Quantize();
+			}
+		}
+		aTime[UseBatch] = BenchMs(Start);
+	}
+
+	CBenchmark::Report("%d characters, %d ticks: %.2fms scalar, %.2fms batch", NUM_CHARACTERS, NUM_TICKS, aTime[0], aTime[1]);
+}
@@ -0,0 +1,126 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "bench.h"
+
+#include <game/spatialgrid.h>
+#include <test/test.h>
+
+#include <vector>
+
+static const float WORLD_SIZE = 200 * 32.0f;
+static const int NUM_LAYERS = 3;
+
+struct CBenchItem : public CSpatialGridItem
+{
+	vec2 m_Pos;
+	float m_Radius;
+	int m_Layer;
+};
+
+static vec2 RandomPos(CTestRandom *pRandom)
+{
+	return vec2(pRandom->Range(-256.0f, WORLD_SIZE + 256.0f), pRandom->Range(-256.0f, WORLD_SIZE + 256.0f));
+}
+
+static bool HitsRay(const CBenchItem &Item, vec2 Pos0, vec2 Pos1, float *pClosestLen)
+{
+	vec2 IntersectPos = closest_point_on_line(Pos0, Pos1, Item.m_Pos);
+	float Len = distance(Pos0, IntersectPos);
+	if(distance(Item.m_Pos, IntersectPos) >= Item.m_Radius || Len >= *pClosestLen)
+		return false;
+	*pClosestLen = Len;
+	return true;
+}
+
+BENCHMARK(SpatialGrid, Queries)
+{
+	static const int NUM_ITEMS = 4000;
+	static const int NUM_QUERIES = 20000;
+	static const float RADIUS = 400.0f;
+
+	CTestRandom Random(1337);
+	CSpatialGrid Grid;
+	Grid.Init(WORLD_SIZE, WORLD_SIZE, NUM_LAYERS);
+	std::vector<CBenchItem> vItems(NUM_ITEMS);
+	for(int i = 0; i < NUM_ITEMS; i++)
+	{
+		CBenchItem &Item = vItems[i];
+		Item.m_Pos = RandomPos(&Random);
+		Item.m_Radius = i % 10 == 0 ? 28.0f : 14.0f;
+		Item.m_Layer = i % NUM_LAYERS;
+		Grid.Insert(&Item, Item.m_Layer, Item.m_Pos, Item.m_Radius);
+	}
+
+	std::vector<vec2> vPositions;
+	for(int i = 0; i < NUM_QUERIES * 2; i++)
+		vPositions.push_back(RandomPos(&Random));
+
+	int aFound[2] = {0, 0};
+	double aRadiusTime[2];
+	double aRayTime[2];
+	for(int UseGrid = 0; UseGrid < 2; UseGrid++)
+	{
+		int64_t Start = time_get();
+		for(int i = 0; i < NUM_QUERIES; i++)
+		{
+			const int Layer = i % NUM_LAYERS;
+			const vec2 Pos = vPositions[i];
+			if(!UseGrid)
+			{
+				for(const CBenchItem &Item : vItems)
+					aFound[0] += Item.m_Layer == Layer && distance(Item.m_Pos, Pos) < RADIUS + Item.m_Radius;
+				continue;
+			}
+			const vec2 Reach = vec2(1.0f, 1.0f) * (RADIUS + Grid.MaxRadius());
+			Grid.ForEachCell(Pos - Reach, Pos + Reach, [&](int Cell) {
+				for(CSpatialGridItem *pItem = Grid.First(Cell, Layer); pItem; pItem = pItem->NextInCell())
+				{
+					const CBenchItem *pBench = static_cast<const CBenchItem *>(pItem);
+					aFound[1] += distance(pBench->m_Pos, Pos) < RADIUS + pBench->m_Radius;
+				}
+				return true;
+			});
+		}
+		aRadiusTime[UseGrid] = BenchMs(Start);
+
+		Start = time_get();
+		for(int i = 0; i < NUM_QUERIES; i++)
+		{
+			const int Layer = i % NUM_LAYERS;
+			const vec2 Pos0 = vPositions[i];
+			const vec2 Pos1 = Pos0 + normalize(vPositions[NUM_QUERIES + i] - Pos0) * 800.0f;
+			float ClosestLen = 800.0f * 100.0f;
+			const CBenchItem *pClosest = nullptr;
+			if(!UseGrid)
+			{
+				for(const CBenchItem &Item : vItems)
+					if(Item.m_Layer == Layer && HitsRay(Item, Pos0, Pos1, &ClosestLen))
+						pClosest = &Item;
+			}
+			else
+			{
+				Grid.ForEachCellOnRay(Pos0, Pos1, Grid.MaxRadius(), [&](int Cell, float MinDistance) {
+					if(pClosest && MinDistance >= ClosestLen)
+						return false;
+					for(CSpatialGridItem *pItem = Grid.First(Cell, Layer); pItem; pItem = pItem->NextInCell())
+						if(HitsRay(*static_cast<const CBenchItem *>(pItem), Pos0, Pos1, &ClosestLen))
+							pClosest = static_cast<const CBenchItem *>(pItem);
+					return true;
+				});
+			}
+			aFound[UseGrid] += pClosest != nullptr;
+		}
+		aRayTime[UseGrid] = BenchMs(Start);
+	}
+
+	dbg_assert(aFound[0] == aFound[1], "the grid and brute force found different items");
+	CBenchmark::Report("%d items, %d queries: radius %.2fms brute force, %.2fms grid; ray %.2fms brute force, %.2fms grid",
+		NUM_ITEMS, NUM_QUERIES, aRadiusTime[0], aRadiusTime[1], aRayTime[0], aRayTime[1]);
+}
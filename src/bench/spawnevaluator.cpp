@@ -0,0 +1,55 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "bench.h"
+
+#include <test/spawntest.h>
+
+static void RunRequests(const char *pName, unsigned Seed, int NumRounds, int NumSpawnPoints, int NumCharacters, int NumBots)
+{
+	CSpawnTest Test(Seed);
+	Test.AddRandomSpawnPoints(NumSpawnPoints);
+	for(int i = 0; i < NumCharacters + NumBots; i++)
+	{
+		CSpawnEvaluator::SBlocker Blocker = Test.NewBlocker(Test.RandomPos());
+		// bot entities block spawn points but are not dangerous
+		Blocker.m_Dangerous = i < NumCharacters;
+		Blocker.m_Radius = Blocker.m_Dangerous ? 28.0f : 14.0f;
+		Blocker.m_Team = Blocker.m_Dangerous ? Test.m_Random.Int(2) : -1;
+		Test.m_vBlockers.push_back(Blocker);
+	}
+	Test.Sync();
+
+	// one sync per tick and a few spawn requests, against evaluating everything per request
+	double aTime[2];
+	int aChecksum[2] = {0, 0};
+	vec2 Pos;
+	for(int New = 0; New < 2; New++)
+	{
+		const int64_t Start = time_get();
+		for(int Round = 0; Round < NumRounds; Round++)
+		{
+			if(New)
+				Test.Sync();
+			for(int Request = 0; Request < 4; Request++)
+				for(int Type = 0; Type < CSpawnEvaluator::NUM_SPAWN_TYPES; Type++)
+					aChecksum[New] += New ? Test.NewChoice(Type, Request % 2, &Pos) : Test.OldChoice(Type, Request % 2, &Pos);
+		}
+		aTime[New] = BenchMs(Start);
+	}
+
+	dbg_assert(aChecksum[0] == aChecksum[1], "the evaluator chose different spawn points");
+	CBenchmark::Report("%s, %d rounds of 12 requests: %.2fms old, %.2fms evaluator", pName, NumRounds, aTime[0], aTime[1]);
+}
+
+BENCHMARK(SpawnEvaluator, Requests)
+{
+	RunRequests("64 characters", 7, 2000, 0, 64, 0);
+	RunRequests("16 characters and 400 bots", 8, 100, 200, 16, 400);
+}
@@ -16,6 +16,8 @@
 #include "kernel.h"
 #include "message.h"
 
+#include <vector>
+
 class IServer : public IInterface
 {
 	MACRO_INTERFACE("server", 0)
@@ -49,8 +51,31 @@ public:
 	virtual int GetCarbonClientVersion(int ClientID) const = 0;
 	virtual int GetDDNetClientVersion(int ClientID) const = 0;
 
+	/*
+		Structure: CMsgBuffer
+			Messages held back while the sending thread may not touch
+			the network, see SetThreadMsgBuffer.
+	*/
+	struct CMsgBuffer
+	{
+		struct CMsg
+		{
+			int m_Offset;
+			int m_Size;
+			int m_Flags;
+			int m_ClientID;
+		};
+		std::vector<unsigned char> m_vData;
+		std::vector<CMsg> m_vMsgs;
+	};
+
 	virtual int SendMsg(CMsgPacker *pMsg, int Flags, int ClientID) = 0;
 
+	// while a buffer is set, SendMsg on the calling thread only appends to it
+	virtual void SetThreadMsgBuffer(CMsgBuffer *pBuffer) = 0;
+	// sends the held back messages in order and empties the buffer
+	virtual void SendMsgBuffer(CMsgBuffer *pBuffer) = 0;
+
 	template<class T>
 	int SendPackMsg(T *pMsg, int Flags, int ClientID)
 	{
@@ -136,6 +161,9 @@ public:
 	virtual bool CheckWorldExists(Uuid WorldID) = 0;
 	virtual void LoadNewWorld(Uuid WorldID) = 0;
 	virtual void SwitchPlayerWorld(int ClientID, Uuid WorldID) = 0;
+
+	// hash over the simulated state of all worlds, a re-simulation compares it per tick
+	virtual unsigned WorldHash() = 0;
 };
 
 extern IGameServer *CreateGameServer();
@@ -283,6 +283,8 @@ CServer::CServer() :
 
 	m_pLocalization = nullptr;
 
+	m_NetReplayPumpTime = 0;
+
 	Init();
 }
 
@@ -514,20 +516,40 @@ void CServer::InitRconPasswordIfUnset()
 	m_GeneratedRconPassword = 1;
 }
 
+static thread_local IServer::CMsgBuffer *s_pThreadMsgBuffer = nullptr;
+
 int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID)
 {
-	CNetChunk Packet;
 	if(!pMsg)
 		return -1;
 
+	if(s_pThreadMsgBuffer)
+	{
+		CMsgBuffer::CMsg Msg;
+		Msg.m_Offset = s_pThreadMsgBuffer->m_vData.size();
+		Msg.m_Size = pMsg->Size();
+		Msg.m_Flags = Flags;
+		Msg.m_ClientID = ClientID;
+		s_pThreadMsgBuffer->m_vData.insert(s_pThreadMsgBuffer->m_vData.end(), pMsg->Data(), pMsg->Data() + pMsg->Size());
+		s_pThreadMsgBuffer->m_vMsgs.push_back(Msg);
+		return 0;
+	}
+
+	return SendMsgData(pMsg->Data(), pMsg->Size(), Flags, ClientID);
+}
+
+int CServer::SendMsgData(const void *pData, int Size, int Flags, int ClientID)
+{
+	CNetChunk Packet;
+
 	// drop invalid packet
 	if(ClientID != -1 && (ClientID < 0 || ClientID >= SERVER_MAX_CLIENTS || m_aClients[ClientID].m_State == CClient::STATE_EMPTY || m_aClients[ClientID].m_Quitting))
 		return 0;
 
 	mem_zero(&Packet, sizeof(CNetChunk));
 	Packet.m_ClientID = ClientID;
-	Packet.m_pData = pMsg->Data();
-	Packet.m_DataSize = pMsg->Size();
+	Packet.m_pData = pData;
+	Packet.m_DataSize = Size;
 
 	if(Flags & MSGFLAG_VITAL)
 		Packet.m_Flags |= NETSENDFLAG_VITAL;
@@ -536,7 +558,7 @@ int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID)
 
 	// write message to demo recorder
 	if(!(Flags & MSGFLAG_NORECORD))
-		m_DemoRecorder.RecordMessage(pMsg->Data(), pMsg->Size());
+		m_DemoRecorder.RecordMessage(pData, Size);
 
 	if(!(Flags & MSGFLAG_NOSEND))
 	{
@@ -557,8 +579,25 @@ int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID)
 	return 0;
 }
 
+void CServer::SetThreadMsgBuffer(CMsgBuffer *pBuffer)
+{
+	s_pThreadMsgBuffer = pBuffer;
+}
+
+void CServer::SendMsgBuffer(CMsgBuffer *pBuffer)
+{
+	for(const CMsgBuffer::CMsg &Msg : pBuffer->m_vMsgs)
+		SendMsgData(pBuffer->m_vData.data() + Msg.m_Offset, Msg.m_Size, Msg.m_Flags, Msg.m_ClientID);
+	pBuffer->m_vData.clear();
+	pBuffer->m_vMsgs.clear();
+}
+
 void CServer::DoSnapshot()
 {
+	// the snapping clients are recorded after the fact, the re-simulation snaps them in the same order
+	int aSnapClientIDs[SERVER_MAX_CLIENTS + 1];
+	int NumSnapClients = 0;
+
 	GameServer()->OnPreSnap();
 
 	// create snapshot for demo recording
@@ -570,6 +609,7 @@ void CServer::DoSnapshot()
 		// build snap and possibly add some messages
 		m_SnapshotBuilder.Init();
 		GameServer()->OnSnap(-1);
+		aSnapClientIDs[NumSnapClients++] = -1;
 		SnapshotSize = m_SnapshotBuilder.Finish(aData);
 
 		// write snapshot
@@ -607,6 +647,7 @@ void CServer::DoSnapshot()
 			m_SnapshotBuilder.Init();
 
 			GameServer()->OnSnap(i);
+			aSnapClientIDs[NumSnapClients++] = i;
 
 			// finish snapshot
 			SnapshotSize = m_SnapshotBuilder.Finish(pData);
@@ -693,6 +734,7 @@ void CServer::DoSnapshot()
 		}
 	}
 
+	m_SimRecorder.RecordSnap(aSnapClientIDs, NumSnapClients);
 	GameServer()->OnPostSnap();
 }
 
@@ -703,6 +745,7 @@ int CServer::NewClientCallback(int ClientID, void *pUser)
 	// Remove non human player on same slot
 	if(pThis->GameServer()->IsClientBot(ClientID))
 	{
+		pThis->m_SimRecorder.RecordDrop(ClientID, "removing dummy");
 		pThis->GameServer()->OnClientDrop(ClientID, "removing dummy");
 	}
 
@@ -741,6 +784,7 @@ int CServer::DelClientCallback(int ClientID, const char *pReason, void *pUser)
 	if(pThis->m_aClients[ClientID].m_State >= CClient::STATE_READY)
 	{
 		pThis->m_aClients[ClientID].m_Quitting = true;
+		pThis->m_SimRecorder.RecordDrop(ClientID, pReason);
 		pThis->GameServer()->OnClientDrop(ClientID, pReason);
 	}
 
@@ -776,7 +820,11 @@ void CServer::SendMap(int ClientID)
 	SendMsg(&Msg, MSGFLAG_VITAL | MSGFLAG_FLUSH, ClientID);
 
 	if(!GameServer()->CheckWorldExists(MapID))
+	{
+		m_SimRecorder.RecordLoadWorld(pData->m_aName, pData->m_ModeID);
 		GameServer()->LoadNewWorld(MapID);
+	}
+	m_SimRecorder.RecordSwitchWorld(ClientID, pData->m_aName);
 	GameServer()->SwitchPlayerWorld(ClientID, MapID);
 }
 
@@ -987,6 +1035,7 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 
 				bool ConnectAsSpec = m_aClients[ClientID].m_State == CClient::STATE_CONNECTING_AS_SPEC;
 				m_aClients[ClientID].m_State = CClient::STATE_READY;
+				m_SimRecorder.RecordConnect(ClientID, ConnectAsSpec, m_aClients[ClientID].m_Version, m_aClients[ClientID].m_CarbonVersion, m_aClients[ClientID].m_DDNetVersion);
 				GameServer()->OnClientConnected(ClientID, ConnectAsSpec);
 				SendConnectionReady(ClientID);
 			}
@@ -1003,6 +1052,7 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 				Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
 				m_aClients[ClientID].m_State = CClient::STATE_INGAME;
 				SendServerInfo(ClientID);
+				m_SimRecorder.RecordEnter(ClientID);
 				GameServer()->OnClientEnter(ClientID);
 			}
 		}
@@ -1061,7 +1111,10 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 
 			// call the mod with the fresh input data
 			if(m_aClients[ClientID].m_State == CClient::STATE_INGAME)
+			{
+				m_SimRecorder.RecordInput(SIMREC_DIRECT_INPUT, ClientID, m_aClients[ClientID].m_LatestInput.m_aData, MAX_INPUT_SIZE);
 				GameServer()->OnClientDirectInput(ClientID, m_aClients[ClientID].m_LatestInput.m_aData);
+			}
 		}
 		else if(Unpacker.Type() == NETMSG_RCON_CMD)
 		{
@@ -1169,7 +1222,10 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 	{
 		// game message
 		if((pPacket->m_Flags & NET_CHUNKFLAG_VITAL) != 0 && m_aClients[ClientID].m_State >= CClient::STATE_READY)
+		{
+			m_SimRecorder.RecordMessage(ClientID, pPacket->m_pData, pPacket->m_DataSize);
 			GameServer()->OnMessage(Unpacker.Type(), &Unpacker, ClientID);
+		}
 	}
 }
 
@@ -1337,6 +1393,67 @@ void CServer::PumpNetwork()
 	m_Econ.Update();
 }
 
+bool CServer::StartNetReplay(const char *pFilename)
+{
+	IOHANDLE File = Storage()->OpenFile(pFilename, IOFLAG_READ, IStorage::TYPE_ALL);
+	if(!m_NetReplay.Open(File, Config()->m_SvNetReplayMaxSpeed))
+	{
+		dbg_msg("server", "failed to open network capture '%s'", pFilename);
+		return false;
+	}
+
+	m_NetServer.SetReplay(&m_NetReplay);
+	m_NetReplayPumpTime = 0;
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "replaying network capture '%s' at %s speed", pFilename, Config()->m_SvNetReplayMaxSpeed ? "maximum" : "recorded");
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+	return true;
+}
+
+void CServer::PrintNetReplayStats(int64_t StartTime)
+{
+	const CNetReplay::CStats *pStats = m_NetReplay.Stats();
+	const double Duration = (time_get() - StartTime) / (double) time_freq();
+	const double PumpDuration = m_NetReplayPumpTime / (double) time_freq();
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "replay finished: recv packets=%d, recv bytes=%d; send packets=%d, send bytes=%d",
+		pStats->m_RecvPackets, pStats->m_RecvBytes, pStats->m_SentPackets, pStats->m_SentBytes);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+	str_format(aBuf, sizeof(aBuf), "replay took %.3fs (captured %.3fs), %.3fs in PumpNetwork, %.0f packets/s",
+		Duration, pStats->m_LastRecordTime / 1000000.0, PumpDuration, PumpDuration > 0.0 ? pStats->m_RecvPackets / PumpDuration : 0.0);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
+bool CServer::StartSimRecord(const char *pFilename)
+{
+	// the game server's random numbers have to start from the recorded seed
+	const unsigned Seed = (unsigned) time_get();
+	if(!m_SimRecorder.Open(Storage()->OpenFile(pFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE), Seed, Config()->m_SvMap))
+	{
+		dbg_msg("server", "failed to open simulation record '%s'", pFilename);
+		return false;
+	}
+	srand(Seed);
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "recording the simulation to '%s'", pFilename);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+	return true;
+}
+
+void CServer::StopSimRecord(const char *pReason)
+{
+	if(!m_SimRecorder.IsOpen())
+		return;
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "stopped recording the simulation (%s), %d ticks written", pReason, m_SimRecorder.NumTicks());
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+	m_SimRecorder.Close();
+}
+
 const char *CServer::GetMapName()
 {
 	// get the name of the map without his path
@@ -1373,7 +1490,10 @@ int CServer::LoadMap(const char *pMapName)
 		m_DemoRecorder.Stop();
 
 	// reinit snapshot ids
-	m_IDPool.TimeoutIDs();
+	{
+		std::lock_guard<std::mutex> Lock(m_IDPoolLock);
+		m_IDPool.TimeoutIDs();
+	}
 
 	if(m_uMapDatas.empty())
 		m_BaseMapUuid = MapUuid;
@@ -1463,6 +1583,12 @@ int CServer::Run()
 		return -1;
 	}
 
+	if(Config()->m_SvNetReplay[0] && !StartNetReplay(Config()->m_SvNetReplay))
+	{
+		Free();
+		return -1;
+	}
+
 	if(!m_Http.Init(Config()))
 	{
 		dbg_msg("server", "Failed to initialize the HTTP client.");
@@ -1475,6 +1601,12 @@ int CServer::Run()
 	str_format(aBuf, sizeof(aBuf), "server name is '%s'", Config()->m_SvName);
 	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
 
+	if(Config()->m_SvSimRecord[0] && !StartSimRecord(Config()->m_SvSimRecord))
+	{
+		Free();
+		return -1;
+	}
+
 	GameServer()->OnInit();
 	str_format(aBuf, sizeof(aBuf), "netversion %s", GameServer()->NetVersion());
 	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
@@ -1506,6 +1638,9 @@ int CServer::Run()
 			{
 				m_MapReload = false;
 
+				// a re-simulation can't follow the game server through a restart
+				StopSimRecord("map reload");
+
 				// load map
 				if(LoadMap(Config()->m_SvMap))
 				{
@@ -1548,6 +1683,7 @@ int CServer::Run()
 				NewTicks = true;
 				if((m_CurrentGameTick % 2) == 0)
 					ShouldSnap = true;
+				m_SimRecorder.RecordTick(m_CurrentGameTick);
 
 				// apply new input
 				for(int c = 0; c < SERVER_MAX_CLIENTS; c++)
@@ -1566,13 +1702,18 @@ int CServer::Run()
 						if(m_aClients[c].m_aInputs[i].m_GameTick == Tick())
 						{
 							if(m_aClients[c].m_State == CClient::STATE_INGAME)
+							{
+								m_SimRecorder.RecordInput(SIMREC_PREDICTED_INPUT, c, m_aClients[c].m_aInputs[i].m_aData, MAX_INPUT_SIZE);
 								GameServer()->OnClientPredictedInput(c, m_aClients[c].m_aInputs[i].m_aData);
+							}
 							break;
 						}
 					}
 				}
 
 				GameServer()->OnTick();
+				if(m_SimRecorder.IsOpen())
+					m_SimRecorder.RecordTickEnd(GameServer()->WorldHash());
 			}
 
 			// snap game
@@ -1588,7 +1729,24 @@ int CServer::Run()
 			// master server stuff
 			m_Register.RegisterUpdate(m_NetServer.NetType());
 
-			PumpNetwork();
+			if(m_NetServer.IsReplaying())
+			{
+				int64_t PumpStart = time_get();
+				m_NetReplay.BeginPump();
+				PumpNetwork();
+				m_NetReplayPumpTime += time_get() - PumpStart;
+
+				if(m_NetReplay.Done())
+				{
+					PrintNetReplayStats(m_GameStartTime);
+					break;
+				}
+			}
+			else
+				PumpNetwork();
+
+			// send everything flushed by the snapshots and the packet handling
+			m_NetServer.FlushPending();
 
 			// wait for incoming data
 			m_NetServer.Wait(clamp(int((TickStartTime(m_CurrentGameTick + 1) - time_get()) * 1000 / time_freq()), 1, 1000 / SERVER_TICK_SPEED / 2));
@@ -1601,7 +1759,11 @@ int CServer::Run()
 		}
 	}
 	// disconnect all clients on shutdown
+	m_NetServer.FlushPending();
 	m_NetServer.Close(m_aShutdownReason);
+	m_NetCapture.Close();
+	m_NetReplay.Close();
+	StopSimRecord("shutdown");
 	m_Econ.Shutdown();
 	m_Http.Shutdown();
 
@@ -1882,9 +2044,94 @@ void CServer::ConchainRconPasswordSet(IConsole::IResult *pResult, void *pUserDat
 	}
 }
 
+void CServer::PrintConnStats(int ClientID, bool Detailed)
+{
+	const CNetConnStats *pStats = m_NetServer.ClientConnStats(ClientID);
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "id=%d rtt=%d/%d/%d/%dms (last/min/avg/max) latency=%dms resends=%d/%d (%.1f%%) requests=%d buffer=%d/%d peak=%d recv=%d ooo=%d dup=%d (%.1f%%)",
+		ClientID, pStats->m_RttLast, pStats->m_RttMin, pStats->RttAverage(), pStats->m_RttMax, m_aClients[ClientID].m_Latency,
+		pStats->m_NumResends, pStats->m_NumVitalSent, pStats->SendLoss() * 100.0f, pStats->m_NumResendRequests,
+		pStats->m_BufferUsage, Config()->m_NetResendQuota * 1024, pStats->m_BufferPeak,
+		pStats->m_NumVitalRecv, pStats->m_NumOutOfOrder, pStats->m_NumDuplicates, pStats->RecvLoss() * 100.0f);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+
+	if(!Detailed)
+		return;
+
+	for(int i = 0; i < CNetConnStats::NUM_RTT_BUCKETS; i++)
+	{
+		int Limit = CNetConnStats::RttBucketLimit(i);
+		if(Limit < 0)
+			str_format(aBuf, sizeof(aBuf), "  rtt >=%dms: %d", CNetConnStats::RttBucketLimit(i - 1), pStats->m_aRttHistogram[i]);
+		else
+			str_format(aBuf, sizeof(aBuf), "  rtt <%dms: %d", Limit, pStats->m_aRttHistogram[i]);
+		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+	}
+}
+
+void CServer::WriteConnStatsJson(CJsonWriter *pWriter, int ClientID)
+{
+	const CNetConnStats *pStats = m_NetServer.ClientConnStats(ClientID);
+
+	pWriter->BeginObject();
+	pWriter->WriteAttribute("id");
+	pWriter->WriteIntValue(ClientID);
+	pWriter->WriteAttribute("latency");
+	pWriter->WriteIntValue(m_aClients[ClientID].m_Latency);
+
+	pWriter->WriteAttribute("rtt");
+	pWriter->BeginObject();
+	pWriter->WriteAttribute("last");
+	pWriter->WriteIntValue(pStats->m_RttLast);
+	pWriter->WriteAttribute("min");
+	pWriter->WriteIntValue(pStats->m_RttMin);
+	pWriter->WriteAttribute("avg");
+	pWriter->WriteIntValue(pStats->RttAverage());
+	pWriter->WriteAttribute("max");
+	pWriter->WriteIntValue(pStats->m_RttMax);
+	pWriter->WriteAttribute("histogram");
+	pWriter->BeginArray();
+	for(int i = 0; i < CNetConnStats::NUM_RTT_BUCKETS; i++)
+		pWriter->WriteIntValue(pStats->m_aRttHistogram[i]);
+	pWriter->EndArray();
+	pWriter->EndObject();
+
+	pWriter->WriteAttribute("vital_sent");
+	pWriter->WriteIntValue(pStats->m_NumVitalSent);
+	pWriter->WriteAttribute("resends");
+	pWriter->WriteIntValue(pStats->m_NumResends);
+	pWriter->WriteAttribute("resend_requests");
+	pWriter->WriteIntValue(pStats->m_NumResendRequests);
+	pWriter->WriteAttribute("buffer_usage");
+	pWriter->WriteIntValue(pStats->m_BufferUsage);
+	pWriter->WriteAttribute("buffer_peak");
+	pWriter->WriteIntValue(pStats->m_BufferPeak);
+	pWriter->WriteAttribute("vital_recv");
+	pWriter->WriteIntValue(pStats->m_NumVitalRecv);
+	pWriter->WriteAttribute("out_of_order");
+	pWriter->WriteIntValue(pStats->m_NumOutOfOrder);
+	pWriter->WriteAttribute("duplicates");
+	pWriter->WriteIntValue(pStats->m_NumDuplicates);
+	pWriter->EndObject();
+}
+
 void CServer::ConNetworkStats(IConsole::IResult *pResult, void *pUser)
 {
 	CServer *pServer = (CServer *) pUser;
+
+	if(pResult->NumArguments())
+	{
+		int ClientID = pResult->GetInteger(0);
+		if(ClientID < 0 || ClientID >= SERVER_MAX_CLIENTS || pServer->m_aClients[ClientID].m_State == CClient::STATE_EMPTY)
+		{
+			pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", "invalid client id");
+			return;
+		}
+		pServer->PrintConnStats(ClientID, true);
+		return;
+	}
+
 	NETSTATS Stats;
 	net_stats(&Stats);
 
@@ -1892,6 +2139,118 @@ void CServer::ConNetworkStats(IConsole::IResult *pResult, void *pUser)
 	str_format(aBuf, sizeof(aBuf), "send packets=%d, send bytes=%d;recv packets=%d, recv bytes=%d",
 		Stats.sent_packets, Stats.sent_bytes, Stats.recv_packets, Stats.recv_bytes);
 	pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+
+	// packing of connection packets since the last call
+	const CNetBase::CPacketStats *pPacketStats = pServer->m_NetServer.PacketStats();
+	const double Duration = (time_get() - pPacketStats->m_StartTime) / (double) time_freq();
+	const double Fill = pPacketStats->m_NumPackets ? pPacketStats->m_NumPayloadBytes / (double) (pPacketStats->m_NumPackets * (int64_t) NET_MAX_PAYLOAD) : 0.0;
+	str_format(aBuf, sizeof(aBuf), "connection packets=%d (%.1f/s), average fill=%.1f%%, coalescing=%s",
+		pPacketStats->m_NumPackets, Duration > 0.0 ? pPacketStats->m_NumPackets / Duration : 0.0, Fill * 100.0, pServer->Config()->m_SvNetCoalesce ? "on" : "off");
+	pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+	pServer->m_NetServer.ResetPacketStats();
+
+	const CNetResendPool::CStats *pPoolStats = pServer->m_NetServer.ResendPool()->Stats();
+	str_format(aBuf, sizeof(aBuf), "resend pool slabs=%d (peak %d, %d KiB each), chunks=%d, bytes in use=%d",
+		pPoolStats->m_NumSlabs, pPoolStats->m_NumSlabsPeak, (int) CNetResendPool::SLAB_SIZE / 1024, pPoolStats->m_NumBlocks, pPoolStats->m_BytesInUse);
+	pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+
+	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+	{
+		if(pServer->m_aClients[i].m_State != CClient::STATE_EMPTY)
+			pServer->PrintConnStats(i, false);
+	}
+}
+
+void CServer::ConNetworkStatsJson(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pServer = (CServer *) pUser;
+	char aFilename[128];
+	if(pResult->NumArguments())
+		str_format(aFilename, sizeof(aFilename), "dumps/%s.json", pResult->GetString(0));
+	else
+	{
+		char aDate[20];
+		str_timestamp(aDate, sizeof(aDate));
+		str_format(aFilename, sizeof(aFilename), "dumps/network_stats_%s.json", aDate);
+	}
+
+	IOHANDLE File = pServer->Storage()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+	{
+		char aBuf[256];
+		str_format(aBuf, sizeof(aBuf), "failed to open '%s' for writing", aFilename);
+		pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+		return;
+	}
+
+	NETSTATS Stats;
+	net_stats(&Stats);
+
+	CJsonFileWriter Writer(File);
+	Writer.BeginObject();
+	Writer.WriteAttribute("tick");
+	Writer.WriteIntValue(pServer->Tick());
+	Writer.WriteAttribute("sent_packets");
+	Writer.WriteIntValue(Stats.sent_packets);
+	Writer.WriteAttribute("sent_bytes");
+	Writer.WriteIntValue(Stats.sent_bytes);
+	Writer.WriteAttribute("recv_packets");
+	Writer.WriteIntValue(Stats.recv_packets);
+	Writer.WriteAttribute("recv_bytes");
+	Writer.WriteIntValue(Stats.recv_bytes);
+	Writer.WriteAttribute("clients");
+	Writer.BeginArray();
+	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+	{
+		if(pServer->m_aClients[i].m_State != CClient::STATE_EMPTY)
+			pServer->WriteConnStatsJson(&Writer, i);
+	}
+	Writer.EndArray();
+	Writer.EndObject();
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "wrote network stats to '%s'", aFilename);
+	pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+}
+
+void CServer::ConNetCapture(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pServer = (CServer *) pUser;
+	char aFilename[128];
+	if(pResult->NumArguments())
+		str_format(aFilename, sizeof(aFilename), "dumps/%s.netcap", pResult->GetString(0));
+	else
+	{
+		char aDate[20];
+		str_timestamp(aDate, sizeof(aDate));
+		str_format(aFilename, sizeof(aFilename), "dumps/netcapture_%s.netcap", aDate);
+	}
+
+	char aBuf[256];
+	if(pServer->m_NetCapture.Open(pServer->Storage()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE)))
+	{
+		pServer->m_NetServer.SetCapture(&pServer->m_NetCapture);
+		str_format(aBuf, sizeof(aBuf), "capturing network traffic to '%s'", aFilename);
+	}
+	else
+	{
+		pServer->m_NetServer.SetCapture(0);
+		str_format(aBuf, sizeof(aBuf), "failed to open '%s' for capturing", aFilename);
+	}
+	pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
+}
+
+void CServer::ConNetCaptureStop(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pServer = (CServer *) pUser;
+	if(!pServer->m_NetCapture.IsOpen())
+		return;
+
+	char aBuf[128];
+	str_format(aBuf, sizeof(aBuf), "stopped capturing, %d datagrams written", pServer->m_NetCapture.NumRecords());
+	pServer->m_NetServer.SetCapture(0);
+	pServer->m_NetCapture.Close();
+	pServer->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "network", aBuf);
 }
 
 void CServer::RegisterCommands()
@@ -1917,7 +2276,10 @@ void CServer::RegisterCommands()
 	Console()->Chain("console_output_level", ConchainConsoleOutputLevelUpdate, this);
 	Console()->Chain("sv_rcon_password", ConchainRconPasswordSet, this);
 
-	Console()->Register("network_stats", "", CFGFLAG_SERVER, ConNetworkStats, this, "Print network stats");
+	Console()->Register("network_stats", "?i[id]", CFGFLAG_SERVER, ConNetworkStats, this, "Print network stats, or the link stats of a single client");
+	Console()->Register("network_stats_json", "?s[file]", CFGFLAG_SERVER, ConNetworkStatsJson, this, "Write the network and link stats of all clients to a json file");
+	Console()->Register("net_capture", "?s[file]", CFGFLAG_SERVER, ConNetCapture, this, "Capture the raw network traffic to a file");
+	Console()->Register("net_capture_stop", "", CFGFLAG_SERVER, ConNetCaptureStop, this, "Stop capturing the network traffic");
 
 	// register console commands in sub parts
 	m_ServerBan.InitServerBan(Console(), Storage(), this);
@@ -1927,11 +2289,13 @@ void CServer::RegisterCommands()
 
 int CServer::SnapNewID()
 {
+	std::lock_guard<std::mutex> Lock(m_IDPoolLock);
 	return m_IDPool.NewID();
 }
 
 void CServer::SnapFreeID(int ID)
 {
+	std::lock_guard<std::mutex> Lock(m_IDPoolLock);
 	m_IDPool.FreeID(ID);
 }
 
@@ -17,6 +17,10 @@
 #include <engine/server.h>
 #include <engine/shared/http.h>
 #include <engine/shared/memheap.h>
+#include <engine/shared/netcapture.h>
+#include <engine/shared/simrecord.h>
+
+#include <mutex>
 
 class CSnapIDPool
 {
@@ -166,11 +170,18 @@ public:
 	CSnapshotDelta m_SnapshotDelta;
 	CSnapshotBuilder m_SnapshotBuilder;
 	CSnapIDPool m_IDPool;
+	std::mutex m_IDPoolLock; // entities of parallel ticked worlds take ids concurrently
 	CNetServer m_NetServer;
 	CEcon m_Econ;
 	CServerBan m_ServerBan;
 	CHttp m_Http;
 
+	CNetCaptureWriter m_NetCapture;
+	CNetReplay m_NetReplay;
+	int64_t m_NetReplayPumpTime;
+
+	CSimRecorder m_SimRecorder;
+
 	IEngineMap *m_pMap;
 	IMapChecker *m_pMapChecker;
 	class ILocalization *m_pLocalization;
@@ -266,6 +277,9 @@ public:
 	Uuid GetClientMapID(int ClientID) const override;
 
 	int SendMsg(CMsgPacker *pMsg, int Flags, int ClientID) override;
+	int SendMsgData(const void *pData, int Size, int Flags, int ClientID);
+	void SetThreadMsgBuffer(CMsgBuffer *pBuffer) override;
+	void SendMsgBuffer(CMsgBuffer *pBuffer) override;
 
 	void DoSnapshot();
 
@@ -293,6 +307,12 @@ public:
 
 	void PumpNetwork();
 
+	bool StartNetReplay(const char *pFilename);
+	void PrintNetReplayStats(int64_t StartTime);
+
+	bool StartSimRecord(const char *pFilename);
+	void StopSimRecord(const char *pReason);
+
 	const char *GetMapName();
 	int LoadMap(const char *pMapName);
 
@@ -319,7 +339,13 @@ public:
 	static void ConchainConsoleOutputLevelUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainRconPasswordSet(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 
+	void PrintConnStats(int ClientID, bool Detailed);
+	void WriteConnStatsJson(class CJsonWriter *pWriter, int ClientID);
+
 	static void ConNetworkStats(IConsole::IResult *pResult, void *pUser);
+	static void ConNetworkStatsJson(IConsole::IResult *pResult, void *pUser);
+	static void ConNetCapture(IConsole::IResult *pResult, void *pUser);
+	static void ConNetCaptureStop(IConsole::IResult *pResult, void *pUser);
 
 	void RegisterCommands();
 
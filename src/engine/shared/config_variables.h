@@ -99,6 +99,7 @@ MACRO_CONFIG_INT(SvMaxClients, sv_max_clients, SERVER_MAX_CLIENTS, 1, SERVER_MAX
 MACRO_CONFIG_INT(SvMaxClientsPerIP, sv_max_clients_per_ip, 4, 1, SERVER_MAX_CLIENTS, CFGFLAG_SAVE | CFGFLAG_SERVER, "Maximum number of clients with the same IP that can connect to the server")
 MACRO_CONFIG_INT(SvMapDownloadSpeed, sv_map_download_speed, 8, 1, 16, CFGFLAG_SAVE | CFGFLAG_SERVER, "Number of map data packages a client gets on each request")
 MACRO_CONFIG_INT(SvHighBandwidth, sv_high_bandwidth, 0, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Use high bandwidth mode. Doubles the bandwidth required for the server. LAN use only")
+MACRO_CONFIG_INT(SvNetCoalesce, sv_net_coalesce, 1, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Pack all non-vital messages flushed during a tick into as few packets as possible instead of sending one packet per flush")
 MACRO_CONFIG_INT(SvRegister, sv_register, 1, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Register server with master server for public listing")
 MACRO_CONFIG_STR(SvRconPassword, sv_rcon_password, 32, "", CFGFLAG_SAVE | CFGFLAG_SERVER, "Remote console password (full access)")
 MACRO_CONFIG_STR(SvRconModPassword, sv_rcon_mod_password, 32, "", CFGFLAG_SAVE | CFGFLAG_SERVER, "Remote console password for moderators (limited access)")
@@ -108,6 +109,9 @@ MACRO_CONFIG_INT(SvAutoDemoRecord, sv_auto_demo_record, 0, 0, 1, CFGFLAG_SAVE |
 MACRO_CONFIG_INT(SvAutoDemoMax, sv_auto_demo_max, 10, 0, 1000, CFGFLAG_SAVE | CFGFLAG_SERVER, "Maximum number of automatically recorded demos (0 = no limit)")
 
 MACRO_CONFIG_STR(SvDefaultLanguage, sv_default_language, 8, "en", CFGFLAG_SAVE | CFGFLAG_SERVER, "Server default language")
+MACRO_CONFIG_STR(SvNetReplay, sv_net_replay, 128, "", CFGFLAG_SERVER, "Network capture to replay instead of reading from the socket")
+MACRO_CONFIG_INT(SvNetReplayMaxSpeed, sv_net_replay_max_speed, 0, 0, 1, CFGFLAG_SERVER, "Replay the network capture as fast as possible instead of at the recorded speed")
+MACRO_CONFIG_STR(SvSimRecord, sv_sim_record, 128, "", CFGFLAG_SERVER, "Record everything the game server gets from the engine to this file, for re-simulation with world_bench -r")
 
 MACRO_CONFIG_STR(EcBindaddr, ec_bindaddr, 128, "localhost", CFGFLAG_SAVE | CFGFLAG_ECON, "Address to bind the external console to. Anything but 'localhost' is dangerous")
 MACRO_CONFIG_INT(EcPort, ec_port, 0, 0, 0, CFGFLAG_SAVE | CFGFLAG_ECON, "Port to use for the external console")
@@ -117,6 +121,7 @@ MACRO_CONFIG_INT(EcAuthTimeout, ec_auth_timeout, 30, 1, 120, CFGFLAG_SAVE | CFGF
 MACRO_CONFIG_INT(EcOutputLevel, ec_output_level, 1, 0, 2, CFGFLAG_SAVE | CFGFLAG_ECON, "Adjusts the amount of information in the external console")
 
 MACRO_CONFIG_INT(NetTcpAbortOnClose, net_tcp_abort_on_close, 0, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER | CFGFLAG_ECON, "Aborts tcp connection on close")
+MACRO_CONFIG_INT(NetResendQuota, net_resend_quota, 128, 32, 4096, CFGFLAG_SAVE | CFGFLAG_CLIENT | CFGFLAG_SERVER, "Maximum size in KiB of the unacknowledged data a connection may buffer for resending")
 
 MACRO_CONFIG_INT(Debug, debug, 0, 0, 1, CFGFLAG_CLIENT | CFGFLAG_SERVER, "Debug mode")
 MACRO_CONFIG_INT(DbgPref, dbg_pref, 0, 0, 1, CFGFLAG_SERVER, "Performance outputs")
@@ -322,6 +322,38 @@ void CConsole::Print(int Level, const char *pFrom, const char *pStr, bool Highli
 	}
 }
 
+const char *CConsole::FindCommandEnd(const char *pStr, const char **ppNextPart)
+{
+	const char *pEnd = pStr;
+	int InString = 0;
+	*ppNextPart = 0;
+
+	while(*pEnd)
+	{
+		if(*pEnd == '"')
+			InString ^= 1;
+		else if(*pEnd == '\\') // escape sequences
+		{
+			if(pEnd[1] == '"')
+				pEnd++;
+		}
+		else if(!InString)
+		{
+			if(*pEnd == ';') // command separator
+			{
+				*ppNextPart = pEnd + 1;
+				break;
+			}
+			else if(*pEnd == '#') // comment, no need to do anything more
+				break;
+		}
+
+		pEnd++;
+	}
+
+	return pEnd;
+}
+
 bool CConsole::LineIsValid(const char *pStr)
 {
 	if(!pStr)
@@ -334,32 +366,8 @@ bool CConsole::LineIsValid(const char *pStr)
 	do
 	{
 		CResult Result;
-		const char *pEnd = pStr;
-		const char *pNextPart = 0;
-		int InString = 0;
-
-		while(*pEnd)
-		{
-			if(*pEnd == '"')
-				InString ^= 1;
-			else if(*pEnd == '\\') // escape sequences
-			{
-				if(pEnd[1] == '"')
-					pEnd++;
-			}
-			else if(!InString)
-			{
-				if(*pEnd == ';') // command separator
-				{
-					pNextPart = pEnd + 1;
-					break;
-				}
-				else if(*pEnd == '#') // comment, no need to do anything more
-					break;
-			}
-
-			pEnd++;
-		}
+		const char *pNextPart;
+		const char *pEnd = FindCommandEnd(pStr, &pNextPart);
 
 		if(ParseStart(&Result, pStr, (pEnd - pStr) + 1) != 0)
 			return false;
@@ -379,32 +387,8 @@ void CConsole::ExecuteLineStroked(int Stroke, const char *pStr)
 	while(pStr && *pStr)
 	{
 		CResult Result;
-		const char *pEnd = pStr;
-		const char *pNextPart = 0;
-		int InString = 0;
-
-		while(*pEnd)
-		{
-			if(*pEnd == '"')
-				InString ^= 1;
-			else if(*pEnd == '\\') // escape sequences
-			{
-				if(pEnd[1] == '"')
-					pEnd++;
-			}
-			else if(!InString)
-			{
-				if(*pEnd == ';') // command separator
-				{
-					pNextPart = pEnd + 1;
-					break;
-				}
-				else if(*pEnd == '#') // comment, no need to do anything more
-					break;
-			}
-
-			pEnd++;
-		}
+		const char *pNextPart;
+		const char *pEnd = FindCommandEnd(pStr, &pNextPart);
 
 		if(ParseStart(&Result, pStr, (pEnd - pStr) + 1) != 0)
 			return;
@@ -490,9 +474,171 @@ int CConsole::PossibleMaps(const char *pStr, FPossibleCallback pfnCallback, void
 	return Index;
 }
 
+void CConsole::CParsedCommand::Restore(CResult *pResult) const
+{
+	mem_copy(pResult->m_aStringStorage, m_vStorage.data(), m_vStorage.size());
+	pResult->m_pCommand = pResult->m_aStringStorage + m_CommandOffset;
+	pResult->m_pArgsStart = pResult->m_aStringStorage + m_ArgsOffset;
+	for(int Offset : m_vArgOffsets)
+		pResult->AddArgument(pResult->m_aStringStorage + Offset);
+}
+
+std::shared_ptr<const CConsole::CParsedLine> CConsole::ParseLine(const char *pStr)
+{
+	std::shared_ptr<CParsedLine> pLine = std::make_shared<CParsedLine>();
+	pLine->m_Version = m_CommandsVersion;
+	pLine->m_FlagMask = m_FlagMask;
+
+	const char *pLineStart = pStr;
+	while(pStr && *pStr)
+	{
+		CResult Result;
+		const char *pNextPart;
+		const char *pEnd = FindCommandEnd(pStr, &pNextPart);
+
+		if(ParseStart(&Result, pStr, (pEnd - pStr) + 1) != 0)
+			break;
+
+		if(!*Result.m_pCommand)
+			break;
+
+		// stroke commands get their direction as an extra argument, leave them to the regular path
+		if(Result.m_pCommand[0] == '+')
+			return nullptr;
+
+		CParsedCommand Command;
+		Command.m_pCommand = FindCommand(Result.m_pCommand, m_FlagMask);
+		Command.m_ArgsValid = Command.m_pCommand && !ParseArgs(&Result, Command.m_pCommand->m_pParams);
+		Command.m_Offset = pStr - pLineStart;
+		Command.m_CommandOffset = Result.m_pCommand - Result.m_aStringStorage;
+		Command.m_ArgsOffset = Result.m_pArgsStart - Result.m_aStringStorage;
+		if(Command.m_ArgsValid)
+		{
+			for(int i = 0; i < Result.NumArguments(); i++)
+				Command.m_vArgOffsets.push_back(Result.m_apArgs[i] - Result.m_aStringStorage);
+		}
+		const int StorageSize = minimum((int) (pEnd - pStr) + 1, (int) sizeof(Result.m_aStringStorage));
+		Command.m_vStorage.assign(Result.m_aStringStorage, Result.m_aStringStorage + StorageSize);
+		pLine->m_vCommands.push_back(std::move(Command));
+
+		pStr = pNextPart;
+	}
+
+	return pLine;
+}
+
+bool CConsole::ExecuteParsedLine(const char *pStr)
+{
+	if(!m_UseParsedLines || !pStr || str_length(pStr) > CONSOLE_MAX_STR_LENGTH)
+		return false;
+
+	std::shared_ptr<const CParsedLine> pLine;
+	auto Entry = m_ParsedLines.find(pStr);
+	if(Entry != m_ParsedLines.end() && Entry->second->m_Version == m_CommandsVersion && Entry->second->m_FlagMask == m_FlagMask)
+		pLine = Entry->second;
+	else
+	{
+		pLine = ParseLine(pStr);
+		if(!pLine)
+			return false;
+
+		if(Entry != m_ParsedLines.end())
+			Entry->second = pLine;
+		else
+		{
+			if((int) m_ParsedLines.size() >= MAX_PARSED_LINES)
+				m_ParsedLines.clear();
+			m_ParsedLines.emplace(pStr, pLine);
+		}
+	}
+
+	// pLine keeps the commands alive even if a callback drops the cache
+	for(const CParsedCommand &Command : pLine->m_vCommands)
+	{
+		if(pLine->m_Version != m_CommandsVersion)
+		{
+			// an earlier command changed the registered commands, parse the rest again
+			ExecuteLineStroked(1, pStr + Command.m_Offset);
+			ExecuteLineStroked(0, pStr + Command.m_Offset);
+			break;
+		}
+
+		CResult Result;
+		Command.Restore(&Result);
+		CCommand *pCommand = Command.m_pCommand;
+
+		char aBuf[256];
+		if(!pCommand)
+		{
+			str_format(aBuf, sizeof(aBuf), "No such command: %s.", Result.m_pCommand);
+			Print(OUTPUT_LEVEL_STANDARD, "console", aBuf);
+		}
+		else if(pCommand->GetAccessLevel() < m_AccessLevel)
+		{
+			str_format(aBuf, sizeof(aBuf), "Access for command %s denied.", Result.m_pCommand);
+			Print(OUTPUT_LEVEL_STANDARD, "console", aBuf);
+		}
+		else if(!Command.m_ArgsValid)
+		{
+			str_format(aBuf, sizeof(aBuf), "Invalid arguments... Usage: %s %s", pCommand->m_pName, pCommand->m_pParams);
+			Print(OUTPUT_LEVEL_STANDARD, "console", aBuf);
+		}
+		else if(m_StoreCommands && pCommand->m_Flags & CFGFLAG_STORE)
+		{
+			m_ExecutionQueue.AddEntry();
+			m_ExecutionQueue.m_pLast->m_pCommand = pCommand;
+			m_ExecutionQueue.m_pLast->m_Result = Result;
+		}
+		else
+			pCommand->m_pfnCallback(&Result, pCommand->m_pUserData);
+	}
+
+	return true;
+}
+
+void CConsole::SetParsedLineCache(bool Enable)
+{
+	m_UseParsedLines = Enable;
+	if(!Enable)
+		m_ParsedLines.clear();
+}
+
+unsigned CConsole::CommandHash(const char *pName)
+{
+	// fnv-1a over the name folded to lower case, the same folding str_comp_nocase does
+	unsigned Hash = 2166136261u;
+	for(; *pName; pName++)
+	{
+		unsigned char c = *pName;
+		if(c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		Hash = (Hash ^ c) * 16777619u;
+	}
+	return Hash % COMMAND_HASH_SIZE;
+}
+
+void CConsole::AddCommandHash(CCommand *pCommand)
+{
+	unsigned Hash = CommandHash(pCommand->m_pName);
+	pCommand->m_pHashNext = m_apCommandHash[Hash];
+	m_apCommandHash[Hash] = pCommand;
+}
+
+void CConsole::RemoveCommandHash(CCommand *pCommand)
+{
+	for(CCommand **ppEntry = &m_apCommandHash[CommandHash(pCommand->m_pName)]; *ppEntry; ppEntry = &(*ppEntry)->m_pHashNext)
+	{
+		if(*ppEntry == pCommand)
+		{
+			*ppEntry = pCommand->m_pHashNext;
+			break;
+		}
+	}
+}
+
 CConsole::CCommand *CConsole::FindCommand(const char *pName, int FlagMask)
 {
-	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->m_pNext)
+	for(CCommand *pCommand = m_apCommandHash[CommandHash(pName)]; pCommand; pCommand = pCommand->m_pHashNext)
 	{
 		if(pCommand->m_Flags & FlagMask && str_comp_nocase(pCommand->m_pName, pName) == 0)
 		{
@@ -505,6 +651,9 @@ CConsole::CCommand *CConsole::FindCommand(const char *pName, int FlagMask)
 
 void CConsole::ExecuteLine(const char *pStr)
 {
+	if(ExecuteParsedLine(pStr))
+		return;
+
 	CConsole::ExecuteLineStroked(1, pStr); // press it
 	CConsole::ExecuteLineStroked(0, pStr); // then release it
 }
@@ -851,6 +1000,9 @@ CConsole::CConsole(int FlagMask)
 	m_pLastMapEntry = 0;
 	m_ExecutionQueue.Reset();
 	m_pFirstCommand = 0;
+	mem_zero(m_apCommandHash, sizeof(m_apCommandHash));
+	m_CommandsVersion = 0;
+	m_UseParsedLines = true;
 	m_pFirstExec = 0;
 	mem_zero(m_aPrintCB, sizeof(m_aPrintCB));
 	m_NumPrintCB = 0;
@@ -958,6 +1110,9 @@ void CConsole::ParseArguments(int NumArgs, const char **ppArguments)
 
 void CConsole::AddCommandSorted(CCommand *pCommand)
 {
+	AddCommandHash(pCommand);
+	m_CommandsVersion++;
+
 	if(!m_pFirstCommand || str_comp(pCommand->m_pName, m_pFirstCommand->m_pName) <= 0)
 	{
 		if(m_pFirstCommand && m_pFirstCommand->m_pNext)
@@ -1003,6 +1158,8 @@ void CConsole::Register(const char *pName, const char *pParams,
 
 	if(DoAdd)
 		AddCommandSorted(pCommand);
+	else
+		m_CommandsVersion++;
 }
 
 void CConsole::RegisterTemp(const char *pName, const char *pParams, int Flags, const char *pHelp)
@@ -1066,6 +1223,8 @@ void CConsole::DeregisterTemp(const char *pName)
 	// add to recycle list
 	if(pRemoved)
 	{
+		RemoveCommandHash(pRemoved);
+		m_CommandsVersion++;
 		pRemoved->m_pNext = m_pRecycleList;
 		m_pRecycleList = pRemoved;
 	}
@@ -1089,6 +1248,19 @@ void CConsole::DeregisterTempAll()
 		}
 	}
 
+	for(int i = 0; i < COMMAND_HASH_SIZE; i++)
+	{
+		CCommand **ppEntry = &m_apCommandHash[i];
+		while(*ppEntry)
+		{
+			if((*ppEntry)->m_Temp)
+				*ppEntry = (*ppEntry)->m_pHashNext;
+			else
+				ppEntry = &(*ppEntry)->m_pHashNext;
+		}
+	}
+	m_CommandsVersion++;
+
 	m_TempCommands.Reset();
 	m_pRecycleList = 0;
 }
@@ -1192,7 +1364,7 @@ void CConsole::StoreCommands(bool Store)
 
 const IConsole::CCommandInfo *CConsole::GetCommandInfo(const char *pName, int FlagMask, bool Temp)
 {
-	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->m_pNext)
+	for(CCommand *pCommand = m_apCommandHash[CommandHash(pName)]; pCommand; pCommand = pCommand->m_pHashNext)
 	{
 		if(pCommand->m_Flags & FlagMask && pCommand->m_Temp == Temp)
 		{
@@ -13,7 +13,11 @@
 
 #include <engine/console.h>
 #include "memheap.h"
+#include <memory>
 #include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class CConsole : public IConsole
 {
@@ -23,6 +27,7 @@ class CConsole : public IConsole
 		CCommand(bool BasicAccess) :
 			CCommandInfo(BasicAccess) {}
 		CCommand *m_pNext;
+		CCommand *m_pHashNext;
 		int m_Flags;
 		bool m_Temp;
 		FCommandCallback m_pfnCallback;
@@ -47,6 +52,15 @@ class CConsole : public IConsole
 	const char *m_apStrokeStr[2];
 	CCommand *m_pFirstCommand;
 
+	enum
+	{
+		COMMAND_HASH_SIZE = 512,
+	};
+	// case insensitive index over the command list, newest registration first
+	CCommand *m_apCommandHash[COMMAND_HASH_SIZE];
+	// bumped whenever a command is added, removed or changes its parameters
+	int m_CommandsVersion;
+
 	class CExecFile
 	{
 	public:
@@ -112,6 +126,40 @@ class CConsole : public IConsole
 	int ParseStart(CResult *pResult, const char *pString, int Length);
 	int ParseArgs(CResult *pResult, const char *pFormat);
 
+	// one command of a line, as left behind by ParseStart and ParseArgs
+	class CParsedCommand
+	{
+	public:
+		CCommand *m_pCommand; // 0 if there is no such command
+		bool m_ArgsValid;
+		int m_Offset; // where the command starts in the line
+		int m_CommandOffset;
+		int m_ArgsOffset;
+		std::vector<int> m_vArgOffsets;
+		std::vector<char> m_vStorage;
+
+		void Restore(CResult *pResult) const;
+	};
+
+	class CParsedLine
+	{
+	public:
+		int m_Version;
+		int m_FlagMask;
+		std::vector<CParsedCommand> m_vCommands;
+	};
+
+	enum
+	{
+		MAX_PARSED_LINES = 1024,
+	};
+	std::unordered_map<std::string, std::shared_ptr<const CParsedLine>> m_ParsedLines;
+	bool m_UseParsedLines;
+
+	static const char *FindCommandEnd(const char *pStr, const char **ppNextPart);
+	std::shared_ptr<const CParsedLine> ParseLine(const char *pStr);
+	bool ExecuteParsedLine(const char *pStr);
+
 	/*
 	This function will set pFormat to the next parameter (i,s,r,v,?) it contains and
 	pNext to the command.
@@ -151,7 +199,10 @@ class CConsole : public IConsole
 		}
 	} m_ExecutionQueue;
 
+	static unsigned CommandHash(const char *pName);
 	void AddCommandSorted(CCommand *pCommand);
+	void AddCommandHash(CCommand *pCommand);
+	void RemoveCommandHash(CCommand *pCommand);
 	CCommand *FindCommand(const char *pName, int FlagMask);
 
 	struct CMapListEntryTemp
@@ -199,6 +250,10 @@ public:
 	int ParseCommandArgs(const char *pArgs, const char *pFormat, FCommandCallback pfnCallback, void *pContext) override;
 
 	void SetAccessLevel(int AccessLevel) override { m_AccessLevel = clamp(AccessLevel, (int) (ACCESS_LEVEL_ADMIN), (int) (ACCESS_LEVEL_MOD)); }
+
+	// repeated lines reuse their parsed commands instead of being tokenized again
+	void SetParsedLineCache(bool Enable);
+	int NumParsedLines() const { return (int) m_ParsedLines.size(); }
 };
 
 #endif
@@ -16,8 +16,37 @@
 #include <engine/storage.h>
 #include <zlib.h>
 
+#include "uuid_manager.h"
+
 static const int DEBUG = 0;
 
+enum
+{
+	// internal types of uuid items count down from ITEMTYPE_EX, vanilla types stay below
+	OFFSET_UUID_TYPE = 0x8000,
+};
+
+struct CItemEx
+{
+	int m_aUuid[sizeof(Uuid) / sizeof(int)];
+
+	static CItemEx FromUuid(Uuid Uuid)
+	{
+		CItemEx Result;
+		for(unsigned i = 0; i < sizeof(Result.m_aUuid) / sizeof(int); i++)
+			Result.m_aUuid[i] = bytes_be_to_uint(&Uuid.m_aData[i * sizeof(int)]);
+		return Result;
+	}
+
+	Uuid ToUuid() const
+	{
+		Uuid Result;
+		for(unsigned i = 0; i < sizeof(m_aUuid) / sizeof(int); i++)
+			uint_to_bytes_be(&Result.m_aData[i * sizeof(int)], m_aUuid[i]);
+		return Result;
+	}
+};
+
 struct CDatafileItemType
 {
 	int m_Type;
@@ -420,23 +449,69 @@ void *CDataFileReader::GetItem(int Index, int *pType, int *pID)
 
 	CDatafileItem *i = (CDatafileItem *) (m_pDataFile->m_Info.m_pItemStart + m_pDataFile->m_Info.m_pItemOffsets[Index]);
 	if(pType)
-		*pType = (i->m_TypeAndID >> 16) & 0xffff; // remove sign extention
+		*pType = GetExternalItemType((i->m_TypeAndID >> 16) & 0xffff); // remove sign extention
 	if(pID)
 		*pID = i->m_TypeAndID & 0xffff;
 	return (void *) (i + 1);
 }
 
+int CDataFileReader::GetExternalItemType(int InternalType)
+{
+	if(InternalType <= OFFSET_UUID_TYPE || InternalType == ITEMTYPE_EX)
+		return InternalType;
+
+	int Start, Num;
+	GetInternalType(ITEMTYPE_EX, &Start, &Num);
+	for(int i = 0; i < Num; i++)
+	{
+		int ID;
+		const CItemEx *pItem = static_cast<CItemEx *>(GetItem(Start + i, 0, &ID));
+		if(ID != InternalType || GetItemSize(Start + i) < (int) sizeof(CItemEx))
+			continue;
+		return g_UuidManager.LookupUuid(pItem->ToUuid()); // UUID_UNKNOWN for types of other forks
+	}
+	return InternalType;
+}
+
+int CDataFileReader::GetInternalItemType(int ExternalType)
+{
+	if(ExternalType < OFFSET_UUID)
+		return ExternalType;
+
+	const CItemEx Wanted = CItemEx::FromUuid(g_UuidManager.GetUuid(ExternalType));
+	int Start, Num;
+	GetInternalType(ITEMTYPE_EX, &Start, &Num);
+	for(int i = 0; i < Num; i++)
+	{
+		int ID;
+		const void *pItem = GetItem(Start + i, 0, &ID);
+		if(GetItemSize(Start + i) >= (int) sizeof(CItemEx) && mem_comp(pItem, &Wanted, sizeof(CItemEx)) == 0)
+			return ID;
+	}
+	return -1;
+}
+
 void CDataFileReader::GetType(int Type, int *pStart, int *pNum)
 {
 	*pStart = 0;
 	*pNum = 0;
 
+	const int InternalType = GetInternalItemType(Type);
+	if(InternalType != -1)
+		GetInternalType(InternalType, pStart, pNum);
+}
+
+void CDataFileReader::GetInternalType(int InternalType, int *pStart, int *pNum)
+{
+	*pStart = 0;
+	*pNum = 0;
+
 	if(!m_pDataFile)
 		return;
 
 	for(int i = 0; i < m_pDataFile->m_Header.m_NumItemTypes; i++)
 	{
-		if(m_pDataFile->m_Info.m_pItemTypes[i].m_Type == Type)
+		if(m_pDataFile->m_Info.m_pItemTypes[i].m_Type == InternalType)
 		{
 			*pStart = m_pDataFile->m_Info.m_pItemTypes[i].m_Start;
 			*pNum = m_pDataFile->m_Info.m_pItemTypes[i].m_Num;
@@ -551,6 +626,7 @@ bool CDataFileWriter::Open(class IStorage *pStorage, const char *pFilename)
 	m_NumItems = 0;
 	m_NumDatas = 0;
 	m_NumItemTypes = 0;
+	m_NumExtendedItemTypes = 0;
 	mem_zero(m_pItemTypes, sizeof(CItemTypeInfo) * MAX_ITEM_TYPES);
 
 	for(int i = 0; i < MAX_ITEM_TYPES; i++)
@@ -567,7 +643,10 @@ int CDataFileWriter::AddItem(int Type, int ID, int Size, const void *pData)
 	if(!m_File)
 		return 0;
 
-	dbg_assert(Type >= 0 && Type < 0xFFFF, "incorrect type");
+	if(Type >= OFFSET_UUID)
+		Type = ITEMTYPE_EX - GetExtendedItemTypeIndex(Type) - 1;
+
+	dbg_assert(Type >= 0 && Type < MAX_ITEM_TYPES, "incorrect type");
 	dbg_assert(m_NumItems < 1024, "too many items");
 	dbg_assert(Size % sizeof(int) == 0, "incorrect boundary");
 
@@ -599,6 +678,23 @@ int CDataFileWriter::AddItem(int Type, int ID, int Size, const void *pData)
 	return m_NumItems - 1;
 }
 
+int CDataFileWriter::GetExtendedItemTypeIndex(int Type)
+{
+	for(int i = 0; i < m_NumExtendedItemTypes; i++)
+	{
+		if(m_aExtendedItemTypes[i] == Type)
+			return i;
+	}
+
+	// the first item of a uuid type also adds the item naming its internal type
+	dbg_assert(m_NumExtendedItemTypes < MAX_EXTENDED_ITEM_TYPES, "too many extended item types");
+	const int Index = m_NumExtendedItemTypes++;
+	m_aExtendedItemTypes[Index] = Type;
+	const CItemEx ExtendedType = CItemEx::FromUuid(g_UuidManager.GetUuid(Type));
+	AddItem(ITEMTYPE_EX, ITEMTYPE_EX - Index - 1, sizeof(ExtendedType), &ExtendedType);
+	return Index;
+}
+
 int CDataFileWriter::AddData(int Size, const void *pData)
 {
 	if(!m_File)
@@ -705,7 +801,7 @@ int CDataFileWriter::Finish()
 	}
 
 	// write types
-	for(int i = 0, Count = 0; i < 0xffff; i++)
+	for(int i = 0, Count = 0; i < MAX_ITEM_TYPES; i++)
 	{
 		if(m_pItemTypes[i].m_Num)
 		{
@@ -725,7 +821,7 @@ int CDataFileWriter::Finish()
 	}
 
 	// write item offsets
-	for(int i = 0, Offset = 0; i < 0xffff; i++)
+	for(int i = 0, Offset = 0; i < MAX_ITEM_TYPES; i++)
 	{
 		if(m_pItemTypes[i].m_Num)
 		{
@@ -774,7 +870,7 @@ int CDataFileWriter::Finish()
 	}
 
 	// write m_pItems
-	for(int i = 0; i < 0xffff; i++)
+	for(int i = 0; i < MAX_ITEM_TYPES; i++)
 	{
 		if(m_pItemTypes[i].m_Num)
 		{
@@ -783,7 +879,7 @@ int CDataFileWriter::Finish()
 			while(k != -1)
 			{
 				CDatafileItem Item;
-				Item.m_TypeAndID = (i << 16) | m_pItems[k].m_ID;
+				Item.m_TypeAndID = (int) (((unsigned) i << 16) | m_pItems[k].m_ID);
 				Item.m_Size = m_pItems[k].m_Size;
 				if(DEBUG)
 					dbg_msg("datafile", "writing item type=%x idx=%d id=%d size=%d", i, k, m_pItems[k].m_ID, m_pItems[k].m_Size);
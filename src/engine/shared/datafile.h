@@ -14,6 +14,12 @@
 #include <base/hash.h>
 #include <base/system.h>
 
+enum
+{
+	// items of this type map an internal type, their ID, to the uuid in their data
+	ITEMTYPE_EX = 0xffff,
+};
+
 // raw datafile access
 class CDataFileReader
 {
@@ -21,6 +27,9 @@ class CDataFileReader
 	void *GetDataImpl(int Index, int Swap);
 	int GetFileDataSize(int Index) const;
 	int GetFileItemSize(int Index) const;
+	int GetExternalItemType(int InternalType);
+	int GetInternalItemType(int ExternalType);
+	void GetInternalType(int InternalType, int *pStart, int *pNum);
 
 public:
 	CDataFileReader() :
@@ -80,9 +89,10 @@ class CDataFileWriter
 
 	enum
 	{
-		MAX_ITEM_TYPES = 0xffff,
+		MAX_ITEM_TYPES = 0x10000,
 		MAX_ITEMS = 1024,
 		MAX_DATAS = 1024,
+		MAX_EXTENDED_ITEM_TYPES = 64,
 	};
 
 	IOHANDLE m_File;
@@ -92,6 +102,10 @@ class CDataFileWriter
 	CItemTypeInfo *m_pItemTypes;
 	CItemInfo *m_pItems;
 	CDataInfo *m_pDatas;
+	int m_aExtendedItemTypes[MAX_EXTENDED_ITEM_TYPES];
+	int m_NumExtendedItemTypes;
+
+	int GetExtendedItemTypeIndex(int Type);
 
 public:
 	CDataFileWriter();
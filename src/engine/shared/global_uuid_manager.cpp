@@ -2,12 +2,14 @@
 #include "uuid_manager.h"
 
 void RegisterGameUuids(CUuidManager *pManager);
+void RegisterMapItemTypeUuids(CUuidManager *pManager);
 
 static CUuidManager CreateGlobalUuidManager()
 {
 	CUuidManager Manager;
 	RegisterUuids(&Manager);
 	RegisterGameUuids(&Manager);
+	RegisterMapItemTypeUuids(&Manager);
 	return Manager;
 }
 
@@ -19,7 +19,9 @@
 #include "jsonparser.h"
 #include "memheap.h"
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 
 class CString
@@ -47,7 +49,7 @@ protected:
 
 public:
 	CLocalization(IStorage *pStorage, IConsole *pConsole, CConfig *pConfig);
-	~CLocalization() = default;
+	~CLocalization();
 
 	void Init() override;
 	const char *Localize(const char *pCode, const char *pStr, const char *pContext) override;
@@ -63,12 +65,14 @@ private:
 		char m_aCode[8];
 		char m_aParent[8];
 		char m_aName[32];
-		bool m_Loaded;
+		// set by the loader thread once the strings are complete
+		std::atomic<bool> m_Loaded;
 
 	public:
 		CLanguage(const char *pCode, const char *pName, const char *pParent);
 
 		void AddString(const char *pKey, const char *pValue, const char *pContext);
+		// logs through dbg_msg without a console
 		void Load(IStorage *pStorage, IConsole *pConsole);
 
 		const char *FindString(unsigned Hash, unsigned ContextHash) const;
@@ -77,10 +81,15 @@ private:
 		const char *Code() { return m_aCode; }
 		const char *Name() { return m_aName; }
 		const char *Parent() { return m_aParent; }
-		inline bool IsLoaded() { return m_Loaded; }
+		inline bool IsLoaded() { return m_Loaded.load(std::memory_order_acquire); }
 	};
 	std::unordered_map<unsigned, std::shared_ptr<CLanguage>> m_vpLanguages;
 
+	// loads every language pack in the background, the tick thread never parses json
+	std::thread m_LoadThread;
+	std::atomic<bool> m_StopLoading;
+	void LoadLanguages();
+
 	void AddLanguage(const char *pCode, const char *pName, const char *pParent);
 };
 
@@ -90,10 +99,18 @@ CLocalization::CLocalization(IStorage *pStorage, IConsole *pConsole, CConfig *pC
 	m_pStorage = pStorage;
 	m_pConsole = pConsole;
 	m_pConfig = pConfig;
+	m_StopLoading = false;
 
 	m_vpLanguages.clear();
 }
 
+CLocalization::~CLocalization()
+{
+	m_StopLoading = true;
+	if(m_LoadThread.joinable())
+		m_LoadThread.join();
+}
+
 void CLocalization::Init()
 {
 	CJsonParser JsonParser;
@@ -117,6 +134,21 @@ void CLocalization::Init()
 		}
 	}
 	Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "l10n", "initialized l10n");
+
+	// the language list is fixed from here on, only the strings arrive later
+	m_LoadThread = std::thread(&CLocalization::LoadLanguages, this);
+}
+
+void CLocalization::LoadLanguages()
+{
+	for(auto &[LanguageID, pLanguage] : m_vpLanguages)
+	{
+		if(m_StopLoading)
+			return;
+		// console output may go out to rcon clients, which is only safe on the main thread
+		if(!pLanguage->IsLoaded())
+			pLanguage->Load(Storage(), nullptr);
+	}
 }
 
 const char *CLocalization::Localize(const char *pCode, const char *pStr, const char *pContext)
@@ -124,14 +156,14 @@ const char *CLocalization::Localize(const char *pCode, const char *pStr, const c
 	if(str_comp(pCode, "en") == 0)
 		return pStr;
 
-	unsigned LanguageID = str_quickhash(pCode);
-	if(!m_vpLanguages.count(LanguageID))
+	auto It = m_vpLanguages.find(str_quickhash(pCode));
+	if(It == m_vpLanguages.end())
 		return pStr;
-	if(!m_vpLanguages[LanguageID]->IsLoaded())
-		m_vpLanguages[LanguageID]->Load(Storage(), Console());
-	const char *pNewStr = m_vpLanguages[LanguageID]->Localize(pStr, pContext);
+	// still loading or failed to load, the parent language stands in
+	CLanguage *pLanguage = It->second.get();
+	const char *pNewStr = pLanguage->IsLoaded() ? pLanguage->Localize(pStr, pContext) : nullptr;
 	if(!pNewStr)
-		return Localize(m_vpLanguages[LanguageID]->Parent(), pStr, pContext);
+		return Localize(pLanguage->Parent(), pStr, pContext);
 	return pNewStr;
 }
 
@@ -167,13 +199,19 @@ void CLocalization::CLanguage::Load(IStorage *pStorage, IConsole *pConsole)
 	const json_value *pJsonData = JsonParser.ParseFile(aPath, pStorage);
 	if(pJsonData == nullptr)
 	{
-		pConsole->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "l10n", JsonParser.Error());
+		if(pConsole)
+			pConsole->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "l10n", JsonParser.Error());
+		else
+			dbg_msg("l10n", "%s", JsonParser.Error());
 		return;
 	}
 
 	char aBuf[256];
 	str_format(aBuf, sizeof(aBuf), "loaded '%s'", aPath);
-	pConsole->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "l10n", aBuf);
+	if(pConsole)
+		pConsole->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "l10n", aBuf);
+	else
+		dbg_msg("l10n", "%s", aBuf);
 	m_Strings.clear();
 	m_StringsHeap.Reset();
 
@@ -187,7 +225,7 @@ void CLocalization::CLanguage::Load(IStorage *pStorage, IConsole *pConsole)
 		}
 	}
 
-	m_Loaded = true;
+	m_Loaded.store(true, std::memory_order_release);
 
 	return;
 }
@@ -248,9 +286,6 @@ void CLocalization::AddLanguage(const char *pCode, const char *pName, const char
 	char aBuf[256];
 	str_format(aBuf, sizeof(aBuf), "loaded language '%s'(%s)", pCode, pName);
 	Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "l10n", aBuf);
-
-	if(str_comp(Config()->m_SvDefaultLanguage, pCode) == 0)
-		pLanguage->Load(Storage(), Console());
 }
 
 ILocalization *CreateLocalization(IStorage *pStorage, IConsole *pConsole, CConfig *pConfig)
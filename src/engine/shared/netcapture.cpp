@@ -0,0 +1,262 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <base/math.h>
+#include <base/system.h>
+
+#include "netcapture.h"
+
+static const char gs_aNetCaptureMagic[8] = {'T', 'W', 'N', 'E', 'T', 'C', 'A', 'P'};
+
+enum
+{
+	NETCAPTURE_HEADERSIZE = sizeof(gs_aNetCaptureMagic) + 4,
+	NETCAPTURE_RECORDHEADERSIZE = 8 + 1 + 4 + NETADDR_SIZE_IPV6 + 2 + 2,
+};
+
+static int64_t TimeToMicroseconds(int64_t Time)
+{
+	// split the conversion so long captures don't overflow
+	const int64_t Freq = time_freq();
+	return Time / Freq * 1000000 + Time % Freq * 1000000 / Freq;
+}
+
+CNetCaptureWriter::CNetCaptureWriter()
+{
+	m_File = 0;
+	m_StartTime = 0;
+	m_NumRecords = 0;
+}
+
+CNetCaptureWriter::~CNetCaptureWriter()
+{
+	Close();
+}
+
+bool CNetCaptureWriter::Open(IOHANDLE File)
+{
+	Close();
+	if(!File)
+		return false;
+
+	unsigned char aHeader[NETCAPTURE_HEADERSIZE];
+	mem_copy(aHeader, gs_aNetCaptureMagic, sizeof(gs_aNetCaptureMagic));
+	uint_to_bytes_be(&aHeader[sizeof(gs_aNetCaptureMagic)], NETCAPTURE_VERSION);
+	if(io_write(File, aHeader, sizeof(aHeader)) != sizeof(aHeader))
+	{
+		io_close(File);
+		return false;
+	}
+
+	m_File = File;
+	m_StartTime = time_get();
+	m_NumRecords = 0;
+	return true;
+}
+
+void CNetCaptureWriter::Close()
+{
+	if(!m_File)
+		return;
+
+	io_close(m_File);
+	m_File = 0;
+}
+
+void CNetCaptureWriter::Write(int Direction, const NETADDR *pAddr, const void *pData, int DataSize)
+{
+	if(!m_File || DataSize <= 0 || DataSize > NET_MAX_PACKETSIZE)
+		return;
+
+	CNetCaptureRecord Record;
+	Record.m_Time = TimeToMicroseconds(time_get() - m_StartTime);
+	Record.m_Direction = Direction;
+	Record.m_Addr = *pAddr;
+	Record.m_DataSize = DataSize;
+	mem_copy(Record.m_aData, pData, DataSize);
+	WriteRecord(&Record);
+}
+
+void CNetCaptureWriter::WriteRecord(const CNetCaptureRecord *pRecord)
+{
+	if(!m_File)
+		return;
+
+	unsigned char aHeader[NETCAPTURE_RECORDHEADERSIZE];
+	int i = 0;
+	uint_to_bytes_be(&aHeader[i], (unsigned) ((uint64_t) pRecord->m_Time >> 32));
+	i += 4;
+	uint_to_bytes_be(&aHeader[i], (unsigned) ((uint64_t) pRecord->m_Time & 0xffffffff));
+	i += 4;
+	aHeader[i++] = pRecord->m_Direction & 0xff;
+	uint_to_bytes_be(&aHeader[i], pRecord->m_Addr.type);
+	i += 4;
+	mem_copy(&aHeader[i], pRecord->m_Addr.ip, NETADDR_SIZE_IPV6);
+	i += NETADDR_SIZE_IPV6;
+	aHeader[i++] = (pRecord->m_Addr.port >> 8) & 0xff;
+	aHeader[i++] = pRecord->m_Addr.port & 0xff;
+	aHeader[i++] = (pRecord->m_DataSize >> 8) & 0xff;
+	aHeader[i++] = pRecord->m_DataSize & 0xff;
+
+	dbg_assert(i == NETCAPTURE_RECORDHEADERSIZE, "inconsistency");
+
+	io_write(m_File, aHeader, sizeof(aHeader));
+	io_write(m_File, pRecord->m_aData, pRecord->m_DataSize);
+	m_NumRecords++;
+}
+
+CNetCaptureReader::CNetCaptureReader()
+{
+	m_File = 0;
+}
+
+CNetCaptureReader::~CNetCaptureReader()
+{
+	Close();
+}
+
+bool CNetCaptureReader::Open(IOHANDLE File)
+{
+	Close();
+	if(!File)
+		return false;
+
+	unsigned char aHeader[NETCAPTURE_HEADERSIZE];
+	if(io_read(File, aHeader, sizeof(aHeader)) != sizeof(aHeader) ||
+		mem_comp(aHeader, gs_aNetCaptureMagic, sizeof(gs_aNetCaptureMagic)) != 0 ||
+		bytes_be_to_uint(&aHeader[sizeof(gs_aNetCaptureMagic)]) != NETCAPTURE_VERSION)
+	{
+		io_close(File);
+		return false;
+	}
+
+	m_File = File;
+	return true;
+}
+
+void CNetCaptureReader::Close()
+{
+	if(!m_File)
+		return;
+
+	io_close(m_File);
+	m_File = 0;
+}
+
+bool CNetCaptureReader::Read(CNetCaptureRecord *pRecord)
+{
+	if(!m_File)
+		return false;
+
+	unsigned char aHeader[NETCAPTURE_RECORDHEADERSIZE];
+	if(io_read(m_File, aHeader, sizeof(aHeader)) != sizeof(aHeader))
+		return false;
+
+	int i = 0;
+	uint64_t Time = (uint64_t) bytes_be_to_uint(&aHeader[i]) << 32;
+	i += 4;
+	Time |= bytes_be_to_uint(&aHeader[i]);
+	i += 4;
+	pRecord->m_Time = (int64_t) Time;
+	pRecord->m_Direction = aHeader[i++];
+	mem_zero(&pRecord->m_Addr, sizeof(pRecord->m_Addr));
+	pRecord->m_Addr.type = bytes_be_to_uint(&aHeader[i]);
+	i += 4;
+	mem_copy(pRecord->m_Addr.ip, &aHeader[i], NETADDR_SIZE_IPV6);
+	i += NETADDR_SIZE_IPV6;
+	pRecord->m_Addr.port = (aHeader[i] << 8) | aHeader[i + 1];
+	i += 2;
+	pRecord->m_DataSize = (aHeader[i] << 8) | aHeader[i + 1];
+
+	if(pRecord->m_DataSize > NET_MAX_PACKETSIZE)
+		return false;
+
+	return io_read(m_File, pRecord->m_aData, pRecord->m_DataSize) == (unsigned) pRecord->m_DataSize;
+}
+
+CNetReplay::CNetReplay()
+{
+	m_HasNext = false;
+	m_MaxSpeed = false;
+	m_PumpBudget = NETREPLAY_MAX_PER_PUMP;
+	m_StartTime = 0;
+	mem_zero(&m_Stats, sizeof(m_Stats));
+}
+
+bool CNetReplay::Open(IOHANDLE File, bool MaxSpeed)
+{
+	if(!m_Reader.Open(File))
+		return false;
+
+	m_MaxSpeed = MaxSpeed;
+	m_StartTime = time_get();
+	mem_zero(&m_Stats, sizeof(m_Stats));
+	FetchNext();
+	return true;
+}
+
+void CNetReplay::Close()
+{
+	m_Reader.Close();
+	m_HasNext = false;
+}
+
+void CNetReplay::FetchNext()
+{
+	// only datagrams the capturing side received are fed back in,
+	// what it sent is regenerated by the replaying side
+	while((m_HasNext = m_Reader.Read(&m_Next)))
+	{
+		if(m_Next.m_Direction == NETCAPTURE_DIR_RECV)
+			break;
+	}
+}
+
+int CNetReplay::Recv(NETADDR *pAddr, unsigned char *pBuffer, int MaxSize)
+{
+	if(!m_HasNext)
+		return 0;
+
+	if(m_MaxSpeed)
+	{
+		if(m_PumpBudget <= 0)
+			return 0;
+		m_PumpBudget--;
+	}
+	else if(TimeToMicroseconds(time_get() - m_StartTime) < m_Next.m_Time)
+		return 0;
+
+	int Size = minimum(m_Next.m_DataSize, MaxSize);
+	*pAddr = m_Next.m_Addr;
+	mem_copy(pBuffer, m_Next.m_aData, Size);
+
+	m_Stats.m_RecvPackets++;
+	m_Stats.m_RecvBytes += Size;
+	m_Stats.m_LastRecordTime = m_Next.m_Time;
+
+	FetchNext();
+	return Size;
+}
+
+void CNetReplay::Send(const NETADDR *pAddr, const void *pData, int DataSize)
+{
+	m_Stats.m_SentPackets++;
+	m_Stats.m_SentBytes += DataSize;
+}
+
+int CNetReplay::NextDue() const
+{
+	if(!m_HasNext)
+		return -1;
+	if(m_MaxSpeed)
+		return 0;
+
+	int64_t Delay = m_Next.m_Time - TimeToMicroseconds(time_get() - m_StartTime);
+	return Delay <= 0 ? 0 : (int) (Delay / 1000);
+}
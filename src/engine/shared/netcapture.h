@@ -0,0 +1,135 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef ENGINE_SHARED_NETCAPTURE_H
+#define ENGINE_SHARED_NETCAPTURE_H
+
+#include <base/system.h>
+
+#include "network.h"
+
+/*
+	capture file:
+		header: 12 bytes
+			char magic[8];              // "TWNETCAP"
+			unsigned char version[4];   // 32bit big endian
+
+		record: 33 bytes + data
+			unsigned char time[8];      // 64bit big endian, microseconds since capture start
+			unsigned char direction;    // NETCAPTURE_DIR_*
+			unsigned char type[4];      // NETADDR type
+			unsigned char ip[16];       // NETADDR ip
+			unsigned char port[2];      // NETADDR port
+			unsigned char size[2];      // raw datagram size
+			unsigned char data[size];   // raw datagram as seen on the socket
+*/
+
+enum
+{
+	NETCAPTURE_VERSION = 1,
+
+	NETCAPTURE_DIR_RECV = 0,
+	NETCAPTURE_DIR_SENT = 1,
+
+	// datagrams a max speed replay hands out per pump, so the tick loop keeps running
+	NETREPLAY_MAX_PER_PUMP = 256,
+};
+
+class CNetCaptureRecord
+{
+public:
+	int64_t m_Time; // microseconds since capture start
+	int m_Direction;
+	NETADDR m_Addr;
+	int m_DataSize;
+	unsigned char m_aData[NET_MAX_PACKETSIZE];
+};
+
+class CNetCaptureWriter
+{
+	IOHANDLE m_File;
+	int64_t m_StartTime;
+	int m_NumRecords;
+
+public:
+	CNetCaptureWriter();
+	~CNetCaptureWriter();
+
+	bool Open(IOHANDLE File);
+	void Close();
+	bool IsOpen() const { return m_File != 0; }
+	int NumRecords() const { return m_NumRecords; }
+
+	void Write(int Direction, const NETADDR *pAddr, const void *pData, int DataSize);
+	void WriteRecord(const CNetCaptureRecord *pRecord);
+};
+
+class CNetCaptureReader
+{
+	IOHANDLE m_File;
+
+public:
+	CNetCaptureReader();
+	~CNetCaptureReader();
+
+	bool Open(IOHANDLE File);
+	void Close();
+	bool IsOpen() const { return m_File != 0; }
+
+	// returns false at the end of the capture or on a truncated record
+	bool Read(CNetCaptureRecord *pRecord);
+};
+
+// socket stand-in that feeds captured datagrams into a CNetBase
+class CNetReplay
+{
+	CNetCaptureReader m_Reader;
+	CNetCaptureRecord m_Next;
+	bool m_HasNext;
+	bool m_MaxSpeed;
+	int m_PumpBudget;
+	int64_t m_StartTime;
+
+	void FetchNext();
+
+public:
+	class CStats
+	{
+	public:
+		int m_RecvPackets;
+		int m_RecvBytes;
+		int m_SentPackets;
+		int m_SentBytes;
+		int64_t m_LastRecordTime;
+	};
+
+	CNetReplay();
+
+	// MaxSpeed ignores the recorded timestamps and delivers everything as fast as it is read
+	bool Open(IOHANDLE File, bool MaxSpeed);
+	void Close();
+	bool IsOpen() const { return m_Reader.IsOpen(); }
+	bool Done() const { return !m_HasNext; }
+
+	// call before each network pump, a max speed replay delivers at most NETREPLAY_MAX_PER_PUMP datagrams per pump
+	void BeginPump() { m_PumpBudget = NETREPLAY_MAX_PER_PUMP; }
+	// same semantics as net_udp_recv: returns the datagram size or 0 if nothing is due
+	int Recv(NETADDR *pAddr, unsigned char *pBuffer, int MaxSize);
+	// outgoing datagrams are swallowed, only accounted
+	void Send(const NETADDR *pAddr, const void *pData, int DataSize);
+	// time in milliseconds until the next datagram is due, -1 if the capture is exhausted
+	int NextDue() const;
+
+	const CStats *Stats() const { return &m_Stats; }
+
+private:
+	CStats m_Stats;
+};
+
+#endif
@@ -16,6 +16,7 @@
 #include "config.h"
 #include "console.h"
 #include "huffman.h"
+#include "netcapture.h"
 #include "network.h"
 
 CNetBase::CNetInitializer::CNetInitializer()
@@ -92,12 +93,18 @@ int CNetRecvUnpacker::FetchChunk(CNetChunk *pChunk)
 			{
 				// in sequence
 				m_pConnection->m_Ack = (m_pConnection->m_Ack + 1) % NET_MAX_SEQUENCE;
+				m_pConnection->m_ConnStats.m_NumVitalRecv++;
 			}
 			else
 			{
 				// old packet that we already got
 				if(m_pConnection->IsSeqInBackroom(Header.m_Sequence, m_pConnection->m_Ack))
+				{
+					m_pConnection->m_ConnStats.m_NumDuplicates++;
 					continue;
+				}
+
+				m_pConnection->m_ConnStats.m_NumOutOfOrder++;
 
 				// out of sequence, request resend
 				if(m_pConnection->Config()->m_Debug)
@@ -125,6 +132,8 @@ CNetBase::CNetBase()
 	m_pEngine = 0;
 	m_DataLogSent = 0;
 	m_DataLogRecv = 0;
+	m_pCapture = 0;
+	m_pReplay = 0;
 }
 
 CNetBase::~CNetBase()
@@ -140,10 +149,18 @@ void CNetBase::Init(NETSOCKET Socket, CConfig *pConfig, IConsole *pConsole, IEng
 	m_pEngine = pEngine;
 	m_Huffman.Init();
 	mem_zero(m_aRequestTokenBuf, sizeof(m_aRequestTokenBuf));
+	ResetPacketStats();
 	if(pEngine)
 		pConsole->Chain("dbg_lognetwork", ConchainDbgLognetwork, this);
 }
 
+void CNetBase::ResetPacketStats()
+{
+	m_PacketStats.m_StartTime = time_get();
+	m_PacketStats.m_NumPackets = 0;
+	m_PacketStats.m_NumPayloadBytes = 0;
+}
+
 void CNetBase::Shutdown()
 {
 	net_udp_close(m_Socket);
@@ -152,9 +169,28 @@ void CNetBase::Shutdown()
 
 void CNetBase::Wait(int Time)
 {
+	if(m_pReplay)
+	{
+		int Due = m_pReplay->NextDue();
+		if(Due == 0)
+			return;
+		if(Due > 0)
+			Time = minimum(Time, Due);
+	}
 	net_socket_read_wait(m_Socket, Time);
 }
 
+void CNetBase::SendRaw(const NETADDR *pAddr, const void *pData, int DataSize)
+{
+	if(m_pReplay)
+		m_pReplay->Send(pAddr, pData, DataSize);
+	else
+		net_udp_send(m_Socket, pAddr, pData, DataSize);
+
+	if(m_pCapture)
+		m_pCapture->Write(NETCAPTURE_DIR_SENT, pAddr, pData, DataSize);
+}
+
 // packs the data tight and sends it
 void CNetBase::SendPacketConnless(const NETADDR *pAddr, TOKEN Token, TOKEN ResponseToken, const void *pData, int DataSize)
 {
@@ -178,7 +214,7 @@ void CNetBase::SendPacketConnless(const NETADDR *pAddr, TOKEN Token, TOKEN Respo
 	dbg_assert(i == NET_PACKETHEADERSIZE_CONNLESS, "inconsistency");
 
 	mem_copy(&aBuffer[i], pData, DataSize);
-	net_udp_send(m_Socket, pAddr, aBuffer, i + DataSize);
+	SendRaw(pAddr, aBuffer, i + DataSize);
 }
 
 void CNetBase::SendPacket(const NETADDR *pAddr, CNetPacketConstruct *pPacket)
@@ -199,6 +235,12 @@ void CNetBase::SendPacket(const NETADDR *pAddr, CNetPacketConstruct *pPacket)
 
 	dbg_assert((pPacket->m_Token & ~NET_TOKEN_MASK) == 0, "token out of range");
 
+	if(!(pPacket->m_Flags & NET_PACKETFLAG_CONTROL))
+	{
+		m_PacketStats.m_NumPackets++;
+		m_PacketStats.m_NumPayloadBytes += pPacket->m_DataSize;
+	}
+
 	// compress if not ctrl msg
 	if(!(pPacket->m_Flags & NET_PACKETFLAG_CONTROL))
 		CompressedSize = m_Huffman.Compress(pPacket->m_aChunkData, pPacket->m_DataSize, &aBuffer[NET_PACKETHEADERSIZE], NET_MAX_PAYLOAD);
@@ -233,7 +275,7 @@ void CNetBase::SendPacket(const NETADDR *pAddr, CNetPacketConstruct *pPacket)
 
 		dbg_assert(i == NET_PACKETHEADERSIZE, "inconsistency");
 
-		net_udp_send(m_Socket, pAddr, aBuffer, FinalSize);
+		SendRaw(pAddr, aBuffer, FinalSize);
 
 		// log raw socket data
 		if(m_DataLogSent)
@@ -250,11 +292,18 @@ void CNetBase::SendPacket(const NETADDR *pAddr, CNetPacketConstruct *pPacket)
 // TODO: rename this function
 int CNetBase::UnpackPacket(NETADDR *pAddr, unsigned char *pBuffer, CNetPacketConstruct *pPacket)
 {
-	int Size = net_udp_recv(m_Socket, pAddr, pBuffer, NET_MAX_PACKETSIZE);
+	int Size;
+	if(m_pReplay)
+		Size = m_pReplay->Recv(pAddr, pBuffer, NET_MAX_PACKETSIZE);
+	else
+		Size = net_udp_recv(m_Socket, pAddr, pBuffer, NET_MAX_PACKETSIZE);
 	// no more packets for now
 	if(Size <= 0)
 		return 1;
 
+	if(m_pCapture)
+		m_pCapture->Write(NETCAPTURE_DIR_RECV, pAddr, pBuffer, Size);
+
 	// log the data
 	if(m_DataLogRecv)
 	{
@@ -138,8 +138,6 @@ enum
 	NET_CTRLMSG_CLOSE = 4,
 	NET_CTRLMSG_TOKEN = 5,
 
-	NET_CONN_BUFFERSIZE = 1024 * 32,
-
 	NET_ENUM_TERMINATOR
 };
 
@@ -180,6 +178,71 @@ public:
 	int m_Sequence;
 	int64_t m_LastSendTime;
 	int64_t m_FirstSendTime;
+
+	int m_AllocSize;
+	// sequence order, acks pop from the front
+	CNetChunkResend *m_pNext;
+	// resend timer order, least recently sent first
+	CNetChunkResend *m_pTimerPrev;
+	CNetChunkResend *m_pTimerNext;
+};
+
+// slab allocator shared by the resend buffers of all connections of a CNetBase,
+// slabs are only allocated while chunks are in flight and handed back when they drain
+class CNetResendPool
+{
+public:
+	enum
+	{
+		MIN_BLOCK_SIZE = 64,
+		NUM_SIZE_CLASSES = 6, // 64 - 2048 bytes
+		SLAB_SIZE = 1024 * 16,
+		NUM_SPARE_SLABS = 1, // empty slabs kept per size class
+	};
+
+	class CStats
+	{
+	public:
+		int m_NumSlabs;
+		int m_NumSlabsPeak;
+		int m_NumBlocks;
+		int m_BytesInUse;
+	};
+
+private:
+	struct CSlab
+	{
+		CSlab *m_pPrev;
+		CSlab *m_pNext;
+		void *m_pFree;
+		int m_SizeClass;
+		int m_NumUsed;
+		int m_NumBlocks;
+	};
+
+	// slabs with free blocks are kept in front of full ones
+	CSlab *m_apFirst[NUM_SIZE_CLASSES];
+	CSlab *m_apLast[NUM_SIZE_CLASSES];
+	int m_aNumEmpty[NUM_SIZE_CLASSES];
+	CStats m_Stats;
+
+	static int BlockSize(int SizeClass) { return MIN_BLOCK_SIZE << SizeClass; }
+	void Unlink(CSlab *pSlab);
+	void LinkFirst(CSlab *pSlab);
+	void LinkLast(CSlab *pSlab);
+	CSlab *NewSlab(int SizeClass);
+
+public:
+	// a zeroed pool is a valid empty pool
+	CNetResendPool();
+	~CNetResendPool();
+
+	void *Allocate(int Size);
+	void Free(void *pData);
+	void Clear();
+
+	static int AllocSize(int Size);
+	const CStats *Stats() const { return &m_Stats; }
 };
 
 class CNetPacketConstruct
@@ -203,13 +266,31 @@ class CNetBase
 	};
 	static CNetInitializer m_NetInitializer;
 
+public:
+	// outgoing connection packets, used to judge how well chunks get packed
+	class CPacketStats
+	{
+	public:
+		int64_t m_StartTime;
+		int m_NumPackets;
+		int64_t m_NumPayloadBytes;
+	};
+
+private:
+
 	class CConfig *m_pConfig;
 	class IEngine *m_pEngine;
 	NETSOCKET m_Socket;
 	IOHANDLE m_DataLogSent;
 	IOHANDLE m_DataLogRecv;
+	class CNetCaptureWriter *m_pCapture;
+	class CNetReplay *m_pReplay;
 	CHuffman m_Huffman;
 	unsigned char m_aRequestTokenBuf[NET_TOKENREQUEST_DATASIZE];
+	CPacketStats m_PacketStats;
+	CNetResendPool m_ResendPool;
+
+	void SendRaw(const NETADDR *pAddr, const void *pData, int DataSize);
 
 public:
 	CNetBase();
@@ -223,6 +304,16 @@ public:
 	void UpdateLogHandles();
 	void Wait(int Time);
 
+	// capture raw datagrams, or replace the socket by a capture replay
+	void SetCapture(class CNetCaptureWriter *pCapture) { m_pCapture = pCapture; }
+	void SetReplay(class CNetReplay *pReplay) { m_pReplay = pReplay; }
+	bool IsReplaying() const { return m_pReplay != 0; }
+
+	const CPacketStats *PacketStats() const { return &m_PacketStats; }
+	void ResetPacketStats();
+
+	CNetResendPool *ResendPool() { return &m_ResendPool; }
+
 	void SendControlMsg(const NETADDR *pAddr, TOKEN Token, int Ack, int ControlMsg, const void *pExtra, int ExtraSize);
 	void SendControlMsgWithToken(const NETADDR *pAddr, TOKEN Token, int Ack, int ControlMsg, TOKEN MyToken, bool Extended);
 	void SendPacketConnless(const NETADDR *pAddr, TOKEN Token, TOKEN ResponseToken, const void *pData, int DataSize);
@@ -319,6 +410,42 @@ private:
 	const CNetTokenManager *m_pTokenManager;
 };
 
+// link quality of a single connection, cleared whenever the connection is reset
+class CNetConnStats
+{
+public:
+	enum
+	{
+		// <25ms, <50ms, <100ms, <200ms, <400ms, <800ms, <1600ms, above
+		NUM_RTT_BUCKETS = 8,
+	};
+
+	int m_aRttHistogram[NUM_RTT_BUCKETS];
+	int m_NumRttSamples;
+	int m_RttLast; // in ms
+	int m_RttMin;
+	int m_RttMax;
+	int64_t m_RttSum;
+
+	int m_NumVitalSent;
+	int m_NumResends; // vital chunks sent again, on request or after a timeout
+	int m_NumResendRequests; // packets of the peer asking for a resend
+	int m_BufferUsage; // bytes held in the resend buffer
+	int m_BufferPeak;
+
+	int m_NumVitalRecv; // in sequence
+	int m_NumOutOfOrder; // ahead of the expected sequence, something got lost on the way
+	int m_NumDuplicates; // already received
+
+	void AddRttSample(int Rtt);
+	int RttAverage() const { return m_NumRttSamples ? (int) (m_RttSum / m_NumRttSamples) : 0; }
+	// estimates, the protocol has no explicit loss reporting
+	float SendLoss() const { return m_NumVitalSent ? m_NumResends / (float) m_NumVitalSent : 0.0f; }
+	float RecvLoss() const { return m_NumVitalRecv + m_NumOutOfOrder ? m_NumOutOfOrder / (float) (m_NumVitalRecv + m_NumOutOfOrder) : 0.0f; }
+
+	static int RttBucketLimit(int Bucket) { return Bucket < NUM_RTT_BUCKETS - 1 ? 25 << Bucket : -1; }
+};
+
 class CNetConnection
 {
 	// TODO: is this needed because this needs to be aware of
@@ -335,7 +462,11 @@ private:
 	int m_RemoteClosed;
 	bool m_BlockCloseMsg;
 
-	TStaticRingBuffer<CNetChunkResend, NET_CONN_BUFFERSIZE> m_Buffer;
+	CNetChunkResend *m_pResendFirst;
+	CNetChunkResend *m_pResendLast;
+	CNetChunkResend *m_pTimerFirst;
+	CNetChunkResend *m_pTimerLast;
+	CNetChunkResend *m_pTimerUnsent; // first timer entry queued since the last flush
 
 	int64_t m_LastUpdateTime;
 	int64_t m_LastRecvTime;
@@ -350,6 +481,7 @@ private:
 	NETADDR m_PeerAddr;
 
 	NETSTATS m_Stats;
+	CNetConnStats m_ConnStats;
 	CNetBase *m_pNetBase;
 
 	//
@@ -357,6 +489,9 @@ private:
 	void ResetStats();
 	void SetError(const char *pString);
 	void AckChunks(int Ack);
+	void ClearResendBuffer();
+	void TimerUnlink(CNetChunkResend *pResend);
+	void TimerLinkLast(CNetChunkResend *pResend);
 
 	int QueueChunkEx(int Flags, int DataSize, const void *pData, int Sequence);
 	void SendControl(int ControlMsg, const void *pExtra, int ExtraSize);
@@ -397,6 +532,8 @@ public:
 	int64_t ConnectTime() const { return m_LastUpdateTime; }
 
 	int AckSequence() const { return m_Ack; }
+	const CNetConnStats *ConnStats() const { return &m_ConnStats; }
+	int ResendQuota();
 	// The backroom is ack-NET_MAX_SEQUENCE/2. Used for knowing if we acked a packet or not
 	static int IsSeqInBackroom(int Seq, int Ack);
 };
@@ -457,6 +594,7 @@ class CNetServer : public CNetBase
 	{
 	public:
 		CNetConnection m_Connection;
+		bool m_FlushPending;
 	};
 
 	class CNetBan *m_pNetBan;
@@ -484,6 +622,8 @@ public:
 	int Recv(CNetChunk *pChunk, TOKEN *pResponseToken = 0);
 	int Send(CNetChunk *pChunk, TOKEN Token = NET_TOKEN_NONE);
 	int Update();
+	// sends everything that was queued with NETSENDFLAG_FLUSH since the last call
+	void FlushPending();
 	void AddToken(const NETADDR *pAddr, TOKEN Token) { m_TokenCache.AddToken(pAddr, Token, 0); }
 
 	//
@@ -491,6 +631,7 @@ public:
 
 	// status requests
 	const NETADDR *ClientAddr(int ClientID) const { return m_aSlots[ClientID].m_Connection.PeerAddress(); }
+	const CNetConnStats *ClientConnStats(int ClientID) const { return m_aSlots[ClientID].m_Connection.ConnStats(); }
 	class CNetBan *NetBan() const { return m_pNetBan; }
 
 	TOKEN GetGlobalToken();
@@ -13,6 +13,22 @@
 #include "config.h"
 #include "network.h"
 
+void CNetConnStats::AddRttSample(int Rtt)
+{
+	int Bucket = 0;
+	while(Bucket < NUM_RTT_BUCKETS - 1 && Rtt >= RttBucketLimit(Bucket))
+		Bucket++;
+	m_aRttHistogram[Bucket]++;
+
+	if(!m_NumRttSamples || Rtt < m_RttMin)
+		m_RttMin = Rtt;
+	if(!m_NumRttSamples || Rtt > m_RttMax)
+		m_RttMax = Rtt;
+	m_RttLast = Rtt;
+	m_RttSum += Rtt;
+	m_NumRttSamples++;
+}
+
 void CNetConnection::ResetStats()
 {
 	mem_zero(&m_Stats, sizeof(m_Stats));
@@ -33,7 +49,8 @@ void CNetConnection::Reset()
 	m_PeerToken = NET_TOKEN_NONE;
 	mem_zero(&m_PeerAddr, sizeof(m_PeerAddr));
 
-	m_Buffer.Init();
+	ClearResendBuffer();
+	mem_zero(&m_ConnStats, sizeof(m_ConnStats));
 
 	mem_zero(&m_Construct, sizeof(m_Construct));
 }
@@ -63,27 +80,85 @@ void CNetConnection::SetError(const char *pString)
 
 void CNetConnection::Init(CNetBase *pNetBase, bool BlockCloseMsg)
 {
+	// the owner zeroes the connection before the first Init, so the resend
+	// buffer of an earlier Init goes back to the pool it came from
 	Reset();
 	ResetStats();
-
 	m_pNetBase = pNetBase;
+
 	m_BlockCloseMsg = BlockCloseMsg;
 	mem_zero(m_ErrorString, sizeof(m_ErrorString));
 }
 
-void CNetConnection::AckChunks(int Ack)
+int CNetConnection::ResendQuota()
+{
+	return Config()->m_NetResendQuota * 1024;
+}
+
+void CNetConnection::TimerUnlink(CNetChunkResend *pResend)
+{
+	if(m_pTimerUnsent == pResend)
+		m_pTimerUnsent = pResend->m_pTimerNext;
+	if(pResend->m_pTimerPrev)
+		pResend->m_pTimerPrev->m_pTimerNext = pResend->m_pTimerNext;
+	else
+		m_pTimerFirst = pResend->m_pTimerNext;
+	if(pResend->m_pTimerNext)
+		pResend->m_pTimerNext->m_pTimerPrev = pResend->m_pTimerPrev;
+	else
+		m_pTimerLast = pResend->m_pTimerPrev;
+}
+
+void CNetConnection::TimerLinkLast(CNetChunkResend *pResend)
+{
+	// every chunk gets the same timeout after a send, so appending keeps the list ordered by due time
+	pResend->m_pTimerNext = 0;
+	pResend->m_pTimerPrev = m_pTimerLast;
+	if(!m_pTimerUnsent)
+		m_pTimerUnsent = pResend;
+	if(m_pTimerLast)
+		m_pTimerLast->m_pTimerNext = pResend;
+	else
+		m_pTimerFirst = pResend;
+	m_pTimerLast = pResend;
+}
+
+void CNetConnection::ClearResendBuffer()
 {
-	while(1)
+	while(m_pResendFirst)
 	{
-		CNetChunkResend *pResend = m_Buffer.First();
-		if(!pResend)
-			break;
+		CNetChunkResend *pResend = m_pResendFirst;
+		m_pResendFirst = pResend->m_pNext;
+		m_pNetBase->ResendPool()->Free(pResend);
+	}
+	m_pResendLast = 0;
+	m_pTimerFirst = 0;
+	m_pTimerLast = 0;
+	m_pTimerUnsent = 0;
+}
 
-		if(IsSeqInBackroom(pResend->m_Sequence, Ack))
-			m_Buffer.PopFirst();
-		else
-			break;
+void CNetConnection::AckChunks(int Ack)
+{
+	int64_t SampleTime = 0;
+	while(m_pResendFirst && IsSeqInBackroom(m_pResendFirst->m_Sequence, Ack))
+	{
+		CNetChunkResend *pResend = m_pResendFirst;
+
+		// chunks that were resent can't tell which send got acked
+		if(pResend->m_FirstSendTime == pResend->m_LastSendTime)
+			SampleTime = pResend->m_FirstSendTime;
+		m_ConnStats.m_BufferUsage -= pResend->m_AllocSize;
+
+		m_pResendFirst = pResend->m_pNext;
+		if(!m_pResendFirst)
+			m_pResendLast = 0;
+		TimerUnlink(pResend);
+		m_pNetBase->ResendPool()->Free(pResend);
 	}
+
+	// the newest acked chunk gives the tightest round trip
+	if(SampleTime)
+		m_ConnStats.AddRttSample((int) ((time_get() - SampleTime) * 1000 / time_freq()));
 }
 
 void CNetConnection::SignalResend()
@@ -102,8 +177,18 @@ int CNetConnection::Flush()
 	m_Construct.m_Token = m_PeerToken;
 	m_pNetBase->SendPacket(&m_PeerAddr, &m_Construct);
 
-	// update send times
-	m_LastSendTime = time_get();
+	// update send times, the chunks of this packet count as sent now and
+	// not when they were queued, so the round trip leaves out the queue delay
+	const int64_t Now = time_get();
+	m_LastSendTime = Now;
+	for(CNetChunkResend *pResend = m_pTimerUnsent; pResend; pResend = pResend->m_pTimerNext)
+	{
+		// a resent chunk was sent before, it keeps its first send time
+		if(pResend->m_FirstSendTime == pResend->m_LastSendTime)
+			pResend->m_FirstSendTime = Now;
+		pResend->m_LastSendTime = Now;
+	}
+	m_pTimerUnsent = 0;
 
 	// clear construct so we can start building a new package
 	mem_zero(&m_Construct, sizeof(m_Construct));
@@ -137,7 +222,10 @@ int CNetConnection::QueueChunkEx(int Flags, int DataSize, const void *pData, int
 	if(Flags & NET_CHUNKFLAG_VITAL && !(Flags & NET_CHUNKFLAG_RESEND))
 	{
 		// save packet if we need to resend
-		CNetChunkResend *pResend = m_Buffer.Allocate(sizeof(CNetChunkResend) + DataSize);
+		const int AllocSize = CNetResendPool::AllocSize(sizeof(CNetChunkResend) + DataSize);
+		CNetChunkResend *pResend = 0;
+		if(m_ConnStats.m_BufferUsage + AllocSize <= ResendQuota())
+			pResend = (CNetChunkResend *) m_pNetBase->ResendPool()->Allocate(sizeof(CNetChunkResend) + DataSize);
 		if(pResend)
 		{
 			pResend->m_Sequence = Sequence;
@@ -146,7 +234,20 @@ int CNetConnection::QueueChunkEx(int Flags, int DataSize, const void *pData, int
 			pResend->m_pData = (unsigned char *) (pResend + 1);
 			pResend->m_FirstSendTime = time_get();
 			pResend->m_LastSendTime = pResend->m_FirstSendTime;
+			pResend->m_AllocSize = AllocSize;
 			mem_copy(pResend->m_pData, pData, DataSize);
+
+			pResend->m_pNext = 0;
+			if(m_pResendLast)
+				m_pResendLast->m_pNext = pResend;
+			else
+				m_pResendFirst = pResend;
+			m_pResendLast = pResend;
+			TimerLinkLast(pResend);
+
+			m_ConnStats.m_NumVitalSent++;
+			m_ConnStats.m_BufferUsage += AllocSize;
+			m_ConnStats.m_BufferPeak = maximum(m_ConnStats.m_BufferPeak, m_ConnStats.m_BufferUsage);
 		}
 		else
 		{
@@ -188,11 +289,14 @@ void CNetConnection::ResendChunk(CNetChunkResend *pResend)
 {
 	QueueChunkEx(pResend->m_Flags | NET_CHUNKFLAG_RESEND, pResend->m_DataSize, pResend->m_pData, pResend->m_Sequence);
 	pResend->m_LastSendTime = time_get();
+	TimerUnlink(pResend);
+	TimerLinkLast(pResend);
+	m_ConnStats.m_NumResends++;
 }
 
 void CNetConnection::Resend()
 {
-	for(CNetChunkResend *pResend = m_Buffer.First(); pResend; pResend = m_Buffer.Next(pResend))
+	for(CNetChunkResend *pResend = m_pResendFirst; pResend; pResend = pResend->m_pNext)
 		ResendChunk(pResend);
 }
 
@@ -259,7 +363,10 @@ int CNetConnection::Feed(CNetPacketConstruct *pPacket, NETADDR *pAddr)
 
 	// check if resend is requested
 	if(pPacket->m_Flags & NET_PACKETFLAG_RESEND)
+	{
+		m_ConnStats.m_NumResendRequests++;
 		Resend();
+	}
 
 	if(pPacket->m_Flags & NET_PACKETFLAG_CONNLESS)
 		return 1;
@@ -392,21 +499,24 @@ int CNetConnection::Update()
 	}
 
 	// fix resends
-	if(m_Buffer.First())
+	if(m_pResendFirst)
 	{
-		CNetChunkResend *pResend = m_Buffer.First();
-
 		// check if we have some really old stuff laying around and abort if not acked
-		if(Now - pResend->m_FirstSendTime > time_freq() * 10)
+		if(Now - m_pResendFirst->m_FirstSendTime > time_freq() * 10)
 		{
 			m_State = NET_CONNSTATE_ERROR;
 			SetError("Too weak connection (not acked for 10 seconds)");
 		}
 		else
 		{
-			// resend packet if we haven't got it acked in 1 second
-			if(Now - pResend->m_LastSendTime > time_freq())
-				ResendChunk(pResend);
+			// resend chunks we haven't got acked in 1 second, only the front of the timer list can be due.
+			// at most a packet's worth per update, so a lossy link doesn't get bursts
+			int Budget = NET_MAX_PAYLOAD;
+			while(m_pTimerFirst && Now - m_pTimerFirst->m_LastSendTime > time_freq() && Budget > 0)
+			{
+				Budget -= m_pTimerFirst->m_DataSize + NET_MAX_CHUNKHEADERSIZE;
+				ResendChunk(m_pTimerFirst);
+			}
 		}
 	}
 
@@ -0,0 +1,199 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <base/math.h>
+#include <base/system.h>
+
+#include "network.h"
+
+/*
+	every block starts with a pointer to its slab, the caller gets the memory behind it.
+	free blocks reuse that memory to link the slab's free list.
+*/
+enum
+{
+	NET_RESEND_BLOCKHEADER = 8,
+};
+
+CNetResendPool::CNetResendPool()
+{
+	mem_zero(m_apFirst, sizeof(m_apFirst));
+	mem_zero(m_apLast, sizeof(m_apLast));
+	mem_zero(m_aNumEmpty, sizeof(m_aNumEmpty));
+	mem_zero(&m_Stats, sizeof(m_Stats));
+}
+
+CNetResendPool::~CNetResendPool()
+{
+	Clear();
+}
+
+void CNetResendPool::Clear()
+{
+	for(int i = 0; i < NUM_SIZE_CLASSES; i++)
+	{
+		CSlab *pSlab = m_apFirst[i];
+		while(pSlab)
+		{
+			CSlab *pNext = pSlab->m_pNext;
+			mem_free(pSlab);
+			pSlab = pNext;
+		}
+		m_apFirst[i] = 0;
+		m_apLast[i] = 0;
+		m_aNumEmpty[i] = 0;
+	}
+	m_Stats.m_NumSlabs = 0;
+	m_Stats.m_NumBlocks = 0;
+	m_Stats.m_BytesInUse = 0;
+}
+
+int CNetResendPool::AllocSize(int Size)
+{
+	for(int i = 0; i < NUM_SIZE_CLASSES; i++)
+	{
+		if(Size + NET_RESEND_BLOCKHEADER <= BlockSize(i))
+			return BlockSize(i);
+	}
+	return -1;
+}
+
+void CNetResendPool::Unlink(CSlab *pSlab)
+{
+	if(pSlab->m_pPrev)
+		pSlab->m_pPrev->m_pNext = pSlab->m_pNext;
+	else
+		m_apFirst[pSlab->m_SizeClass] = pSlab->m_pNext;
+	if(pSlab->m_pNext)
+		pSlab->m_pNext->m_pPrev = pSlab->m_pPrev;
+	else
+		m_apLast[pSlab->m_SizeClass] = pSlab->m_pPrev;
+	pSlab->m_pPrev = 0;
+	pSlab->m_pNext = 0;
+}
+
+void CNetResendPool::LinkFirst(CSlab *pSlab)
+{
+	pSlab->m_pPrev = 0;
+	pSlab->m_pNext = m_apFirst[pSlab->m_SizeClass];
+	if(pSlab->m_pNext)
+		pSlab->m_pNext->m_pPrev = pSlab;
+	else
+		m_apLast[pSlab->m_SizeClass] = pSlab;
+	m_apFirst[pSlab->m_SizeClass] = pSlab;
+}
+
+void CNetResendPool::LinkLast(CSlab *pSlab)
+{
+	pSlab->m_pNext = 0;
+	pSlab->m_pPrev = m_apLast[pSlab->m_SizeClass];
+	if(pSlab->m_pPrev)
+		pSlab->m_pPrev->m_pNext = pSlab;
+	else
+		m_apFirst[pSlab->m_SizeClass] = pSlab;
+	m_apLast[pSlab->m_SizeClass] = pSlab;
+}
+
+CNetResendPool::CSlab *CNetResendPool::NewSlab(int SizeClass)
+{
+	CSlab *pSlab = (CSlab *) mem_alloc(SLAB_SIZE);
+	if(!pSlab)
+		return 0;
+
+	const int Size = BlockSize(SizeClass);
+	const int Offset = (sizeof(CSlab) + NET_RESEND_BLOCKHEADER - 1) / NET_RESEND_BLOCKHEADER * NET_RESEND_BLOCKHEADER;
+	pSlab->m_SizeClass = SizeClass;
+	pSlab->m_NumUsed = 0;
+	pSlab->m_NumBlocks = (SLAB_SIZE - Offset) / Size;
+	pSlab->m_pFree = 0;
+
+	// thread the free list back to front so blocks are handed out in address order
+	unsigned char *pBlocks = (unsigned char *) pSlab + Offset;
+	for(int i = pSlab->m_NumBlocks - 1; i >= 0; i--)
+	{
+		unsigned char *pBlock = pBlocks + i * Size;
+		*(CSlab **) pBlock = pSlab;
+		*(void **) (pBlock + NET_RESEND_BLOCKHEADER) = pSlab->m_pFree;
+		pSlab->m_pFree = pBlock + NET_RESEND_BLOCKHEADER;
+	}
+
+	LinkFirst(pSlab);
+	m_aNumEmpty[SizeClass]++;
+	m_Stats.m_NumSlabs++;
+	m_Stats.m_NumSlabsPeak = maximum(m_Stats.m_NumSlabsPeak, m_Stats.m_NumSlabs);
+	return pSlab;
+}
+
+void *CNetResendPool::Allocate(int Size)
+{
+	int SizeClass = 0;
+	while(SizeClass < NUM_SIZE_CLASSES && Size + NET_RESEND_BLOCKHEADER > BlockSize(SizeClass))
+		SizeClass++;
+	if(SizeClass == NUM_SIZE_CLASSES)
+		return 0;
+
+	CSlab *pSlab = m_apFirst[SizeClass];
+	if(!pSlab || !pSlab->m_pFree)
+	{
+		pSlab = NewSlab(SizeClass);
+		if(!pSlab)
+			return 0;
+	}
+
+	void *pData = pSlab->m_pFree;
+	pSlab->m_pFree = *(void **) pData;
+	if(pSlab->m_NumUsed++ == 0)
+		m_aNumEmpty[SizeClass]--;
+
+	// full slabs move behind the ones that can still hand out blocks
+	if(!pSlab->m_pFree)
+	{
+		Unlink(pSlab);
+		LinkLast(pSlab);
+	}
+
+	m_Stats.m_NumBlocks++;
+	m_Stats.m_BytesInUse += BlockSize(SizeClass);
+	return pData;
+}
+
+void CNetResendPool::Free(void *pData)
+{
+	if(!pData)
+		return;
+
+	CSlab *pSlab = *(CSlab **) ((unsigned char *) pData - NET_RESEND_BLOCKHEADER);
+	const int SizeClass = pSlab->m_SizeClass;
+	const bool WasFull = !pSlab->m_pFree;
+	*(void **) pData = pSlab->m_pFree;
+	pSlab->m_pFree = pData;
+	pSlab->m_NumUsed--;
+
+	m_Stats.m_NumBlocks--;
+	m_Stats.m_BytesInUse -= BlockSize(SizeClass);
+
+	if(pSlab->m_NumUsed == 0)
+	{
+		// give memory back once a size class has enough spare slabs
+		if(m_aNumEmpty[SizeClass] >= NUM_SPARE_SLABS)
+		{
+			Unlink(pSlab);
+			mem_free(pSlab);
+			m_Stats.m_NumSlabs--;
+			return;
+		}
+		m_aNumEmpty[SizeClass]++;
+	}
+
+	if(WasFull)
+	{
+		Unlink(pSlab);
+		LinkFirst(pSlab);
+	}
+}
@@ -13,6 +13,7 @@
 
 #include <engine/console.h>
 
+#include "config.h"
 #include "netban.h"
 #include "network.h"
 
@@ -39,7 +40,10 @@ bool CNetServer::Open(NETADDR BindAddr, CConfig *pConfig, IConsole *pConsole, IE
 	SetMaxClientsPerIP(MaxClientsPerIP);
 
 	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
 		m_aSlots[i].m_Connection.Init(this, true);
+		m_aSlots[i].m_FlushPending = false;
+	}
 
 	m_pfnNewClient = pfnNewClient;
 	m_pfnDelClient = pfnDelClient;
@@ -95,6 +99,19 @@ int CNetServer::Update()
 	return 0;
 }
 
+void CNetServer::FlushPending()
+{
+	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
+		if(!m_aSlots[i].m_FlushPending)
+			continue;
+
+		m_aSlots[i].m_FlushPending = false;
+		if(m_aSlots[i].m_Connection.State() != NET_CONNSTATE_OFFLINE)
+			m_aSlots[i].m_Connection.Flush();
+	}
+}
+
 TOKEN CNetServer::GetGlobalToken()
 {
 	return m_TokenManager.GetGlobalToken();
@@ -306,8 +323,16 @@ int CNetServer::Send(CNetChunk *pChunk, TOKEN Token)
 
 		if(m_aSlots[pChunk->m_ClientID].m_Connection.QueueChunk(Flags, pChunk->m_DataSize, pChunk->m_pData) == 0)
 		{
+			// the connection packs chunks until a packet is full, so deferring
+			// the flush lets everything sent this tick share as few packets as possible.
+			// vital sends that ask for a flush are urgent and go out right away
 			if(pChunk->m_Flags & NETSENDFLAG_FLUSH)
-				m_aSlots[pChunk->m_ClientID].m_Connection.Flush();
+			{
+				if(Config()->m_SvNetCoalesce && !(pChunk->m_Flags & NETSENDFLAG_VITAL))
+					m_aSlots[pChunk->m_ClientID].m_FlushPending = true;
+				else
+					m_aSlots[pChunk->m_ClientID].m_Connection.Flush();
+			}
 		}
 		else
 		{
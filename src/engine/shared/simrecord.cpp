@@ -0,0 +1,299 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <base/math.h>
+#include <base/system.h>
+
+#include "packer.h"
+#include "simrecord.h"
+
+static const char gs_aSimRecordMagic[8] = {'T', 'W', 'S', 'I', 'M', 'R', 'E', 'C'};
+
+enum
+{
+	SIMREC_HEADERSIZE = sizeof(gs_aSimRecordMagic) + 4,
+	SIMREC_RECORDHEADERSIZE = 1 + 2,
+};
+
+void CSimRecord::Reset(int Type, int ClientID)
+{
+	m_Type = Type;
+	m_ClientID = ClientID;
+	m_NumInts = 0;
+	m_aString[0] = 0;
+	m_DataSize = 0;
+}
+
+CSimRecorder::CSimRecorder()
+{
+	m_File = 0;
+	m_NumTicks = 0;
+}
+
+CSimRecorder::~CSimRecorder()
+{
+	Close();
+}
+
+bool CSimRecorder::Open(IOHANDLE File, unsigned Seed, const char *pBaseMap)
+{
+	Close();
+	if(!File)
+		return false;
+
+	unsigned char aHeader[SIMREC_HEADERSIZE];
+	mem_copy(aHeader, gs_aSimRecordMagic, sizeof(gs_aSimRecordMagic));
+	uint_to_bytes_be(&aHeader[sizeof(gs_aSimRecordMagic)], SIMREC_VERSION);
+	if(io_write(File, aHeader, sizeof(aHeader)) != sizeof(aHeader))
+	{
+		io_close(File);
+		return false;
+	}
+
+	m_File = File;
+	m_NumTicks = 0;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_INIT);
+	Record.m_aInts[Record.m_NumInts++] = (int) Seed;
+	str_copy(Record.m_aString, pBaseMap, sizeof(Record.m_aString));
+	WriteRecord(&Record);
+	return true;
+}
+
+void CSimRecorder::Close()
+{
+	if(!m_File)
+		return;
+
+	io_close(m_File);
+	m_File = 0;
+}
+
+void CSimRecorder::WriteRecord(const CSimRecord *pRecord)
+{
+	if(!m_File)
+		return;
+
+	CPacker Packer;
+	Packer.Reset();
+	Packer.AddInt(pRecord->m_ClientID);
+	Packer.AddInt(pRecord->m_NumInts);
+	for(int i = 0; i < pRecord->m_NumInts; i++)
+		Packer.AddInt(pRecord->m_aInts[i]);
+	Packer.AddString(pRecord->m_aString, sizeof(pRecord->m_aString));
+	Packer.AddInt(pRecord->m_DataSize);
+	if(pRecord->m_DataSize > 0)
+		Packer.AddRaw(pRecord->m_aData, pRecord->m_DataSize);
+	if(Packer.Error())
+		return;
+
+	unsigned char aHeader[SIMREC_RECORDHEADERSIZE];
+	aHeader[0] = pRecord->m_Type & 0xff;
+	aHeader[1] = (Packer.Size() >> 8) & 0xff;
+	aHeader[2] = Packer.Size() & 0xff;
+
+	io_write(m_File, aHeader, sizeof(aHeader));
+	io_write(m_File, Packer.Data(), Packer.Size());
+}
+
+void CSimRecorder::RecordTick(int Tick)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_TICK);
+	Record.m_aInts[Record.m_NumInts++] = Tick;
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordTickEnd(unsigned WorldHash)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_TICK_END);
+	Record.m_aInts[Record.m_NumInts++] = (int) WorldHash;
+	WriteRecord(&Record);
+	m_NumTicks++;
+}
+
+void CSimRecorder::RecordSnap(const int *pClientIDs, int Num)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_SNAP);
+	Record.m_NumInts = minimum(Num, (int) SIMREC_MAX_INTS);
+	mem_copy(Record.m_aInts, pClientIDs, Record.m_NumInts * sizeof(int));
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordConnect(int ClientID, bool AsSpec, int Version, int CarbonVersion, int DDNetVersion)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_CONNECT, ClientID);
+	Record.m_aInts[Record.m_NumInts++] = AsSpec;
+	Record.m_aInts[Record.m_NumInts++] = Version;
+	Record.m_aInts[Record.m_NumInts++] = CarbonVersion;
+	Record.m_aInts[Record.m_NumInts++] = DDNetVersion;
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordEnter(int ClientID)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_ENTER, ClientID);
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordDrop(int ClientID, const char *pReason)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_DROP, ClientID);
+	str_copy(Record.m_aString, pReason, sizeof(Record.m_aString));
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordInput(int Type, int ClientID, const int *pData, int Num)
+{
+	if(!m_File)
+		return;
+
+	// trailing zeros come back from the zeroed buffer of the replay
+	Num = minimum(Num, (int) SIMREC_MAX_INTS);
+	while(Num > 0 && pData[Num - 1] == 0)
+		Num--;
+
+	CSimRecord Record;
+	Record.Reset(Type, ClientID);
+	Record.m_NumInts = Num;
+	mem_copy(Record.m_aInts, pData, Num * sizeof(int));
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordMessage(int ClientID, const void *pData, int Size)
+{
+	if(!m_File || Size <= 0 || Size > NET_MAX_PAYLOAD)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_MESSAGE, ClientID);
+	Record.m_DataSize = Size;
+	mem_copy(Record.m_aData, pData, Size);
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordLoadWorld(const char *pMapName, unsigned ModeID)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_LOAD_WORLD);
+	Record.m_aInts[Record.m_NumInts++] = (int) ModeID;
+	str_copy(Record.m_aString, pMapName, sizeof(Record.m_aString));
+	WriteRecord(&Record);
+}
+
+void CSimRecorder::RecordSwitchWorld(int ClientID, const char *pMapName)
+{
+	if(!m_File)
+		return;
+
+	CSimRecord Record;
+	Record.Reset(SIMREC_SWITCH_WORLD, ClientID);
+	str_copy(Record.m_aString, pMapName, sizeof(Record.m_aString));
+	WriteRecord(&Record);
+}
+
+CSimRecordReader::CSimRecordReader()
+{
+	m_File = 0;
+}
+
+CSimRecordReader::~CSimRecordReader()
+{
+	Close();
+}
+
+bool CSimRecordReader::Open(IOHANDLE File)
+{
+	Close();
+	if(!File)
+		return false;
+
+	unsigned char aHeader[SIMREC_HEADERSIZE];
+	if(io_read(File, aHeader, sizeof(aHeader)) != sizeof(aHeader) ||
+		mem_comp(aHeader, gs_aSimRecordMagic, sizeof(gs_aSimRecordMagic)) != 0 ||
+		bytes_be_to_uint(&aHeader[sizeof(gs_aSimRecordMagic)]) != SIMREC_VERSION)
+	{
+		io_close(File);
+		return false;
+	}
+
+	m_File = File;
+	return true;
+}
+
+void CSimRecordReader::Close()
+{
+	if(!m_File)
+		return;
+
+	io_close(m_File);
+	m_File = 0;
+}
+
+bool CSimRecordReader::Read(CSimRecord *pRecord)
+{
+	if(!m_File)
+		return false;
+
+	unsigned char aHeader[SIMREC_RECORDHEADERSIZE];
+	if(io_read(m_File, aHeader, sizeof(aHeader)) != sizeof(aHeader))
+		return false;
+
+	const int Size = (aHeader[1] << 8) | aHeader[2];
+	unsigned char aData[CPacker::PACKER_BUFFER_SIZE];
+	if(aHeader[0] >= NUM_SIMRECS || Size > (int) sizeof(aData) || io_read(m_File, aData, Size) != (unsigned) Size)
+		return false;
+
+	CUnpacker Unpacker;
+	Unpacker.Reset(aData, Size);
+	pRecord->Reset(aHeader[0], Unpacker.GetInt());
+	pRecord->m_NumInts = Unpacker.GetInt();
+	if(pRecord->m_NumInts < 0 || pRecord->m_NumInts > SIMREC_MAX_INTS)
+		return false;
+	for(int i = 0; i < pRecord->m_NumInts; i++)
+		pRecord->m_aInts[i] = Unpacker.GetInt();
+	str_copy(pRecord->m_aString, Unpacker.GetString(0), sizeof(pRecord->m_aString));
+	pRecord->m_DataSize = Unpacker.GetInt();
+	if(pRecord->m_DataSize < 0 || pRecord->m_DataSize > NET_MAX_PAYLOAD)
+		return false;
+	if(pRecord->m_DataSize > 0)
+	{
+		const unsigned char *pData = Unpacker.GetRaw(pRecord->m_DataSize);
+		if(pData)
+			mem_copy(pRecord->m_aData, pData, pRecord->m_DataSize);
+	}
+	return !Unpacker.Error();
+}
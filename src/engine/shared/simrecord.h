@@ -0,0 +1,116 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef ENGINE_SHARED_SIMRECORD_H
+#define ENGINE_SHARED_SIMRECORD_H
+
+#include <base/system.h>
+
+#include "network.h"
+#include "protocol.h"
+
+/*
+	simulation record file:
+		header: 12 bytes
+			char magic[8];              // "TWSIMREC"
+			unsigned char version[4];   // 32bit big endian
+
+		record: 3 bytes + data
+			unsigned char type;         // SIMREC_*
+			unsigned char size[2];      // 16bit big endian
+			unsigned char data[size];   // packed: client id, int count, ints, string, raw size, raw
+
+	The first record is always SIMREC_INIT. Everything the engine hands
+	to the game server between two ticks follows in the order it happened,
+	a tick is framed by SIMREC_TICK and SIMREC_TICK_END.
+*/
+
+enum
+{
+	SIMREC_VERSION = 1,
+
+	SIMREC_INIT = 0, // ints: random seed, string: base map
+	SIMREC_TICK, // ints: tick
+	SIMREC_TICK_END, // ints: world hash after the tick
+	SIMREC_SNAP, // ints: snapping clients, -1 for the demo
+	SIMREC_CONNECT, // ints: as spectator, client version, carbon version, ddnet version
+	SIMREC_ENTER,
+	SIMREC_DROP, // string: reason
+	SIMREC_DIRECT_INPUT, // ints: input without trailing zeros
+	SIMREC_PREDICTED_INPUT, // ints: input without trailing zeros
+	SIMREC_MESSAGE, // raw: message chunk as received
+	SIMREC_LOAD_WORLD, // ints: mode id, string: map
+	SIMREC_SWITCH_WORLD, // string: map
+	NUM_SIMRECS,
+
+	SIMREC_MAX_INTS = MAX_INPUT_SIZE,
+	SIMREC_MAX_STRING = 128,
+};
+
+class CSimRecord
+{
+public:
+	int m_Type;
+	int m_ClientID;
+	int m_NumInts;
+	int m_aInts[SIMREC_MAX_INTS];
+	char m_aString[SIMREC_MAX_STRING];
+	int m_DataSize;
+	unsigned char m_aData[NET_MAX_PAYLOAD];
+
+	void Reset(int Type, int ClientID = -1);
+};
+
+class CSimRecorder
+{
+	IOHANDLE m_File;
+	int m_NumTicks;
+
+public:
+	CSimRecorder();
+	~CSimRecorder();
+
+	// writes the header and the init record
+	bool Open(IOHANDLE File, unsigned Seed, const char *pBaseMap);
+	void Close();
+	bool IsOpen() const { return m_File != 0; }
+	int NumTicks() const { return m_NumTicks; }
+
+	void WriteRecord(const CSimRecord *pRecord);
+
+	void RecordTick(int Tick);
+	void RecordTickEnd(unsigned WorldHash);
+	void RecordSnap(const int *pClientIDs, int Num);
+	void RecordConnect(int ClientID, bool AsSpec, int Version, int CarbonVersion, int DDNetVersion);
+	void RecordEnter(int ClientID);
+	void RecordDrop(int ClientID, const char *pReason);
+	// Type is SIMREC_DIRECT_INPUT or SIMREC_PREDICTED_INPUT
+	void RecordInput(int Type, int ClientID, const int *pData, int Num);
+	void RecordMessage(int ClientID, const void *pData, int Size);
+	void RecordLoadWorld(const char *pMapName, unsigned ModeID);
+	void RecordSwitchWorld(int ClientID, const char *pMapName);
+};
+
+class CSimRecordReader
+{
+	IOHANDLE m_File;
+
+public:
+	CSimRecordReader();
+	~CSimRecordReader();
+
+	bool Open(IOHANDLE File);
+	void Close();
+	bool IsOpen() const { return m_File != 0; }
+
+	// returns false at the end of the record or on a truncated or broken record
+	bool Read(CSimRecord *pRecord);
+};
+
+#endif
@@ -1578,6 +1578,9 @@ void CGameClient::OnPredict()
 		m_aClients[i].m_Predicted.Read(&m_Snap.m_aCharacters[i].m_Cur);
 	}
 
+	CCharacterCoreBatch Batch;
+	Batch.Init(&World);
+
 	// predict
 	for(int Tick = Client()->GameTick() + 1;
 		Tick <= Client()->PredGameTick();
@@ -1604,12 +1607,12 @@ void CGameClient::OnPredict()
 				if(pInput)
 					World.m_apCharacters[c]->m_Input = *((const CNetObj_PlayerInput *) pInput);
 
-				World.m_apCharacters[c]->Tick(true);
+				Batch.TickCore(c, true);
 			}
 			else
 			{
 				// don't apply inputs for non-local players
-				World.m_apCharacters[c]->Tick(false);
+				Batch.TickCore(c, false);
 			}
 		}
 
@@ -1619,10 +1622,7 @@ void CGameClient::OnPredict()
 			if(!World.m_apCharacters[c])
 				continue;
 
-			World.m_apCharacters[c]->AddDragVelocity();
-			World.m_apCharacters[c]->ResetDragVelocity();
-			World.m_apCharacters[c]->Move();
-			World.m_apCharacters[c]->Quantize();
+			Batch.MoveCore(c);
 		}
 
 		// check if we want to trigger effects
@@ -24,8 +24,12 @@
 CCollision::CCollision()
 {
 	m_pTiles = 0;
+	m_pSolidDistance = 0;
+	m_pPlanes = 0;
+	m_RowWords = 0;
 	m_Width = 0;
 	m_Height = 0;
+	m_SweptMoveBox = false;
 	m_pLayers = 0;
 }
 
@@ -33,15 +37,25 @@ CCollision::~CCollision()
 {
 	if(m_pTiles)
 		mem_free(m_pTiles);
+	if(m_pSolidDistance)
+		mem_free(m_pSolidDistance);
+	if(m_pPlanes)
+		mem_free(m_pPlanes);
 }
 
 void CCollision::Init(class CLayers *pLayers)
 {
 	m_pLayers = pLayers;
-	m_Width = m_pLayers->GameLayer()->m_Width;
-	m_Height = m_pLayers->GameLayer()->m_Height;
+	Init(static_cast<CTile *>(m_pLayers->Map()->GetData(m_pLayers->GameLayer()->m_Data)), m_pLayers->GameLayer()->m_Width, m_pLayers->GameLayer()->m_Height);
+}
+
+void CCollision::Init(const CTile *pTiles, int Width, int Height)
+{
+	if(m_pTiles)
+		mem_free(m_pTiles);
+	m_Width = Width;
+	m_Height = Height;
 	m_pTiles = static_cast<int *>(mem_alloc(sizeof(int) * m_Width * m_Height));
-	CTile *pTiles = static_cast<CTile *>(m_pLayers->Map()->GetData(m_pLayers->GameLayer()->m_Data));
 
 	for(int i = 0; i < m_Width * m_Height; i++)
 	{
@@ -62,14 +76,117 @@ void CCollision::Init(class CLayers *pLayers)
 			m_pTiles[i] = 0;
 		}
 	}
+
+	BuildSolidDistance();
+	BuildPlanes();
 }
 
-int CCollision::GetTile(int x, int y) const
+void CCollision::BuildPlanes()
+{
+	if(m_pPlanes)
+		mem_free(m_pPlanes);
+	m_RowWords = (m_Width + 63) / 64;
+	const int Size = sizeof(uint64_t) * NUM_PLANES * m_RowWords * m_Height;
+	m_pPlanes = static_cast<uint64_t *>(mem_alloc(Size));
+	mem_zero(m_pPlanes, Size);
+
+	for(int i = 0; i < m_Width * m_Height; i++)
+		SetPlaneBits(i, m_pTiles[i]);
+}
+
+void CCollision::SetPlaneBits(int Index, int Flags)
+{
+	const int x = Index % m_Width;
+	const int y = Index / m_Width;
+	const uint64_t Bit = (uint64_t) 1 << (x & 63);
+	uint64_t *pSolid = &m_pPlanes[(PLANE_SOLID * m_Height + y) * m_RowWords + x / 64];
+	uint64_t *pDeath = &m_pPlanes[(PLANE_DEATH * m_Height + y) * m_RowWords + x / 64];
+	*pSolid = (Flags & COLFLAG_SOLID) ? (*pSolid | Bit) : (*pSolid & ~Bit);
+	*pDeath = (Flags & COLFLAG_DEATH) ? (*pDeath | Bit) : (*pDeath & ~Bit);
+}
+
+bool CCollision::TestPlane(int Plane, int x0, int y0, int x1, int y1) const
+{
+	x0 = clamp(x0, 0, m_Width - 1);
+	x1 = clamp(x1, 0, m_Width - 1);
+	y0 = clamp(y0, 0, m_Height - 1);
+	y1 = clamp(y1, 0, m_Height - 1);
+
+	const int Word0 = x0 / 64;
+	const int Word1 = x1 / 64;
+	const uint64_t Mask0 = ~(uint64_t) 0 << (x0 & 63);
+	const uint64_t Mask1 = ~(uint64_t) 0 >> (63 - (x1 & 63));
+	for(int y = y0; y <= y1; y++)
+	{
+		const uint64_t *pRow = &m_pPlanes[(Plane * m_Height + y) * m_RowWords];
+		if(Word0 == Word1)
+		{
+			if(pRow[Word0] & Mask0 & Mask1)
+				return true;
+			continue;
+		}
+		if((pRow[Word0] & Mask0) || (pRow[Word1] & Mask1))
+			return true;
+		for(int w = Word0 + 1; w < Word1; w++)
+			if(pRow[w])
+				return true;
+	}
+	return false;
+}
+
+void CCollision::BuildSolidDistance()
+{
+	if(m_pSolidDistance)
+		mem_free(m_pSolidDistance);
+	m_pSolidDistance = static_cast<unsigned char *>(mem_alloc(m_Width * m_Height));
+
+	for(int i = 0; i < m_Width * m_Height; i++)
+		m_pSolidDistance[i] = (m_pTiles[i] & COLFLAG_SOLID) ? 0 : 255;
+
+	// two pass chamfer, exact for the chebyshev metric
+	for(int y = 0; y < m_Height; y++)
+	{
+		for(int x = 0; x < m_Width; x++)
+		{
+			int Dist = m_pSolidDistance[y * m_Width + x];
+			if(x > 0)
+				Dist = minimum(Dist, m_pSolidDistance[y * m_Width + x - 1] + 1);
+			if(y > 0)
+			{
+				for(int Nx = maximum(x - 1, 0); Nx <= minimum(x + 1, m_Width - 1); Nx++)
+					Dist = minimum(Dist, m_pSolidDistance[(y - 1) * m_Width + Nx] + 1);
+			}
+			m_pSolidDistance[y * m_Width + x] = minimum(Dist, 255);
+		}
+	}
+	for(int y = m_Height - 1; y >= 0; y--)
+	{
+		for(int x = m_Width - 1; x >= 0; x--)
+		{
+			int Dist = m_pSolidDistance[y * m_Width + x];
+			if(x < m_Width - 1)
+				Dist = minimum(Dist, m_pSolidDistance[y * m_Width + x + 1] + 1);
+			if(y < m_Height - 1)
+			{
+				for(int Nx = maximum(x - 1, 0); Nx <= minimum(x + 1, m_Width - 1); Nx++)
+					Dist = minimum(Dist, m_pSolidDistance[(y + 1) * m_Width + Nx] + 1);
+			}
+			m_pSolidDistance[y * m_Width + x] = minimum(Dist, 255);
+		}
+	}
+}
+
+int CCollision::GetTileIndex(int x, int y) const
 {
 	int Nx = clamp(x / 32, 0, m_Width - 1);
 	int Ny = clamp(y / 32, 0, m_Height - 1);
 
-	return m_pTiles[Ny * m_Width + Nx];
+	return Ny * m_Width + Nx;
+}
+
+int CCollision::GetTile(int x, int y) const
+{
+	return m_pTiles[GetTileIndex(x, y)];
 }
 
 bool CCollision::IsTile(int x, int y, int Flag) const
@@ -77,25 +194,42 @@ bool CCollision::IsTile(int x, int y, int Flag) const
 	return GetTile(x, y) & Flag;
 }
 
-// TODO: rewrite this smarter!
+/*
+	Walks the same samples as checking every pixel of the line would, one
+	per pixel of length. Samples inside free space are skipped: with the
+	closest solid tile Dist tiles away, the rounded sample positions can
+	move 32 * (Dist - 1) pixels without reaching it. Every sample is
+	computed from its index, so the skipped ones don't change the results.
+*/
 int CCollision::IntersectLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision) const
 {
 	const int End = distance(Pos0, Pos1) + 1;
 	const float InverseEnd = 1.0f / End;
-	vec2 Last = Pos0;
+	// largest distance per sample on one axis
+	const float Step = maximum(absolute(Pos1.x - Pos0.x), absolute(Pos1.y - Pos0.y)) * InverseEnd;
 
-	for(int i = 0; i <= End; i++)
+	for(int i = 0; i <= End;)
 	{
 		vec2 Pos = mix(Pos0, Pos1, i * InverseEnd);
-		if(CheckPoint(Pos.x, Pos.y))
+		const int Index = GetTileIndex(round_to_int(Pos.x), round_to_int(Pos.y));
+		const int Dist = m_pSolidDistance[Index];
+		if(Dist == 0)
 		{
 			if(pOutCollision)
 				*pOutCollision = Pos;
 			if(pOutBeforeCollision)
-				*pOutBeforeCollision = Last;
-			return GetCollisionAt(Pos.x, Pos.y);
+				*pOutBeforeCollision = i > 0 ? mix(Pos0, Pos1, (i - 1) * InverseEnd) : Pos0;
+			return m_pTiles[Index];
 		}
-		Last = Pos;
+
+		// two pixels of margin for the rounding of both samples
+		const float Reach = 32.0f * (Dist - 1) - 2.0f;
+		if(Reach < Step)
+			i++;
+		else if(Reach >= Step * (End - i + 1))
+			break;
+		else
+			i += (int) (Reach / Step);
 	}
 	if(pOutCollision)
 		*pOutCollision = Pos1;
@@ -184,13 +318,24 @@ int CCollision::TestBoxMoveAt(vec2 LastPos, vec2 NewPos, vec2 Size) const
 
 void CCollision::SetFlagFor(float x, float y, int Flag)
 {
-	int Nx = clamp(round_to_int(x) / 32, 0, m_Width - 1);
-	int Ny = clamp(round_to_int(y) / 32, 0, m_Height - 1);
+	const int Index = GetTileIndex(round_to_int(x), round_to_int(y));
+	const bool Rebuild = (m_pTiles[Index] ^ Flag) & COLFLAG_SOLID;
 
-	m_pTiles[Ny * m_Width + Nx] = Flag;
+	m_pTiles[Index] = Flag;
+	SetPlaneBits(Index, Flag);
+	if(Rebuild)
+		BuildSolidDistance();
 }
 
 void CCollision::MoveBox(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath) const
+{
+	if(m_SweptMoveBox)
+		MoveBoxSwept(pInoutPos, pInoutVel, Size, Elasticity, pDeath);
+	else
+		MoveBoxExact(pInoutPos, pInoutVel, Size, Elasticity, pDeath);
+}
+
+void CCollision::MoveBoxExact(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath) const
 {
 	// do the move
 	vec2 Pos = *pInoutPos;
@@ -205,6 +350,21 @@ void CCollision::MoveBox(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elas
 	if(Distance > 0.00001f)
 	{
 		const float Fraction = 1.0f / (Max + 1);
+
+		// nothing solid or deadly anywhere around the path, the steps can't hit anything
+		const vec2 Reach = Size * 0.5f + vec2(2.0f, 2.0f);
+		const int x0 = round_to_int(minimum(Pos.x, Pos.x + Vel.x) - Reach.x) / 32;
+		const int x1 = round_to_int(maximum(Pos.x, Pos.x + Vel.x) + Reach.x) / 32;
+		const int y0 = round_to_int(minimum(Pos.y, Pos.y + Vel.y) - Reach.y) / 32;
+		const int y1 = round_to_int(maximum(Pos.y, Pos.y + Vel.y) + Reach.y) / 32;
+		if(!TestPlane(PLANE_SOLID, x0, y0, x1, y1) && (!pDeath || !TestPlane(PLANE_DEATH, x0, y0, x1, y1)))
+		{
+			for(int i = 0; i <= Max; i++)
+				Pos = Pos + Vel * Fraction;
+			*pInoutPos = Pos;
+			return;
+		}
+
 		for(int i = 0; i <= Max; i++)
 		{
 			vec2 NewPos = Pos + Vel * Fraction; // TODO: this row is not nice
@@ -252,3 +412,169 @@ void CCollision::MoveBox(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elas
 	*pInoutPos = Pos;
 	*pInoutVel = Vel;
 }
+
+/*
+	Swept boxes cover the tiles they overlap by more than SWEEP_EPSILON,
+	a box exactly on a tile edge only touches the tile. Moving tracks the
+	covered tile range on both axes and checks every column or row the
+	leading edge enters, in the order of entering.
+*/
+static const float SWEEP_EPSILON = 1.0f / 32.0f;
+
+static int SweepTileFloor(float Pixel) { return (int) floorf(Pixel / 32.0f); }
+static float &Component(vec2 &Vector, int Axis) { return Axis == 0 ? Vector.x : Vector.y; }
+
+bool CCollision::TestPlaneBox(int Plane, vec2 Pos, vec2 Half) const
+{
+	return TestPlane(Plane,
+		SweepTileFloor(Pos.x - Half.x + SWEEP_EPSILON), SweepTileFloor(Pos.y - Half.y + SWEEP_EPSILON),
+		SweepTileFloor(Pos.x + Half.x - SWEEP_EPSILON), SweepTileFloor(Pos.y + Half.y - SWEEP_EPSILON));
+}
+
+// returns the fraction of Delta that can be moved, 1 if nothing is hit
+float CCollision::SweepBox(vec2 Pos, vec2 Delta, vec2 Half, int *pHitAxis, float *pHitEdge) const
+{
+	struct SAxis
+	{
+		float m_Pos;
+		float m_Half;
+		float m_Delta;
+		int m_Lo;
+		int m_Hi;
+
+		// time the leading edge enters the next tile, or the trailing edge leaves its last one
+		float LeadTime() const
+		{
+			if(m_Delta > 0.0f)
+				return (32.0f * (m_Hi + 1) - (m_Pos + m_Half)) / m_Delta;
+			if(m_Delta < 0.0f)
+				return ((m_Pos - m_Half) - 32.0f * m_Lo) / -m_Delta;
+			return 2.0f;
+		}
+		float TrailTime() const
+		{
+			if(m_Delta > 0.0f)
+				return (32.0f * (m_Lo + 1) - (m_Pos - m_Half)) / m_Delta;
+			if(m_Delta < 0.0f)
+				return ((m_Pos + m_Half) - 32.0f * m_Hi) / -m_Delta;
+			return 2.0f;
+		}
+		int LeadTile() const { return m_Delta > 0.0f ? m_Hi + 1 : m_Lo - 1; }
+	};
+
+	SAxis aAxes[2];
+	for(int a = 0; a < 2; a++)
+	{
+		aAxes[a].m_Pos = Component(Pos, a);
+		aAxes[a].m_Half = Component(Half, a);
+		aAxes[a].m_Delta = Component(Delta, a);
+		aAxes[a].m_Lo = SweepTileFloor(Component(Pos, a) - Component(Half, a) + SWEEP_EPSILON);
+		aAxes[a].m_Hi = SweepTileFloor(Component(Pos, a) + Component(Half, a) - SWEEP_EPSILON);
+	}
+
+	*pHitAxis = -1;
+	while(true)
+	{
+		// leaving tiles goes first on ties, then x before y
+		int Axis = -1;
+		bool Lead = false;
+		float Time = 1.0f;
+		for(int a = 0; a < 2; a++)
+		{
+			if(aAxes[a].m_Lo < aAxes[a].m_Hi && aAxes[a].TrailTime() <= Time && (Axis == -1 || aAxes[a].TrailTime() < Time))
+			{
+				Axis = a;
+				Lead = false;
+				Time = aAxes[a].TrailTime();
+			}
+		}
+		for(int a = 0; a < 2; a++)
+		{
+			if(aAxes[a].LeadTime() <= Time && (Axis == -1 || aAxes[a].LeadTime() < Time))
+			{
+				Axis = a;
+				Lead = true;
+				Time = aAxes[a].LeadTime();
+			}
+		}
+		if(Axis == -1)
+			return 1.0f;
+
+		SAxis &Moving = aAxes[Axis];
+		if(!Lead)
+		{
+			if(Moving.m_Delta > 0.0f)
+				Moving.m_Lo++;
+			else
+				Moving.m_Hi--;
+			continue;
+		}
+
+		const SAxis &Other = aAxes[1 - Axis];
+		const int Tile = Moving.LeadTile();
+		const bool Hit = Axis == 0 ? TestPlane(PLANE_SOLID, Tile, Other.m_Lo, Tile, Other.m_Hi) : TestPlane(PLANE_SOLID, Other.m_Lo, Tile, Other.m_Hi, Tile);
+		if(Hit)
+		{
+			*pHitAxis = Axis;
+			*pHitEdge = Moving.m_Delta > 0.0f ? 32.0f * Tile - Moving.m_Half : 32.0f * (Tile + 1) + Moving.m_Half;
+			return maximum(Time, 0.0f);
+		}
+		if(Moving.m_Delta > 0.0f)
+			Moving.m_Hi = Tile;
+		else
+			Moving.m_Lo = Tile;
+	}
+}
+
+void CCollision::MoveBoxSwept(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath) const
+{
+	vec2 Pos = *pInoutPos;
+	vec2 Vel = *pInoutVel;
+	const vec2 Half = Size * 0.5f;
+	// deathtiles are a bit smaller
+	const vec2 DeathHalf = Half * (2.0f / 3.0f);
+
+	if(pDeath)
+		*pDeath = false;
+
+	// nothing to run into around the path
+	const vec2 Center = Pos + Vel * 0.5f;
+	const vec2 Extent = Half + vec2(absolute(Vel.x), absolute(Vel.y)) * 0.5f;
+	if(!TestPlaneBox(PLANE_SOLID, Center, Extent) && (!pDeath || !TestPlaneBox(PLANE_DEATH, Center, Extent)))
+	{
+		*pInoutPos = Pos + Vel;
+		return;
+	}
+
+	float Time = 0.0f;
+	for(int Segment = 0; Segment < MAX_SWEEP_SEGMENTS && Time < 1.0f; Segment++)
+	{
+		const vec2 Delta = Vel * (1.0f - Time);
+		if(length(Delta) <= 0.00001f)
+			break;
+
+		int HitAxis;
+		float HitEdge;
+		const float HitTime = SweepBox(Pos, Delta, Half, &HitAxis, &HitEdge);
+		vec2 NewPos = Pos + Delta * HitTime;
+		if(HitAxis != -1)
+			Component(NewPos, HitAxis) = HitEdge;
+
+		if(pDeath && !*pDeath)
+		{
+			// steps of half the box cover the whole path
+			const int Steps = (int) (maximum(absolute(NewPos.x - Pos.x) / DeathHalf.x, absolute(NewPos.y - Pos.y) / DeathHalf.y)) + 1;
+			for(int i = 1; i <= Steps && !*pDeath; i++)
+				*pDeath = TestPlaneBox(PLANE_DEATH, mix(Pos, NewPos, (float) i / Steps), DeathHalf);
+		}
+
+		Pos = NewPos;
+		if(HitAxis == -1)
+			break;
+		Component(Vel, HitAxis) *= -Elasticity;
+		Time += (1.0f - Time) * HitTime;
+	}
+
+	*pInoutPos = Pos;
+	*pInoutVel = Vel;
+}
@@ -13,15 +13,43 @@
 
 #include <base/vmath.h>
 
+#include <cstdint>
+
 class CCollision
 {
+	enum
+	{
+		PLANE_SOLID = 0,
+		PLANE_DEATH,
+		NUM_PLANES,
+
+		MAX_SWEEP_SEGMENTS = 4,
+	};
+
 	int *m_pTiles;
+	// chebyshev distance in tiles to the closest solid tile, capped at 255
+	unsigned char *m_pSolidDistance;
+	// one bit per tile and plane, every row padded to whole words
+	uint64_t *m_pPlanes;
+	int m_RowWords;
 	int m_Width;
 	int m_Height;
+	bool m_SweptMoveBox;
 	class CLayers *m_pLayers;
 
 	bool IsTile(int x, int y, int Flag = COLFLAG_SOLID) const;
 	int GetTile(int x, int y) const;
+	int GetTileIndex(int x, int y) const;
+	void BuildSolidDistance();
+	void BuildPlanes();
+	void SetPlaneBits(int Index, int Flags);
+	// any bit of the plane set within the tile rectangle, coordinates are clamped to the map
+	bool TestPlane(int Plane, int x0, int y0, int x1, int y1) const;
+	bool TestPlaneBox(int Plane, vec2 Pos, vec2 Half) const;
+
+	void MoveBoxExact(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath) const;
+	void MoveBoxSwept(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath) const;
+	float SweepBox(vec2 Pos, vec2 Delta, vec2 Half, int *pHitAxis, float *pHitEdge) const;
 
 public:
 	enum
@@ -34,6 +62,8 @@ public:
 	CCollision();
 	~CCollision();
 	void Init(class CLayers *pLayers);
+	// builds the collision from a plain game layer, for tools and tests without a map
+	void Init(const struct CTile *pTiles, int Width, int Height);
 	bool CheckPoint(float x, float y, int Flag = COLFLAG_SOLID) const { return IsTile(round_to_int(x), round_to_int(y), Flag); }
 	bool CheckPoint(vec2 Pos, int Flag = COLFLAG_SOLID) const { return CheckPoint(Pos.x, Pos.y, Flag); }
 	int GetCollisionAt(float x, float y) const { return GetTile(round_to_int(x), round_to_int(y)); }
@@ -42,6 +72,9 @@ public:
 	int IntersectLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision) const;
 	void MovePoint(vec2 *pInoutPos, vec2 *pInoutVel, float Elasticity, int *pBounces) const;
 	void MoveBox(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath = 0) const;
+	// swept boxes stop exactly at tile edges, but don't match the prediction of unmodified clients
+	void SetSweptMoveBox(bool Swept) { m_SweptMoveBox = Swept; }
+	bool SweptMoveBox() const { return m_SweptMoveBox; }
 	int TestBoxAt(vec2 Pos, vec2 Size) const;
 	bool TestBox(vec2 Pos, vec2 Size, int Flag = COLFLAG_SOLID) const;
 	int TestBoxMoveAt(vec2 LastPos, vec2 NewPos, vec2 Size) const;
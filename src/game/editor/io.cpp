@@ -13,6 +13,7 @@
 #include <engine/serverbrowser.h>
 #include <engine/storage.h>
 #include <game/gamecore.h> // StrToInts, IntsToStr
+#include <game/layers.h>
 #include "editor.h"
 
 template<typename T>
@@ -173,6 +174,10 @@ int CEditorMap::Save(class IStorage *pStorage, const char *pFileName)
 
 				df.AddItem(MAPITEMTYPE_LAYER, LayerCount, sizeof(Item), &Item);
 
+				// lets the server place entities without scanning the whole game layer
+				if(pLayer->m_Game)
+					CLayers::AddEntityIndex(&df, pLayer->m_pTiles, pLayer->m_Width, pLayer->m_Height, Item.m_Data);
+
 				GItem.m_NumLayers++;
 				LayerCount++;
 			}
@@ -94,6 +94,11 @@ void CCharacterCore::Reset()
 }
 
 void CCharacterCore::Tick(bool UseInput)
+{
+	TickImpl(UseInput, nullptr, -1);
+}
+
+void CCharacterCore::TickImpl(bool UseInput, CCharacterCoreBatch *pBatch, int Self)
 {
 	m_TriggeredEvents = 0;
 
@@ -210,7 +215,32 @@ void CCharacterCore::Tick(bool UseInput)
 		}
 
 		// Check against other players first
-		if(m_pWorld && m_pWorld->m_Tuning.m_PlayerHooking)
+		if(m_pWorld && m_pWorld->m_Tuning.m_PlayerHooking && pBatch)
+		{
+			// flat pass over all positions, then the hits in client order
+			for(int k = 0; k < pBatch->m_NumCores; k++)
+			{
+				const vec2 Pos = vec2(pBatch->m_aPosX[k], pBatch->m_aPosY[k]);
+				pBatch->m_aDistances[k] = distance(Pos, closest_point_on_line(m_HookPos, NewPos, Pos));
+			}
+
+			float Distance = 0.0f;
+			for(int k = 0; k < pBatch->m_NumCores; k++)
+			{
+				if(k == Self || !(pBatch->m_aDistances[k] < PHYS_SIZE + 2.0f))
+					continue;
+
+				const vec2 Pos = vec2(pBatch->m_aPosX[k], pBatch->m_aPosY[k]);
+				if(m_HookedPlayer == -1 || distance(m_HookPos, Pos) < Distance)
+				{
+					m_TriggeredEvents |= COREEVENTFLAG_HOOK_ATTACH_PLAYER;
+					m_HookState = HOOK_GRABBED;
+					m_HookedPlayer = pBatch->m_aClientIDs[k];
+					Distance = distance(m_HookPos, Pos);
+				}
+			}
+		}
+		else if(m_pWorld && m_pWorld->m_Tuning.m_PlayerHooking)
 		{
 			float Distance = 0.0f;
 			for(int i = 0; i < MAX_CLIENTS; i++)
@@ -304,7 +334,24 @@ void CCharacterCore::Tick(bool UseInput)
 		}
 	}
 
-	if(m_pWorld)
+	if(m_pWorld && pBatch)
+	{
+		for(int k = 0; k < pBatch->m_NumCores; k++)
+			pBatch->m_aDistances[k] = distance(m_Pos, vec2(pBatch->m_aPosX[k], pBatch->m_aPosY[k]));
+
+		// only the characters close enough to collide or the hooked one do anything
+		for(int k = 0; k < pBatch->m_NumCores; k++)
+		{
+			if(k == Self)
+				continue;
+
+			const int i = pBatch->m_aClientIDs[k];
+			const float Distance = pBatch->m_aDistances[k];
+			if((m_pWorld->m_Tuning.m_PlayerCollision && Distance < PHYS_SIZE * 1.25f && Distance > 0.0f) || m_HookedPlayer == i)
+				InteractWith(m_pWorld->m_apCharacters[i], i, Distance);
+		}
+	}
+	else if(m_pWorld)
 	{
 		for(int i = 0; i < MAX_CLIENTS; i++)
 		{
@@ -316,43 +363,47 @@ void CCharacterCore::Tick(bool UseInput)
 			if(pCharCore == this) // || !(p->flags&FLAG_ALIVE)
 				continue; // make sure that we don't nudge our self
 
-			// handle player <-> player collision
-			float Distance = distance(m_Pos, pCharCore->m_Pos);
-			vec2 Dir = normalize(m_Pos - pCharCore->m_Pos);
-			if(m_pWorld->m_Tuning.m_PlayerCollision && Distance < PHYS_SIZE * 1.25f && Distance > 0.0f)
-			{
-				float a = (PHYS_SIZE * 1.45f - Distance);
-				float Velocity = 0.5f;
+			InteractWith(pCharCore, i, distance(m_Pos, pCharCore->m_Pos));
+		}
+	}
 
-				// make sure that we don't add excess force by checking the
-				// direction against the current velocity. if not zero.
-				if(length(m_Vel) > 0.0001)
-					Velocity = 1 - (dot(normalize(m_Vel), Dir) + 1) / 2;
+	// clamp the velocity to something sane
+	if(length(m_Vel) > 6000)
+		m_Vel = normalize(m_Vel) * 6000;
+}
 
-				m_Vel += Dir * a * (Velocity * 0.75f);
-				m_Vel *= 0.85f;
-			}
+void CCharacterCore::InteractWith(CCharacterCore *pCharCore, int ClientID, float Distance)
+{
+	// handle player <-> player collision
+	vec2 Dir = normalize(m_Pos - pCharCore->m_Pos);
+	if(m_pWorld->m_Tuning.m_PlayerCollision && Distance < PHYS_SIZE * 1.25f && Distance > 0.0f)
+	{
+		float a = (PHYS_SIZE * 1.45f - Distance);
+		float Velocity = 0.5f;
 
-			// handle hook influence
-			if(m_HookedPlayer == i && m_pWorld->m_Tuning.m_PlayerHooking)
-			{
-				if(Distance > PHYS_SIZE * 1.50f) // TODO: fix tweakable variable
-				{
-					float Accel = m_pWorld->m_Tuning.m_HookDragAccel * (Distance / m_pWorld->m_Tuning.m_HookLength);
+		// make sure that we don't add excess force by checking the
+		// direction against the current velocity. if not zero.
+		if(length(m_Vel) > 0.0001)
+			Velocity = 1 - (dot(normalize(m_Vel), Dir) + 1) / 2;
+
+		m_Vel += Dir * a * (Velocity * 0.75f);
+		m_Vel *= 0.85f;
+	}
 
-					// add force to the hooked player
-					pCharCore->m_HookDragVel += Dir * Accel * 1.5f;
+	// handle hook influence
+	if(m_HookedPlayer == ClientID && m_pWorld->m_Tuning.m_PlayerHooking)
+	{
+		if(Distance > PHYS_SIZE * 1.50f) // TODO: fix tweakable variable
+		{
+			float Accel = m_pWorld->m_Tuning.m_HookDragAccel * (Distance / m_pWorld->m_Tuning.m_HookLength);
 
-					// add a little bit force to the guy who has the grip
-					m_HookDragVel -= Dir * Accel * 0.25f;
-				}
-			}
+			// add force to the hooked player
+			pCharCore->m_HookDragVel += Dir * Accel * 1.5f;
+
+			// add a little bit force to the guy who has the grip
+			m_HookDragVel -= Dir * Accel * 0.25f;
 		}
 	}
-
-	// clamp the velocity to something sane
-	if(length(m_Vel) > 6000)
-		m_Vel = normalize(m_Vel) * 6000;
 }
 
 void CCharacterCore::AddDragVelocity()
@@ -370,6 +421,11 @@ void CCharacterCore::ResetDragVelocity()
 }
 
 void CCharacterCore::Move()
+{
+	MoveImpl(nullptr, -1);
+}
+
+void CCharacterCore::MoveImpl(CCharacterCoreBatch *pBatch, int Self)
 {
 	if(!m_pWorld)
 		return;
@@ -388,16 +444,34 @@ void CCharacterCore::Move()
 		// check player collision
 		float Distance = distance(m_Pos, NewPos);
 		int End = Distance + 1;
+
+		// the characters which can touch the path at all, the margin covers rounding
+		CCharacterCore *apNear[MAX_CLIENTS];
+		int NumNear = 0;
+		if(pBatch)
+		{
+			const float Reach = Distance + PHYS_SIZE + 1.0f;
+			for(int k = 0; k < pBatch->m_NumCores; k++)
+				pBatch->m_aDistances[k] = distance(m_Pos, vec2(pBatch->m_aPosX[k], pBatch->m_aPosY[k]));
+			for(int k = 0; k < pBatch->m_NumCores; k++)
+				if(k != Self && pBatch->m_aDistances[k] < Reach)
+					apNear[NumNear++] = m_pWorld->m_apCharacters[pBatch->m_aClientIDs[k]];
+		}
+		else
+		{
+			for(int p = 0; p < MAX_CLIENTS; p++)
+				if(m_pWorld->m_apCharacters[p] && m_pWorld->m_apCharacters[p] != this)
+					apNear[NumNear++] = m_pWorld->m_apCharacters[p];
+		}
+
 		vec2 LastPos = m_Pos;
 		for(int i = 0; i < End; i++)
 		{
 			float a = i / Distance;
 			vec2 Pos = mix(m_Pos, NewPos, a);
-			for(int p = 0; p < MAX_CLIENTS; p++)
+			for(int p = 0; p < NumNear; p++)
 			{
-				CCharacterCore *pCharCore = m_pWorld->m_apCharacters[p];
-				if(!pCharCore || pCharCore == this)
-					continue;
+				CCharacterCore *pCharCore = apNear[p];
 				float D = distance(Pos, pCharCore->m_Pos);
 				if(D < PHYS_SIZE && D >= 0.0f)
 				{
@@ -458,3 +532,59 @@ void CCharacterCore::Quantize()
 	Write(&Core);
 	Read(&Core);
 }
+
+CCharacterCoreBatch::CCharacterCoreBatch()
+{
+	m_pWorld = nullptr;
+	m_NumCores = 0;
+}
+
+void CCharacterCoreBatch::Init(CWorldCore *pWorld)
+{
+	m_pWorld = pWorld;
+	m_NumCores = 0;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		m_aSlots[i] = -1;
+		CCharacterCore *pCore = m_pWorld->m_apCharacters[i];
+		if(!pCore)
+			continue;
+
+		m_aSlots[i] = m_NumCores;
+		m_aClientIDs[m_NumCores] = i;
+		m_aPosX[m_NumCores] = pCore->m_Pos.x;
+		m_aPosY[m_NumCores] = pCore->m_Pos.y;
+		m_NumCores++;
+	}
+}
+
+void CCharacterCoreBatch::TickCore(int ClientID, bool UseInput)
+{
+	m_pWorld->m_apCharacters[ClientID]->TickImpl(UseInput, this, m_aSlots[ClientID]);
+}
+
+void CCharacterCoreBatch::MoveCore(int ClientID)
+{
+	const int Slot = m_aSlots[ClientID];
+	CCharacterCore *pCore = m_pWorld->m_apCharacters[ClientID];
+	pCore->AddDragVelocity();
+	pCore->ResetDragVelocity();
+	pCore->MoveImpl(this, Slot);
+	pCore->Quantize();
+
+	// the cores moved after this one collide with the new position
+	m_aPosX[Slot] = pCore->m_Pos.x;
+	m_aPosY[Slot] = pCore->m_Pos.y;
+}
+
+void CCharacterCoreBatch::Tick(bool UseInput)
+{
+	for(int k = 0; k < m_NumCores; k++)
+		TickCore(m_aClientIDs[k], UseInput);
+}
+
+void CCharacterCoreBatch::Move()
+{
+	for(int k = 0; k < m_NumCores; k++)
+		MoveCore(m_aClientIDs[k]);
+}
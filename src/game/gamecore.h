@@ -161,9 +161,16 @@ public:
 
 class CCharacterCore
 {
+	friend class CCharacterCoreBatch;
+
 	CWorldCore *m_pWorld;
 	CCollision *m_pCollision;
 
+	// pBatch is set when stepped by CCharacterCoreBatch, Self is the slot of this core in it
+	void TickImpl(bool UseInput, class CCharacterCoreBatch *pBatch, int Self);
+	void MoveImpl(class CCharacterCoreBatch *pBatch, int Self);
+	void InteractWith(CCharacterCore *pCharCore, int ClientID, float Distance);
+
 public:
 	static const float PHYS_SIZE;
 	vec2 m_Pos;
@@ -201,4 +208,43 @@ public:
 	void Quantize();
 };
 
+/*
+	Class: Character Core Batch
+		Steps all cores of a world core together. The positions are kept
+		in flat arrays, so the player <-> player checks first run over
+		contiguous data and only handle the characters they actually
+		touch one by one.
+
+		TickCore and MoveCore give bit for bit the same result as Tick and
+		AddDragVelocity, ResetDragVelocity, Move, Quantize on the core,
+		as long as every core is ticked before the first one is moved.
+*/
+class CCharacterCoreBatch
+{
+	friend class CCharacterCore;
+
+	CWorldCore *m_pWorld;
+	int m_NumCores;
+	int m_aClientIDs[MAX_CLIENTS];
+	int m_aSlots[MAX_CLIENTS];
+	float m_aPosX[MAX_CLIENTS];
+	float m_aPosY[MAX_CLIENTS];
+	// results of the flat passes, per slot
+	float m_aDistances[MAX_CLIENTS];
+
+public:
+	CCharacterCoreBatch();
+
+	// collects the cores of the world, again needed after cores were added, removed or changed from outside
+	void Init(CWorldCore *pWorld);
+	int NumCores() const { return m_NumCores; }
+
+	void TickCore(int ClientID, bool UseInput);
+	void MoveCore(int ClientID);
+
+	// every core in client order
+	void Tick(bool UseInput);
+	void Move();
+};
+
 #endif
@@ -8,6 +8,10 @@
  * See license.txt in the root of the distribution for more information.
  * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
  */
+#include <engine/shared/datafile.h>
+
+#include <vector>
+
 #include "layers.h"
 
 CLayers::CLayers()
@@ -110,3 +114,63 @@ CMapItemLayer *CLayers::GetLayer(int Index) const
 {
 	return static_cast<CMapItemLayer *>(m_pMap->GetItem(m_LayersStart + Index, 0, 0));
 }
+
+bool CLayers::GameEntities(const CMapItemEntity **ppEntities, int *pNum) const
+{
+	*ppEntities = 0;
+	*pNum = 0;
+	const CMapItemEntities *pItem = static_cast<CMapItemEntities *>(m_pMap->FindItem(MAPITEMTYPE_ENTITIES, 0));
+	if(!pItem || pItem->m_Version < 1 || !m_pGameLayer)
+		return false;
+
+	// maps edited by tools that keep unknown items could have a stale index,
+	// checked without touching every tile so loading stays O(entities)
+	if(pItem->m_Width != m_pGameLayer->m_Width || pItem->m_Height != m_pGameLayer->m_Height ||
+		pItem->m_TilesData != m_pGameLayer->m_Data || pItem->m_NumEntities < 0)
+		return false;
+	const CTile *pTiles = static_cast<CTile *>(m_pMap->GetData(m_pGameLayer->m_Data));
+	if(!pTiles || m_pMap->GetDataSize(m_pGameLayer->m_Data) < m_pGameLayer->m_Width * m_pGameLayer->m_Height * (int) sizeof(CTile))
+		return false;
+	if(pItem->m_NumEntities == 0)
+		return true;
+	if(m_pMap->GetDataSize(pItem->m_Data) != pItem->m_NumEntities * (int) sizeof(CMapItemEntity))
+		return false;
+
+	const CMapItemEntity *pEntities = static_cast<CMapItemEntity *>(m_pMap->GetDataSwapped(pItem->m_Data));
+	if(!pEntities)
+		return false;
+	for(int i = 0; i < pItem->m_NumEntities; i++)
+	{
+		const CMapItemEntity &Entity = pEntities[i];
+		if(Entity.m_X < 0 || Entity.m_X >= pItem->m_Width || Entity.m_Y < 0 || Entity.m_Y >= pItem->m_Height ||
+			Entity.m_Index <= TILE_NOHOOK || Entity.m_Index > 255 || pTiles[Entity.m_Y * pItem->m_Width + Entity.m_X].m_Index != Entity.m_Index)
+			return false;
+	}
+
+	*ppEntities = pEntities;
+	*pNum = pItem->m_NumEntities;
+	return true;
+}
+
+void CLayers::AddEntityIndex(CDataFileWriter *pWriter, const CTile *pTiles, int Width, int Height, int TilesData)
+{
+	std::vector<CMapItemEntity> vEntities;
+	for(int y = 0; y < Height; y++)
+	{
+		for(int x = 0; x < Width; x++)
+		{
+			const int Index = pTiles[y * Width + x].m_Index;
+			if(Index > TILE_NOHOOK)
+				vEntities.push_back({x, y, Index});
+		}
+	}
+
+	CMapItemEntities Item;
+	Item.m_Version = CMapItemEntities::CURRENT_VERSION;
+	Item.m_Width = Width;
+	Item.m_Height = Height;
+	Item.m_TilesData = TilesData;
+	Item.m_NumEntities = vEntities.size();
+	Item.m_Data = vEntities.empty() ? -1 : pWriter->AddDataSwapped(vEntities.size() * sizeof(CMapItemEntity), vEntities.data());
+	pWriter->AddItem(MAPITEMTYPE_ENTITIES, 0, sizeof(Item), &Item);
+}
@@ -13,6 +13,7 @@
 
 #include <engine/map.h>
 #include <game/mapitems.h>
+#include <game/mapitems_ex.h>
 
 class CLayers
 {
@@ -37,6 +38,10 @@ public:
 	CMapItemLayerTilemap *GameLayer() const { return m_pGameLayer; }
 	CMapItemGroup *GetGroup(int Index) const;
 	CMapItemLayer *GetLayer(int Index) const;
+
+	// entity tiles of the game layer from the map's entity index, false if it has none or it does not fit the game layer
+	bool GameEntities(const CMapItemEntity **ppEntities, int *pNum) const;
+	static void AddEntityIndex(class CDataFileWriter *pWriter, const CTile *pTiles, int Width, int Height, int TilesData);
 };
 
 #endif
@@ -0,0 +1,19 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <engine/shared/uuid_manager.h>
+
+#include "mapitems_ex.h"
+
+void RegisterMapItemTypeUuids(CUuidManager *pManager)
+{
+#define UUID(id, name) pManager->RegisterName(id, name);
+#include "mapitems_ex_types.h"
+#undef UUID
+}
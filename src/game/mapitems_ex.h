@@ -0,0 +1,53 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef GAME_MAPITEMS_EX_H
+#define GAME_MAPITEMS_EX_H
+
+#include <generated/protocol.h>
+
+// map item types identified by uuid, readers that don't know them skip them
+enum
+{
+	__MAPITEMTYPE_UUID_HELPER = OFFSET_MAPITEMTYPE_UUID - 1,
+#define UUID(id, name) id,
+#include "mapitems_ex_types.h"
+#undef UUID
+	END_MAPITEMTYPES_UUID,
+};
+
+struct CMapItemEntity
+{
+	int m_X; // in tiles
+	int m_Y;
+	int m_Index; // game layer tile index
+};
+
+// precomputed entity tiles of the game layer, in map order
+struct CMapItemEntities
+{
+	enum
+	{
+		CURRENT_VERSION = 1
+	};
+
+	int m_Version;
+
+	// size and tile data of the game layer the list was made for
+	int m_Width;
+	int m_Height;
+	int m_TilesData;
+
+	int m_NumEntities;
+	int m_Data; // CMapItemEntity[m_NumEntities]
+};
+
+void RegisterMapItemTypeUuids(class CUuidManager *pManager);
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <base/math.h>
+
+#include "alloc.h"
+
+/*
+	every block starts with a pointer to its pool, padded so the entity
+	behind it keeps the alignment mem_alloc would have given it.
+	free blocks reuse the entity memory to link the free list.
+*/
+static const size_t s_HeaderSize = alignof(std::max_align_t);
+
+CEntityPool::CEntityPool()
+{
+	m_BlockSize = 0;
+	m_pFirstSlab = nullptr;
+	m_pFirstFree = nullptr;
+	mem_zero(&m_Stats, sizeof(m_Stats));
+}
+
+CEntityPool::~CEntityPool()
+{
+	Clear();
+}
+
+void CEntityPool::Clear()
+{
+	// the slabs hold objects, their destructors have to run before the memory goes
+	dbg_assert(m_Stats.m_NumLive == 0, "entity pool cleared with live entities");
+
+	while(m_pFirstSlab)
+	{
+		CSlab *pNext = m_pFirstSlab->m_pNext;
+		mem_free(m_pFirstSlab);
+		m_pFirstSlab = pNext;
+	}
+	m_pFirstFree = nullptr;
+	m_Stats.m_NumSlabs = 0;
+}
+
+bool CEntityPool::Grow()
+{
+	CSlab *pSlab = (CSlab *) mem_alloc(s_HeaderSize + SLAB_BLOCKS * m_BlockSize);
+	if(!pSlab)
+		return false;
+
+	pSlab->m_pNext = m_pFirstSlab;
+	m_pFirstSlab = pSlab;
+	m_Stats.m_NumSlabs++;
+
+	// thread the free list back to front so blocks are handed out in address order
+	unsigned char *pBlocks = (unsigned char *) pSlab + s_HeaderSize;
+	for(int i = SLAB_BLOCKS - 1; i >= 0; i--)
+	{
+		unsigned char *pBlock = pBlocks + i * m_BlockSize;
+		*(CEntityPool **) pBlock = this;
+		*(void **) (pBlock + s_HeaderSize) = m_pFirstFree;
+		m_pFirstFree = pBlock + s_HeaderSize;
+	}
+	return true;
+}
+
+void *CEntityPool::Allocate(size_t Size)
+{
+	const size_t BlockSize = (s_HeaderSize + Size + s_HeaderSize - 1) / s_HeaderSize * s_HeaderSize;
+	if(!m_BlockSize)
+		m_BlockSize = BlockSize;
+	dbg_assert(m_BlockSize == BlockSize, "entity pool used for different sizes");
+
+	const bool HasBlock = m_pFirstFree || Grow();
+	dbg_assert(HasBlock, "out of memory for entities");
+
+	void *pData = m_pFirstFree;
+	m_pFirstFree = *(void **) pData;
+	mem_zero(pData, Size);
+
+	m_Stats.m_NumLive++;
+	m_Stats.m_NumLivePeak = maximum(m_Stats.m_NumLivePeak, m_Stats.m_NumLive);
+	m_Stats.m_NumAllocs++;
+	return pData;
+}
+
+void CEntityPool::Free(void *pPtr)
+{
+	if(!pPtr)
+		return;
+
+	CEntityPool *pPool = *(CEntityPool **) ((unsigned char *) pPtr - s_HeaderSize);
+	*(void **) pPtr = pPool->m_pFirstFree;
+	pPool->m_pFirstFree = pPtr;
+	pPool->m_Stats.m_NumLive--;
+	pPool->m_Stats.m_NumFrees++;
+}
@@ -11,6 +11,7 @@
 #ifndef GAME_SERVER_ALLOC_H
 #define GAME_SERVER_ALLOC_H
 
+#include <cstddef>
 #include <new>
 
 #include <base/system.h>
@@ -68,4 +69,78 @@ private:
 		mem_zero(ms_PoolData##POOLTYPE[id], sizeof(POOLTYPE)); \
 	}
 
+/*
+	Class: Entity Pool
+		Growable slab pool for one entity class. Blocks remember their
+		pool, so they can be freed without knowing the owner. Clearing
+		the pool releases every slab in one sweep, every block has to
+		be freed before that.
+*/
+class CEntityPool
+{
+public:
+	enum
+	{
+		SLAB_BLOCKS = 64,
+	};
+
+	struct CStats
+	{
+		int m_NumSlabs;
+		int m_NumLive;
+		int m_NumLivePeak;
+		int64_t m_NumAllocs;
+		int64_t m_NumFrees;
+	};
+
+private:
+	struct CSlab
+	{
+		CSlab *m_pNext;
+	};
+
+	size_t m_BlockSize;
+	CSlab *m_pFirstSlab;
+	void *m_pFirstFree;
+	CStats m_Stats;
+
+	bool Grow();
+
+public:
+	CEntityPool();
+	~CEntityPool();
+
+	void *Allocate(size_t Size);
+	static void Free(void *pPtr);
+	void Clear();
+
+	const CStats &Stats() const { return m_Stats; }
+};
+
+/*
+	MACRO_ALLOC_POOL_WORLD: the entity is allocated with new(pGameWorld)
+	from the world's pool POOLID and freed with a plain delete.
+*/
+#define MACRO_ALLOC_POOL_WORLD() \
+public: \
+	void *operator new(size_t Size, class CGameWorld *pGameWorld); \
+	void operator delete(void *pPtr, class CGameWorld *pGameWorld); \
+	void operator delete(void *pPtr); /* NOLINT(misc-new-delete-overloads) */ \
+\
+private:
+
+#define MACRO_ALLOC_POOL_WORLD_IMPL(POOLTYPE, POOLID) \
+	void *POOLTYPE::operator new(size_t Size, CGameWorld *pGameWorld) \
+	{ \
+		return pGameWorld->EntityPool(POOLID)->Allocate(Size); \
+	} \
+	void POOLTYPE::operator delete(void *pPtr, CGameWorld *pGameWorld) \
+	{ \
+		CEntityPool::Free(pPtr); \
+	} \
+	void POOLTYPE::operator delete(void *pPtr) /* NOLINT(misc-new-delete-overloads) */ \
+	{ \
+		CEntityPool::Free(pPtr); \
+	}
+
 #endif
@@ -14,6 +14,7 @@
 #include "gamecontext.h"
 #include "gamecontroller.h"
 #include "gameworld.h"
+#include "gameworld.inl"
 #include "player.h"
 
 #include "botmanager.h"
@@ -30,10 +31,18 @@ CBotManager::CBotManager(CGameWorld *pGameWorld)
 {
 	m_pGameWorld = pGameWorld;
 	m_vMarkedAsDestroy.clear();
-	m_vpBots.clear();
+	m_uBots.clear();
+	mem_zero(&m_Stats, sizeof(m_Stats));
+	mem_zero(m_aClientMaps, sizeof(m_aClientMaps));
 	ClearPlayerMap(-1);
 }
 
+CBotManager::~CBotManager()
+{
+	for(auto *pBot : m_vpDeadBots)
+		delete pBot;
+}
+
 void CBotManager::ClearPlayerMap(int ClientID)
 {
 	if(ClientID == -1)
@@ -45,179 +54,302 @@ void CBotManager::ClearPlayerMap(int ClientID)
 		return;
 	}
 
+	SClientMap &Map = m_aClientMaps[ClientID];
 	for(int i = 0; i < MAX_BOTS; i++)
 	{
-		m_aaBotIDMaps[ClientID][i] = UUID_ZEROED;
+		if(Map.m_aBotIDs[i] != UUID_ZEROED && m_uBots.count(Map.m_aBotIDs[i]))
+			m_uBots[Map.m_aBotIDs[i]].m_aSlots[ClientID] = -1;
+		Map.m_aBotIDs[i] = UUID_ZEROED;
 	}
+	Map.m_LastViewPos = vec2(0.0f, 0.0f);
+	Map.m_NextUpdateTick = 0;
+	Map.m_Dirty = true;
+	Map.m_InWorld = false;
 }
 
-bool DistanceCompare(std::pair<float, Uuid> a, std::pair<float, Uuid> b)
+void CBotManager::MarkAllDirty()
 {
-	return (a.first < b.first);
+	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+		m_aClientMaps[i].m_Dirty = true;
 }
 
-void CBotManager::UpdatePlayerMap(int ClientID)
+void CBotManager::FindNearestBots(vec2 Pos)
 {
-	Uuid aLastMap[MAX_BOTS];
-	mem_copy(aLastMap, m_aaBotIDMaps[ClientID], sizeof(m_aaBotIDMaps[ClientID]));
+	m_vNearest.clear();
 
-	Uuid *pMap = m_aaBotIDMaps[ClientID];
-	for(int i = 0; i < MAX_BOTS; i++)
+	const int NumBots = m_uBots.size();
+	if(!NumBots)
+		return;
+
+	// widen the search until it holds enough bots, bots can stand a bit outside of the map
+	m_vpFound.resize(NumBots);
+	const float MaxRadius = (GameWorld()->Collision()->GetWidth() + GameWorld()->Collision()->GetHeight() + 400) * 32.0f;
+	int Num = 0;
+	for(float Radius = NETWORK_CLIP_RADIUS;; Radius *= 2.0f)
 	{
-		if(pMap[i] != UUID_ZEROED && !m_vpBots.count(pMap[i]))
-			pMap[i] = UUID_ZEROED;
+		Num = GameWorld()->FindEntities(Pos, Radius, m_vpFound.data(), NumBots, GameWorldCheck::EntityType(CGameWorld::ENTTYPE_BOTENTITY));
+		if(Num >= MAX_BOTS || Num >= NumBots || Radius >= MaxRadius)
+			break;
 	}
 
-	std::vector<std::pair<float, Uuid>> Distances;
-	for(auto &[BotID, pBot] : m_vpBots)
+	for(int i = 0; i < Num; i++)
 	{
-		if(!pBot)
+		CBotEntity *pBot = static_cast<CBotEntity *>(m_vpFound[i]);
+		auto It = m_uBots.find(pBot->GetBotID());
+		if(It == m_uBots.end() || It->second.m_pEntity != pBot)
 			continue;
+		m_vNearest.emplace_back(distance(Pos, pBot->GetPos()), pBot);
+	}
 
-		std::pair<float, Uuid> Temp;
-		Temp.first = distance(GameServer()->m_apPlayers[ClientID]->m_ViewPos, pBot->GetPos());
-		Temp.second = BotID;
+	const int NumNearest = minimum((int) m_vNearest.size(), (int) MAX_BOTS);
+	std::partial_sort(m_vNearest.begin(), m_vNearest.begin() + NumNearest, m_vNearest.end(),
+		[](const std::pair<float, CBotEntity *> &a, const std::pair<float, CBotEntity *> &b) { return a.first < b.first; });
+	m_vNearest.resize(NumNearest);
+}
 
-		Distances.push_back(Temp);
+void CBotManager::UpdatePlayerMap(int ClientID)
+{
+	SClientMap &Map = m_aClientMaps[ClientID];
+	const vec2 ViewPos = GameServer()->m_apPlayers[ClientID]->m_ViewPos;
+
+	// only look again when the view moved, the bots changed or the interval passed,
+	// moving bots are followed by the interval
+	if(!Map.m_Dirty && Server()->Tick() < Map.m_NextUpdateTick && distance(ViewPos, Map.m_LastViewPos) < UPDATE_DISTANCE)
+	{
+		m_Stats.m_NumSkipped++;
+		return;
 	}
-	std::sort(Distances.begin(), Distances.end(), DistanceCompare);
+	m_Stats.m_NumUpdates++;
+	Map.m_Dirty = false;
+	Map.m_InWorld = true;
+	Map.m_LastViewPos = ViewPos;
+	Map.m_NextUpdateTick = Server()->Tick() + UPDATE_INTERVAL;
 
+	Uuid aLastMap[MAX_BOTS];
+	mem_copy(aLastMap, Map.m_aBotIDs, sizeof(Map.m_aBotIDs));
+
+	Uuid *pMap = Map.m_aBotIDs;
+	float aSlotDistances[MAX_BOTS];
 	for(int i = 0; i < MAX_BOTS; i++)
 	{
+		aSlotDistances[i] = -1.0f;
 		if(pMap[i] == UUID_ZEROED)
 			continue;
 
-		bool Found = false;
-		int FoundID;
+		auto It = m_uBots.find(pMap[i]);
+		if(It == m_uBots.end() || !It->second.m_pEntity)
+			pMap[i] = UUID_ZEROED;
+		else
+			aSlotDistances[i] = distance(ViewPos, It->second.m_pEntity->GetPos());
+	}
+
+	// fill free slots with the nearest bots, a full slot only goes to a clearly closer bot
+	FindNearestBots(ViewPos);
+	for(auto &[Distance, pBot] : m_vNearest)
+	{
+		const Uuid BotID = pBot->GetBotID();
+		const int Slot = m_uBots[BotID].m_aSlots[ClientID];
+		if(Slot != -1 && pMap[Slot] == BotID)
+			continue;
 
-		for(FoundID = 0; FoundID < minimum((int) Distances.size(), (int) MAX_BOTS); FoundID++)
+		int Target = -1;
+		for(int i = 0; i < MAX_BOTS; i++)
 		{
-			if(Distances[FoundID].second == pMap[i])
+			if(pMap[i] == UUID_ZEROED)
 			{
-				Found = true;
+				Target = i;
 				break;
 			}
+			if(Target == -1 || aSlotDistances[i] > aSlotDistances[Target])
+				Target = i;
 		}
 
-		if(Found)
-		{
-			Distances.erase(Distances.begin() + FoundID);
-		}
-		else
-		{
-			pMap[i] = UUID_ZEROED;
-		}
-	}
-
-	int Index = 0;
-	for(int i = 0; i < MAX_BOTS; i++)
-	{
-		if(Index >= (int) Distances.size())
+		// the list is sorted, no farther bot can win a slot either
+		if(pMap[Target] != UUID_ZEROED && Distance * SLOT_HYSTERESIS >= aSlotDistances[Target])
 			break;
 
-		if(pMap[i] == UUID_ZEROED)
-		{
-			pMap[i] = Distances[Index].second;
-			Index++;
-		}
+		pMap[Target] = BotID;
+		aSlotDistances[Target] = Distance;
 	}
 
-	// skip self
 	for(int i = 0; i < MAX_BOTS; i++)
 	{
-		if(aLastMap[i] != pMap[i])
+		if(aLastMap[i] == pMap[i])
+			continue;
+
+		m_Stats.m_NumSlotChanges++;
+		if(aLastMap[i] != UUID_ZEROED)
 		{
-			// the id is removed, we need to send drop message
-			bool SendDrop = pMap[i] != UUID_ZEROED;
-			if(!SendDrop || aLastMap[i] != UUID_ZEROED)
-			{
-				CNetMsg_Sv_ClientDrop DropInfo;
-				DropInfo.m_ClientID = i + SERVER_MAX_CLIENTS;
-				DropInfo.m_pReason = "";
-				DropInfo.m_Silent = true;
+			auto It = m_uBots.find(aLastMap[i]);
+			if(It != m_uBots.end() && It->second.m_aSlots[ClientID] == i)
+				It->second.m_aSlots[ClientID] = -1;
 
-				Server()->SendPackMsg(&DropInfo, MSGFLAG_VITAL | MSGFLAG_NORECORD, ClientID);
+			// the id is removed, we need to send drop message
+			CNetMsg_Sv_ClientDrop DropInfo;
+			DropInfo.m_ClientID = i + SERVER_MAX_CLIENTS;
+			DropInfo.m_pReason = "";
+			DropInfo.m_Silent = true;
 
-				if(!SendDrop)
-					continue;
-			}
+			Server()->SendPackMsg(&DropInfo, MSGFLAG_VITAL | MSGFLAG_NORECORD, ClientID);
+			m_Stats.m_NumDropMsgs++;
+		}
 
-			if(!m_vpBots.count(pMap[i]))
-				continue;
-			CBotEntity *pBot = m_vpBots[pMap[i]];
+		if(pMap[i] == UUID_ZEROED)
+			continue;
 
-			CNetMsg_Sv_ClientInfo NewInfo;
-			NewInfo.m_ClientID = i + SERVER_MAX_CLIENTS;
-			NewInfo.m_Local = 0;
-			// do not show bot
-			NewInfo.m_Team = TEAM_BLUE;
+		SBot &Bot = m_uBots[pMap[i]];
+		Bot.m_aSlots[ClientID] = i;
+		CBotEntity *pBot = Bot.m_pEntity;
 
-			NewInfo.m_pName = "";
-			NewInfo.m_pClan = "";
-			NewInfo.m_Country = -1;
-			NewInfo.m_Silent = true;
+		CNetMsg_Sv_ClientInfo NewInfo;
+		NewInfo.m_ClientID = i + SERVER_MAX_CLIENTS;
+		NewInfo.m_Local = 0;
+		// do not show bot
+		NewInfo.m_Team = TEAM_BLUE;
 
-			for(int p = 0; p < NUM_SKINPARTS; p++)
-			{
-				NewInfo.m_apSkinPartNames[p] = pBot->GetTeeInfos()->m_aaSkinPartNames[p];
-				NewInfo.m_aUseCustomColors[p] = pBot->GetTeeInfos()->m_aUseCustomColors[p];
-				NewInfo.m_aSkinPartColors[p] = pBot->GetTeeInfos()->m_aSkinPartColors[p];
-			}
+		NewInfo.m_pName = "";
+		NewInfo.m_pClan = "";
+		NewInfo.m_Country = -1;
+		NewInfo.m_Silent = true;
 
-			Server()->SendPackMsg(&NewInfo, MSGFLAG_VITAL | MSGFLAG_NORECORD, ClientID);
+		for(int p = 0; p < NUM_SKINPARTS; p++)
+		{
+			NewInfo.m_apSkinPartNames[p] = pBot->GetTeeInfos()->m_aaSkinPartNames[p];
+			NewInfo.m_aUseCustomColors[p] = pBot->GetTeeInfos()->m_aUseCustomColors[p];
+			NewInfo.m_aSkinPartColors[p] = pBot->GetTeeInfos()->m_aSkinPartColors[p];
 		}
+
+		Server()->SendPackMsg(&NewInfo, MSGFLAG_VITAL | MSGFLAG_NORECORD, ClientID);
+		m_Stats.m_NumInfoMsgs++;
 	}
 }
 
+// bot ids come from the world's random stream, the bot map is ordered by
+// them and a re-simulation has to tick the bots in the same order
+static Uuid RandomBotID(CGameWorld *pWorld)
+{
+	Uuid Result;
+	for(int i = 0; i < (int) sizeof(Result.m_aData); i += sizeof(int))
+	{
+		const int Random = pWorld->RandomInt();
+		mem_copy(&Result.m_aData[i], &Random, sizeof(Random));
+	}
+	return Result;
+}
+
 bool CBotManager::CreateBot()
 {
 	// find first free bot id
-	Uuid FreeID = RandomUuid();
-	for(; m_vpBots.count(FreeID); FreeID = RandomUuid()) {}
+	Uuid FreeID = RandomBotID(GameWorld());
+	for(; m_uBots.count(FreeID); FreeID = RandomBotID(GameWorld())) {}
 
 	vec2 SpawnPos;
 	if(!GameWorld()->GameController()->CanSpawn(GameWorld(), TEAM_BLUE, &SpawnPos))
 		return false;
 
-	CBotEntity *pBot = new CBotEntity(GameWorld(), SpawnPos, FreeID, GenerateRandomSkin());
+	CBotEntity *pBot = new(GameWorld()) CBotEntity(GameWorld(), SpawnPos, FreeID, GenerateRandomSkin(GameWorld()->RandomInt()));
 	pBot->SetMaxHealth(10);
 	pBot->SetMaxArmor(10);
 	pBot->IncreaseHealth(10);
 	pBot->IncreaseArmor(5);
-	m_vpBots[FreeID] = pBot;
+
+	SBot &Bot = m_uBots[FreeID];
+	Bot.m_pEntity = pBot;
+	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+		Bot.m_aSlots[i] = -1;
+	Bot.m_InterestTick = Server()->Tick();
+
+	// the new bot can be closer than a mapped one for anybody
+	MarkAllDirty();
 	return true;
 }
 
 void CBotManager::Tick()
 {
-	while(m_vpBots.size() < GameWorld()->m_aNumSpawnPoints[2])
+	const int64_t Start = time_get();
+	while(m_uBots.size() < GameWorld()->m_avSpawnPoints[2].size())
 	{
 		if(!CreateBot())
 			break;
 	}
+
+	UpdateSleep();
+	m_Stats.m_TickTime += time_get() - Start;
+}
+
+void CBotManager::UpdateSleep()
+{
+	const float WakeRadius = Config()->m_SvBotLodRadius;
+	const float SleepRadius = WakeRadius * SLEEP_HYSTERESIS;
+	const int Tick = Server()->Tick();
+
+	// decided from the views at the start of the tick only, so waking does not depend on the tick order
+	if(WakeRadius > 0.0f && !m_uBots.empty())
+	{
+		m_vpFound.resize(m_uBots.size());
+		for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+		{
+			CPlayer *pPlayer = GameWorld()->GetPlayer(i);
+			if(!pPlayer || !Server()->ClientIngame(i))
+				continue;
+
+			const vec2 ViewPos = pPlayer->m_ViewPos;
+			int Num = GameWorld()->FindEntities(ViewPos, SleepRadius, m_vpFound.data(), m_vpFound.size(), GameWorldCheck::EntityType(CGameWorld::ENTTYPE_BOTENTITY));
+			for(int j = 0; j < Num; j++)
+			{
+				CBotEntity *pBot = static_cast<CBotEntity *>(m_vpFound[j]);
+				auto It = m_uBots.find(pBot->GetBotID());
+				if(It == m_uBots.end() || It->second.m_pEntity != pBot)
+					continue;
+
+				if(!pBot->IsSleeping() || distance(ViewPos, pBot->GetPos()) < WakeRadius)
+					It->second.m_InterestTick = Tick;
+			}
+		}
+	}
+
+	m_Stats.m_NumSleeping = 0;
+	for(auto &[BotID, Bot] : m_uBots)
+	{
+		if(!Bot.m_pEntity)
+			continue;
+
+		const bool Sleeping = WakeRadius > 0.0f && Bot.m_InterestTick != Tick;
+		if(Bot.m_pEntity->IsSleeping() && !Sleeping)
+			m_Stats.m_NumWakeups++;
+		Bot.m_pEntity->SetSleeping(Sleeping);
+		if(Sleeping)
+			m_Stats.m_NumSleeping++;
+	}
 }
 
 void CBotManager::CreateDamage(vec2 Pos, Uuid BotID, vec2 Source, int HealthAmount, int ArmorAmount, bool Self)
 {
+	auto It = m_uBots.find(BotID);
+	if(It == m_uBots.end())
+		return;
+
 	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
 	{
-		int ClientID = FindClientID(i, BotID);
-		if(ClientID == -1)
+		if(It->second.m_aSlots[i] == -1)
 			continue;
 
-		GameWorld()->CreateDamage(Pos, ClientID, Source, HealthAmount, ArmorAmount, Self, CmaskOne(i));
+		GameWorld()->CreateDamage(Pos, It->second.m_aSlots[i] + SERVER_MAX_CLIENTS, Source, HealthAmount, ArmorAmount, Self, CmaskOne(i));
 	}
 }
 
 void CBotManager::CreateDeath(vec2 Pos, Uuid BotID)
 {
+	auto It = m_uBots.find(BotID);
+	if(It == m_uBots.end())
+		return;
+
 	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
 	{
-		int ClientID = FindClientID(i, BotID);
-		if(ClientID == -1)
+		if(It->second.m_aSlots[i] == -1)
 			continue;
 
-		GameWorld()->CreateDeath(Pos, ClientID, CmaskOne(i));
+		GameWorld()->CreateDeath(Pos, It->second.m_aSlots[i] + SERVER_MAX_CLIENTS, CmaskOne(i));
 	}
 }
 
@@ -225,22 +357,24 @@ int CBotManager::FindClientID(int ClientID, Uuid BotID)
 {
 	dbg_assert(ClientID >= 0, "Server demo is hard-coded disabled now.");
 
-	int FindID = -1 - SERVER_MAX_CLIENTS;
-	for(int i = 0; i < MAX_BOTS; i++)
-	{
-		if(m_aaBotIDMaps[ClientID][i] == BotID)
-		{
-			FindID = i;
-			break;
-		}
-	}
-	return FindID + SERVER_MAX_CLIENTS;
+	auto It = m_uBots.find(BotID);
+	if(It == m_uBots.end() || It->second.m_aSlots[ClientID] == -1)
+		return -1;
+	return It->second.m_aSlots[ClientID] + SERVER_MAX_CLIENTS;
 }
 
 void CBotManager::OnBotDeath(Uuid BotID)
 {
 	m_vMarkedAsDestroy.push_back(BotID);
-	m_vpBots[BotID] = nullptr;
+
+	// only the clients which had the bot in a slot need to look again
+	SBot &Bot = m_uBots[BotID];
+	if(Bot.m_pEntity)
+		m_vpDeadBots.push_back(Bot.m_pEntity);
+	Bot.m_pEntity = nullptr;
+	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+		if(Bot.m_aSlots[i] != -1)
+			m_aClientMaps[i].m_Dirty = true;
 }
 
 void CBotManager::OnClientRefresh(int ClientID)
@@ -253,17 +387,30 @@ void CBotManager::OnClientRefresh(int ClientID)
 
 void CBotManager::PostSnap()
 {
+	const int64_t Start = time_get();
+	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+	{
+		if(Server()->ClientIngame(i) && GameWorld()->GetPlayer(i))
+			UpdatePlayerMap(i);
+		else if(m_aClientMaps[i].m_InWorld)
+		{
+			// the slots belong to the client's new world now
+			ClearPlayerMap(i);
+		}
+	}
+
+	// after the update, it still needs the slots of dead bots to send the drops
 	if(m_vMarkedAsDestroy.size())
 	{
 		for(auto &DestroyID : m_vMarkedAsDestroy)
 		{
-			m_vpBots.erase(DestroyID);
+			m_uBots.erase(DestroyID);
 		}
 		m_vMarkedAsDestroy.clear();
+
+		for(auto *pBot : m_vpDeadBots)
+			delete pBot;
+		m_vpDeadBots.clear();
 	}
-	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
-	{
-		if(Server()->ClientIngame(i) && GameServer()->m_apPlayers[i])
-			UpdatePlayerMap(i);
-	}
+	m_Stats.m_PostSnapTime += time_get() - Start;
 }
@@ -23,14 +23,72 @@ class CGameWorld;
 
 class CBotManager
 {
+public:
+	struct CStats
+	{
+		int64_t m_NumUpdates;
+		int64_t m_NumSkipped;
+		// bots that entered or left a client's slots
+		int64_t m_NumSlotChanges;
+		int64_t m_NumDropMsgs;
+		int64_t m_NumInfoMsgs;
+		int m_NumSleeping;
+		int64_t m_NumWakeups;
+		// time spent in Tick and PostSnap, in time_get units
+		int64_t m_TickTime;
+		int64_t m_PostSnapTime;
+	};
+
+private:
+	enum
+	{
+		// ticks before a client whose view did not move looks at the bots again
+		UPDATE_INTERVAL = 10,
+	};
+	// how far a view has to move before its slots are looked at before the interval
+	static constexpr float UPDATE_DISTANCE = 64.0f;
+	// a closer bot only takes a full slot from a bot this much farther away
+	static constexpr float SLOT_HYSTERESIS = 1.25f;
+	// awake bots only fall asleep this much farther away than sv_bot_lod_radius
+	static constexpr float SLEEP_HYSTERESIS = 1.25f;
+
+	struct SBot
+	{
+		class CBotEntity *m_pEntity;
+		// slot of the bot for every client, -1 when it is not mapped
+		signed char m_aSlots[SERVER_MAX_CLIENTS];
+		// last tick a player was close enough to keep the bot awake
+		int m_InterestTick;
+	};
+
+	struct SClientMap
+	{
+		Uuid m_aBotIDs[MAX_BOTS];
+		vec2 m_LastViewPos;
+		int m_NextUpdateTick;
+		bool m_Dirty;
+		bool m_InWorld;
+	};
+
 	CGameWorld *m_pGameWorld;
-	Uuid m_aaBotIDMaps[SERVER_MAX_CLIENTS][MAX_BOTS];
+	SClientMap m_aClientMaps[SERVER_MAX_CLIENTS];
 
 	std::vector<Uuid> m_vMarkedAsDestroy;
-	std::unordered_map<Uuid, class CBotEntity *> m_vpBots;
+	// dead bots are off the entity lists, they are deleted with their ids
+	std::vector<class CBotEntity *> m_vpDeadBots;
+	std::unordered_map<Uuid, SBot> m_uBots;
+
+	// scratch buffers of the nearest bot search
+	std::vector<class CEntity *> m_vpFound;
+	std::vector<std::pair<float, class CBotEntity *>> m_vNearest;
+
+	CStats m_Stats;
 
 	void ClearPlayerMap(int ClientID);
+	void MarkAllDirty();
+	void FindNearestBots(vec2 Pos);
 	void UpdatePlayerMap(int ClientID);
+	void UpdateSleep();
 
 public:
 	class CConfig *Config() const;
@@ -40,6 +98,7 @@ public:
 	class IServer *Server() const;
 
 	CBotManager(CGameWorld *pGameWorld);
+	~CBotManager();
 
 	void Tick();
 
@@ -53,6 +112,8 @@ public:
 	void OnClientRefresh(int ClientID);
 
 	void PostSnap();
+
+	const CStats &Stats() const { return m_Stats; }
 };
 
 #endif // GAME_SERVER_BOTMANAGER_H
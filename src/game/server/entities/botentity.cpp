@@ -19,6 +19,8 @@
 #include <generated/server_data.h>
 
 #include "botentity.h"
+
+MACRO_ALLOC_POOL_WORLD_IMPL(CBotEntity, CGameWorld::ENTTYPE_BOTENTITY)
 #include "character.h"
 
 CBotEntity::CBotEntity(CGameWorld *pWorld, vec2 Pos, Uuid BotID, STeeInfo TeeInfos) :
@@ -32,7 +34,8 @@ CBotEntity::CBotEntity(CGameWorld *pWorld, vec2 Pos, Uuid BotID, STeeInfo TeeInf
 	}
 
 	m_BotID = BotID;
-	m_Emote = random_int() % NUM_EMOTES;
+	m_Emote = GameWorld()->RandomInt() % NUM_EMOTES;
+	m_Sleeping = false;
 	m_TeeInfos = TeeInfos;
 
 	m_AttackTick = 0;
@@ -56,8 +59,22 @@ CBotEntity::CBotEntity(CGameWorld *pWorld, vec2 Pos, Uuid BotID, STeeInfo TeeInf
 	GameWorld()->RegisterEntitySelfAsComponent<CHealthComponent>(this);
 }
 
+void CBotEntity::SetSleeping(bool Sleeping)
+{
+	if(m_Sleeping == Sleeping)
+		return;
+
+	m_Sleeping = Sleeping;
+	// resync the dead reckoning, the sleeping bot was sent without it
+	if(!m_Sleeping)
+		m_ReckoningTick = 0;
+}
+
 void CBotEntity::Tick()
 {
+	if(m_Sleeping)
+		return;
+
 	Action();
 
 	m_Core.m_Input = m_Input;
@@ -75,6 +92,9 @@ void CBotEntity::Tick()
 
 void CBotEntity::TickDefered()
 {
+	if(m_Sleeping)
+		return;
+
 	static const vec2 ColBox(CCharacterCore::PHYS_SIZE, CCharacterCore::PHYS_SIZE);
 	// advance the dummy
 	{
@@ -100,7 +120,7 @@ void CBotEntity::TickDefered()
 	bool StuckAfterMove = GameWorld()->Collision()->TestBox(m_Core.m_Pos, ColBox);
 	m_Core.Quantize();
 	bool StuckAfterQuant = GameWorld()->Collision()->TestBox(m_Core.m_Pos, ColBox);
-	m_Pos = m_Core.m_Pos;
+	SetPos(m_Core.m_Pos);
 
 	if(!StuckBefore && (StuckAfterMove || StuckAfterQuant))
 	{
@@ -125,7 +145,7 @@ void CBotEntity::TickDefered()
 			StartVel.x, StartVel.y,
 			StartPosX.u, StartPosY.u,
 			StartVelX.u, StartVelY.u);
-		GameServer()->Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
+		GameWorld()->ConsolePrint(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
 	}
 
 	m_TriggeredEvents |= m_Core.m_TriggeredEvents;
@@ -166,9 +186,9 @@ void CBotEntity::Snap(int SnappingClient)
 		return;
 
 	// write down the m_Core
-	if(!m_ReckoningTick || GameWorld()->m_Paused)
+	if(!m_ReckoningTick || GameWorld()->m_Paused || m_Sleeping)
 	{
-		// no dead reckoning when paused because the client doesn't know
+		// no dead reckoning when paused or sleeping because the client doesn't know
 		// how far to perform the reckoning
 		pCharacter->m_Tick = 0;
 		m_Core.Write(pCharacter);
@@ -267,11 +287,12 @@ bool CBotEntity::TakeDamage(vec2 Force, vec2 Source, int Dmg, CEntity *pFrom, in
 		int64_t Mask = CmaskOne(pChr->GetCID());
 		for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
 		{
-			if(GameServer()->m_apPlayers[i] && (GameServer()->m_apPlayers[i]->GetTeam() == TEAM_SPECTATORS || GameServer()->m_apPlayers[i]->m_DeadSpecMode) &&
-				GameServer()->m_apPlayers[i]->GetSpectatorID() == pChr->GetCID())
+			CPlayer *pSpectator = GameWorld()->GetPlayer(i);
+			if(pSpectator && (pSpectator->GetTeam() == TEAM_SPECTATORS || pSpectator->m_DeadSpecMode) &&
+				pSpectator->GetSpectatorID() == pChr->GetCID())
 				Mask |= CmaskOne(i);
 		}
-		GameWorld()->CreateSound(GameServer()->m_apPlayers[pChr->GetCID()]->m_ViewPos, SOUND_HIT, Mask);
+		GameWorld()->CreateSound(pChr->GetPlayer()->m_ViewPos, SOUND_HIT, Mask);
 	}
 
 	if(Dmg > 2)
@@ -285,13 +306,13 @@ bool CBotEntity::TakeDamage(vec2 Force, vec2 Source, int Dmg, CEntity *pFrom, in
 void CBotEntity::RandomAction()
 {
 	// random jump
-	if(random_int() % 1000 < 25)
+	if(GameWorld()->RandomInt() % 1000 < 25)
 		m_Input.m_Jump = 1;
 
 	// random move
-	if(random_int() % 1000 < 55)
+	if(GameWorld()->RandomInt() % 1000 < 55)
 	{
-		m_Input.m_Direction = random_int() % 3 - 1;
+		m_Input.m_Direction = GameWorld()->RandomInt() % 3 - 1;
 		if(m_Input.m_Direction)
 			m_CursorTarget = vec2(length(m_CursorTarget) * m_Input.m_Direction, 0.f);
 	}
@@ -310,7 +331,7 @@ void CBotEntity::TargetAction(CEntity *pTarget)
 		m_Input.m_Jump = 1;
 	}
 
-	if(distance(MoveTo, m_Pos) < 48.f && ((random_int() % 100) < 8) && m_ReloadTimer <= 0)
+	if(distance(MoveTo, m_Pos) < 48.f && ((GameWorld()->RandomInt() % 100) < 8) && m_ReloadTimer <= 0)
 		m_Input.m_Fire = 1;
 
 	m_CursorTarget = MoveTo - m_Pos;
@@ -334,7 +355,7 @@ void CBotEntity::Action()
 
 	// move cursor
 	vec2 Target = vec2(m_Input.m_TargetX, m_Input.m_TargetY);
-	float MouseSpeed = random_float() * 32.f + 8.f;
+	float MouseSpeed = GameWorld()->RandomFloat() * 32.f + 8.f;
 	if(distance(Target, m_CursorTarget) > MouseSpeed)
 	{
 		vec2 Direction = normalize(m_CursorTarget - Target);
@@ -20,6 +20,8 @@
 
 class CBotEntity : public CEntity, public CHealthComponent
 {
+	MACRO_ALLOC_POOL_WORLD()
+
 public:
 	// same as character's size
 	static const int ms_PhysSize = 28;
@@ -37,10 +39,15 @@ public:
 	Uuid GetBotID() const { return m_BotID; }
 	STeeInfo *GetTeeInfos() { return &m_TeeInfos; }
 
+	// a sleeping bot keeps its whole state and skips its ticks until it is woken
+	bool IsSleeping() const { return m_Sleeping; }
+	void SetSleeping(bool Sleeping);
+
 private:
 	STeeInfo m_TeeInfos;
 	Uuid m_BotID;
 	int m_Emote;
+	bool m_Sleeping;
 
 	int m_TriggeredEvents;
 	// the core for the physics
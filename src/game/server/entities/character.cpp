@@ -23,7 +23,7 @@
 #include "projectile.h"
 
 static Uuid s_Ninja = CalculateUuid("vanilla.ninja");
-MACRO_ALLOC_POOL_ID_IMPL(CCharacter, SERVER_MAX_CLIENTS)
+MACRO_ALLOC_POOL_WORLD_IMPL(CCharacter, CGameWorld::ENTTYPE_CHARACTER)
 
 // Character, "physical" player's part
 CCharacter::CCharacter(CGameWorld *pWorld) :
@@ -50,7 +50,7 @@ bool CCharacter::Spawn(CPlayer *pPlayer, vec2 Pos)
 	m_QueuedWeapon = -1;
 
 	m_pPlayer = pPlayer;
-	m_Pos = Pos;
+	SetPos(Pos);
 
 	m_Core.Reset();
 	m_Core.Init(&GameWorld()->m_Core, GameWorld()->Collision());
@@ -270,7 +270,7 @@ void CCharacter::FireWeapon()
 	{
 		char aBuf[256];
 		str_format(aBuf, sizeof(aBuf), "shot player='%d:%s' team=%d weapon=%s", m_pPlayer->GetCID(), Server()->ClientName(m_pPlayer->GetCID()), m_pPlayer->GetTeam(), WeaponManager()->GetWeapon(m_aWeapons[m_ActiveWeapon].m_Weapon)->Name());
-		GameServer()->Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
+		GameWorld()->ConsolePrint(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
 	}
 
 	WeaponManager()->GetWeapon(m_aWeapons[m_ActiveWeapon].m_Weapon)->OnFire(this, GameWorld(), ProjStartPos, Direction, &m_ReloadTimer);
@@ -459,12 +459,12 @@ void CCharacter::Tick()
 			PosTo += normalize(m_SitPos - m_Pos) * 4.0f;
 
 			m_Core.m_Pos = PosTo;
-			m_Pos = PosTo;
+			SetPos(PosTo);
 		}
 		else
 		{
 			m_Core.m_Pos = m_SitPos;
-			m_Pos = m_SitPos;
+			SetPos(m_SitPos);
 		}
 	}
 
@@ -506,7 +506,7 @@ void CCharacter::TickDefered()
 	bool StuckAfterMove = GameWorld()->Collision()->TestBox(m_Core.m_Pos, ColBox);
 	m_Core.Quantize();
 	bool StuckAfterQuant = GameWorld()->Collision()->TestBox(m_Core.m_Pos, ColBox);
-	m_Pos = m_Core.m_Pos;
+	SetPos(m_Core.m_Pos);
 
 	if(!StuckBefore && (StuckAfterMove || StuckAfterQuant))
 	{
@@ -531,15 +531,14 @@ void CCharacter::TickDefered()
 			StartVel.x, StartVel.y,
 			StartPosX.u, StartPosY.u,
 			StartVelX.u, StartVelY.u);
-		GameServer()->Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
+		GameWorld()->ConsolePrint(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
 	}
 
 	m_TriggeredEvents |= m_Core.m_TriggeredEvents;
 
 	if(m_pPlayer->GetTeam() == TEAM_SPECTATORS)
 	{
-		m_Pos.x = m_Input.m_TargetX;
-		m_Pos.y = m_Input.m_TargetY;
+		SetPos(vec2(m_Input.m_TargetX, m_Input.m_TargetY));
 	}
 	else if(m_Core.m_Death)
 	{
@@ -605,11 +604,12 @@ bool CCharacter::TakeDamage(vec2 Force, vec2 Source, int Dmg, CEntity *pFrom, in
 		int64_t Mask = CmaskOne(pChr->GetCID());
 		for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
 		{
-			if(GameServer()->m_apPlayers[i] && (GameServer()->m_apPlayers[i]->GetTeam() == TEAM_SPECTATORS || GameServer()->m_apPlayers[i]->m_DeadSpecMode) &&
-				GameServer()->m_apPlayers[i]->GetSpectatorID() == pChr->GetCID())
+			CPlayer *pSpectator = GameWorld()->GetPlayer(i);
+			if(pSpectator && (pSpectator->GetTeam() == TEAM_SPECTATORS || pSpectator->m_DeadSpecMode) &&
+				pSpectator->GetSpectatorID() == pChr->GetCID())
 				Mask |= CmaskOne(i);
 		}
-		GameWorld()->CreateSound(GameServer()->m_apPlayers[pChr->GetCID()]->m_ViewPos, SOUND_HIT, Mask);
+		GameWorld()->CreateSound(pChr->GetPlayer()->m_ViewPos, SOUND_HIT, Mask);
 	}
 
 	if(Dmg > 2)
@@ -636,7 +636,7 @@ void CCharacter::Die(CEntity *pKiller, int Weapon)
 		str_format(aBuf, sizeof(aBuf), "kill killer='%d:%d:%s' victim='%d:%d:%s' weapon=%d special=%d",
 			Killer, static_cast<CCharacter *>(pKiller)->GetPlayer()->GetTeam(), Server()->ClientName(Killer),
 			m_pPlayer->GetCID(), m_pPlayer->GetTeam(), Server()->ClientName(m_pPlayer->GetCID()), Weapon, ModeSpecial);
-		GameServer()->Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
+		GameWorld()->ConsolePrint(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
 	}
 
 	// send the kill message
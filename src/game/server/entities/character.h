@@ -29,7 +29,7 @@ struct SNinja
 
 class CCharacter : public CEntity, public CHealthComponent
 {
-	MACRO_ALLOC_POOL_ID()
+	MACRO_ALLOC_POOL_WORLD()
 
 public:
 	// character's size
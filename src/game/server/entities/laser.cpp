@@ -15,6 +15,8 @@
 #include "character.h"
 #include "laser.h"
 
+MACRO_ALLOC_POOL_WORLD_IMPL(CLaser, CGameWorld::ENTTYPE_LASER)
+
 CLaser::CLaser(CGameWorld *pGameWorld, vec2 Pos, vec2 Direction, float StartEnergy, CEntity *pOwner) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER, Pos),
 	COwnerComponent(this)
@@ -37,7 +39,7 @@ bool CLaser::Hit(vec2 From, vec2 To)
 		return false;
 
 	m_From = From;
-	m_Pos = At;
+	SetPos(At);
 	m_Energy = -1;
 	GameWorld()->GetComponent<CHealthComponent>(pHit)->TakeDamage(vec2(0.f, 0.f), normalize(To - From), g_pData->m_Weapons.m_aId[WEAPON_LASER].m_Damage, GetOwner(), WEAPON_LASER);
 	return true;
@@ -61,13 +63,13 @@ void CLaser::DoBounce()
 		{
 			// intersected
 			m_From = m_Pos;
-			m_Pos = To;
+			SetPos(To);
 
 			vec2 TempPos = m_Pos;
 			vec2 TempDir = m_Dir * 4.0f;
 
 			GameWorld()->Collision()->MovePoint(&TempPos, &TempDir, 1.0f, 0);
-			m_Pos = TempPos;
+			SetPos(TempPos);
 			m_Dir = normalize(TempDir);
 
 			m_Energy -= distance(m_From, m_Pos) + GameServer()->Tuning()->m_LaserBounceCost;
@@ -84,7 +86,7 @@ void CLaser::DoBounce()
 		if(!Hit(m_Pos, To))
 		{
 			m_From = m_Pos;
-			m_Pos = To;
+			SetPos(To);
 			m_Energy = -1;
 		}
 	}
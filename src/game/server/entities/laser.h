@@ -15,6 +15,8 @@
 
 class CLaser : public CEntity, public COwnerComponent
 {
+	MACRO_ALLOC_POOL_WORLD()
+
 public:
 	CLaser(CGameWorld *pGameWorld, vec2 Pos, vec2 Direction, float StartEnergy, CEntity *pOwner);
 
@@ -17,6 +17,8 @@
 #include "character.h"
 #include "pickup.h"
 
+MACRO_ALLOC_POOL_WORLD_IMPL(CPickup, CGameWorld::ENTTYPE_PICKUP)
+
 CPickup::CPickup(CGameWorld *pGameWorld, int Type, vec2 Pos) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_PICKUP, Pos, PickupPhysSize)
 {
@@ -143,7 +145,7 @@ void CPickup::Tick()
 			char aBuf[256];
 			str_format(aBuf, sizeof(aBuf), "pickup player='%d:%s' item=%d",
 				pChr->GetPlayer()->GetCID(), Server()->ClientName(pChr->GetPlayer()->GetCID()), m_Type);
-			GameServer()->Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
+			GameWorld()->ConsolePrint(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
 			int RespawnTime = g_pData->m_aPickups[m_Type].m_Respawntime;
 			if(RespawnTime >= 0)
 				m_SpawnTick = Server()->Tick() + Server()->TickSpeed() * RespawnTime;
@@ -17,6 +17,8 @@ const int PickupPhysSize = 14;
 
 class CPickup : public CEntity
 {
+	MACRO_ALLOC_POOL_WORLD()
+
 public:
 	CPickup(CGameWorld *pGameWorld, int Type, vec2 Pos);
 
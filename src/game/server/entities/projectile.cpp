@@ -15,6 +15,8 @@
 #include "character.h"
 #include "projectile.h"
 
+MACRO_ALLOC_POOL_WORLD_IMPL(CProjectile, CGameWorld::ENTTYPE_PROJECTILE)
+
 CProjectile::CProjectile(CGameWorld *pGameWorld, int Type, CEntity *pOwner, vec2 Pos, vec2 Dir, int Span,
 	int Damage, bool Explosive, float Force, int SoundImpact, int Weapon) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_PROJECTILE, vec2(round_to_int(Pos.x), round_to_int(Pos.y))),
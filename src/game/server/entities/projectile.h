@@ -21,6 +21,8 @@ enum
 
 class CProjectile : public CEntity, public COwnerComponent
 {
+	MACRO_ALLOC_POOL_WORLD()
+
 public:
 	CProjectile(CGameWorld *pGameWorld, int Type, CEntity *pFrom, vec2 Pos, vec2 Dir, int Span,
 		int Damage, bool Explosive, float Force, int SoundImpact, int Weapon);
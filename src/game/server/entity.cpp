@@ -25,6 +25,8 @@ CEntity::CEntity(CGameWorld *pGameWorld, int ObjType, vec2 Pos, int ProximityRad
 
 	m_ProximityRadius = ProximityRadius;
 
+	m_ComponentMask = 0;
+
 	m_MarkedForDestroy = false;
 	m_Pos = Pos;
 }
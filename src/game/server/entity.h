@@ -14,6 +14,8 @@
 #include <base/uuid.h>
 #include <base/vmath.h>
 
+#include <game/spatialgrid.h>
+
 #include "alloc.h"
 #include "gameworld.h"
 
@@ -21,7 +23,7 @@
 	Class: Entity
 		Basic entity class.
 */
-class CEntity
+class CEntity : public CSpatialGridItem
 {
 	MACRO_ALLOC_HEAP()
 
@@ -44,6 +46,10 @@ private:
 	*/
 	float m_ProximityRadius;
 
+	/* Components */
+	unsigned m_ComponentMask;
+	void *m_apComponents[CGameWorld::MAX_ENTITY_COMPONENTS];
+
 	/* State */
 	bool m_MarkedForDestroy;
 
@@ -59,6 +65,19 @@ protected:
 	/* Getters */
 	int GetID() const { return m_ID; }
 
+	/* Setters */
+
+	/*
+		Function: SetPos
+			Moves the entity, keeps the world's spatial grid and spawn evaluator up to date.
+			Always use this instead of writing m_Pos.
+	*/
+	void SetPos(vec2 Pos)
+	{
+		m_Pos = Pos;
+		m_pGameWorld->OnEntityMoved(this);
+	}
+
 public:
 	/* Constructor */
 	CEntity(CGameWorld *pGameWorld, int Objtype, vec2 Pos, int ProximityRadius = 0);
@@ -81,6 +100,7 @@ public:
 	bool IsMarkedForDestroy() const { return m_MarkedForDestroy; }
 
 	int GetObjType() const { return m_ObjType; }
+	bool HasComponent(int ComponentID) const { return m_ComponentMask & (1u << ComponentID); }
 
 	/* Setters */
 	void MarkForDestroy() { m_MarkedForDestroy = true; }
@@ -19,6 +19,7 @@
 CEventHandler::CEventHandler()
 {
 	m_pGameServer = 0;
+	mem_zero(&m_Stats, sizeof(m_Stats));
 	Clear();
 }
 
@@ -29,39 +30,34 @@ void CEventHandler::SetGameServer(CGameContext *pGameServer)
 
 void CEventHandler::Create(void *pData, int Type, int Size, int64_t Mask)
 {
-	if(m_NumEvents >= MAX_EVENTS_TOTAL || m_CurrentOffset + Size > MAX_EVENTS_TOTAL * 64)
+	m_Stats.m_NumCreated++;
+	if((int) m_vEvents.size() >= MAX_EVENTS_TOTAL)
+	{
+		m_Stats.m_NumDropped++;
 		return;
+	}
 
-	int Offset = m_CurrentOffset;
-	mem_copy(m_aSharedData + Offset, pData, Size);
-	m_CurrentOffset += Size;
+	int Offset = m_vData.size();
+	m_vData.insert(m_vData.end(), static_cast<char *>(pData), static_cast<char *>(pData) + Size);
 
-	SEventRef &EventRef = m_aEvents[m_NumEvents++];
+	SEventRef EventRef;
 	EventRef.m_DataOffset = Offset;
 	EventRef.m_Type = Type;
 	EventRef.m_Size = Size;
 	EventRef.m_X = static_cast<CNetEvent_Common *>(pData)->m_X;
 	EventRef.m_Y = static_cast<CNetEvent_Common *>(pData)->m_Y;
+	EventRef.m_Mask = Mask;
+	m_vEvents.push_back(EventRef);
 
-	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
-	{
-		if(CmaskIsSet(Mask, i))
-		{
-			int &Num = m_aClientNumEvents[i];
-			if(Num < MAX_EVENTS)
-				m_aClientEventList[i][Num++] = m_NumEvents - 1;
-		}
-	}
+	if((int) m_vEvents.size() > m_Stats.m_NumPeak)
+		m_Stats.m_NumPeak = m_vEvents.size();
 }
 
 void CEventHandler::Clear()
 {
-	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
-	{
-		m_aClientNumEvents[i] = 0;
-	}
-	m_CurrentOffset = 0;
-	m_NumEvents = 0;
+	// keeps the capacity, busy worlds stop allocating after a few ticks
+	m_vData.clear();
+	m_vEvents.clear();
 }
 
 void CEventHandler::Snap(int SnappingClient)
@@ -69,16 +65,27 @@ void CEventHandler::Snap(int SnappingClient)
 	if(SnappingClient == -1)
 		return;
 
-	for(int i = 0; i < m_aClientNumEvents[SnappingClient]; i++)
+	int NumSent = 0;
+	for(int i = 0; i < (int) m_vEvents.size(); i++)
 	{
-		int EventID = m_aClientEventList[SnappingClient][i];
-		const SEventRef &EventRef = m_aEvents[EventID];
+		const SEventRef &EventRef = m_vEvents[i];
+		if(!CmaskIsSet(EventRef.m_Mask, SnappingClient))
+			continue;
 
 		if(NetworkClipped(SnappingClient, vec2(EventRef.m_X, EventRef.m_Y), GameServer()))
 			continue;
 
-		void *pData = GameServer()->Server()->SnapNewItem(EventRef.m_Type, EventID, EventRef.m_Size);
+		if(NumSent >= MAX_EVENTS)
+		{
+			m_Stats.m_NumDroppedClient++;
+			continue;
+		}
+
+		void *pData = GameServer()->Server()->SnapNewItem(EventRef.m_Type, i, EventRef.m_Size);
 		if(pData)
-			mem_copy(pData, m_aSharedData + EventRef.m_DataOffset, EventRef.m_Size);
+		{
+			mem_copy(pData, m_vData.data() + EventRef.m_DataOffset, EventRef.m_Size);
+			NumSent++;
+		}
 	}
 }
@@ -12,6 +12,8 @@
 #define GAME_SERVER_EVENTHANDLER_H
 
 #include <engine/shared/protocol.h>
+
+#include <vector>
 //
 class CEventHandler
 {
@@ -22,19 +24,30 @@ class CEventHandler
 		int m_Size;
 		int m_X;
 		int m_Y;
+		int64_t m_Mask;
 	};
-	static const int MAX_EVENTS = 32;
-	static const int MAX_EVENTS_TOTAL = 256;
-	char m_aSharedData[MAX_EVENTS_TOTAL * 64];
-	int m_CurrentOffset;
+	// events a single client gets per snapshot, after culling by view position
+	static const int MAX_EVENTS = 64;
+	// the buffers grow on demand, this only bounds a runaway world
+	static const int MAX_EVENTS_TOTAL = 4096;
+	std::vector<char> m_vData;
+	std::vector<SEventRef> m_vEvents;
 
-	SEventRef m_aEvents[MAX_EVENTS_TOTAL];
-	int m_NumEvents;
+	class CGameContext *m_pGameServer;
 
-	int m_aClientEventList[SERVER_MAX_CLIENTS][MAX_EVENTS];
-	int m_aClientNumEvents[SERVER_MAX_CLIENTS];
+public:
+	struct CStats
+	{
+		int64_t m_NumCreated;
+		// dropped because the buffer hit MAX_EVENTS_TOTAL
+		int64_t m_NumDropped;
+		// dropped for a single client which already got MAX_EVENTS
+		int64_t m_NumDroppedClient;
+		int m_NumPeak;
+	};
 
-	class CGameContext *m_pGameServer;
+private:
+	CStats m_Stats;
 
 public:
 	CGameContext *GameServer() const { return m_pGameServer; }
@@ -44,6 +57,9 @@ public:
 	void Create(void *pData, int Type, int Size, int64_t Mask = -1);
 	void Clear();
 	void Snap(int SnappingClient);
+
+	int NumEvents() const { return m_vEvents.size(); }
+	const CStats &Stats() const { return m_Stats; }
 };
 
 #endif
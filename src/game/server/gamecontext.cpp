@@ -29,7 +29,9 @@
 #include "player.h"
 #include "weapons.h"
 
+#include <algorithm>
 #include <cstdarg>
+#include <vector>
 
 enum
 {
@@ -72,8 +74,11 @@ CGameContext::CGameContext()
 
 CGameContext::~CGameContext()
 {
+	// players first, their characters live in the entity pools of the worlds
 	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
 		delete m_apPlayers[i];
+	for(auto &[WorldID, pWorld] : m_upWorlds)
+		delete pWorld;
 	if(!m_Resetting)
 	{
 		delete m_pVoteOptionHeap;
@@ -171,9 +176,8 @@ void CGameContext::SendChat(int ChatterClientID, int Mode, int To, const char *p
 	}
 }
 
-void CGameContext::SendChatTarget(int To, const char *pText, EChatPrefix Prefix)
+static void FormatChatLine(char *pLine, int LineSize, const char *pText, EChatPrefix Prefix)
 {
-	char aLine[512];
 	if(Prefix != EChatPrefix::NONE)
 	{
 		const char *pPrefix = nullptr;
@@ -185,10 +189,16 @@ void CGameContext::SendChatTarget(int To, const char *pText, EChatPrefix Prefix)
 		case EChatPrefix::QUESTION:
 		default: pPrefix = "[?]"; break;
 		}
-		str_format(aLine, sizeof(aLine), "%s %s", pPrefix, pText);
+		str_format(pLine, LineSize, "%s %s", pPrefix, pText);
 	}
 	else
-		str_copy(aLine, pText, sizeof(aLine));
+		str_copy(pLine, pText, LineSize);
+}
+
+void CGameContext::SendChatTarget(int To, const char *pText, EChatPrefix Prefix)
+{
+	char aLine[512];
+	FormatChatLine(aLine, sizeof(aLine), pText, Prefix);
 
 	CNetMsg_Sv_Chat Msg;
 	Msg.m_Mode = CHAT_ALL;
@@ -198,16 +208,31 @@ void CGameContext::SendChatTarget(int To, const char *pText, EChatPrefix Prefix)
 	Server()->SendPackMsg(&Msg, MSGFLAG_VITAL, To);
 }
 
+void CGameContext::SendChatGroup(const int *pClientIDs, int NumClients, const char *pText, EChatPrefix Prefix)
+{
+	char aLine[512];
+	FormatChatLine(aLine, sizeof(aLine), pText, Prefix);
+
+	CNetMsg_Sv_Chat Msg;
+	Msg.m_Mode = CHAT_ALL;
+	Msg.m_ClientID = -1;
+	Msg.m_pMessage = aLine;
+	Msg.m_TargetID = -1;
+	CMsgPacker Packer(Msg.MsgID(), false);
+	if(Msg.Pack(&Packer))
+		return;
+
+	for(int i = 0; i < NumClients; i++)
+		Server()->SendMsg(&Packer, MSGFLAG_VITAL, pClientIDs[i]);
+}
+
 void CGameContext::SendChatTargetLocalize(int To, const char *pText, const char *pContext, EChatPrefix Prefix)
 {
 	if(To == -1)
 	{
-		for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
-		{
-			if(!Server()->ClientIngame(i))
-				continue;
-			SendChatTargetLocalize(i, pText, pContext, Prefix);
-		}
+		ForEachLanguageGroup([&](const char *pLanguage, const int *pClientIDs, int NumClients) {
+			SendChatGroup(pClientIDs, NumClients, Server()->Localize(pLanguage, pText, pContext), Prefix);
+		});
 		return;
 	}
 	SendChatTarget(To, Server()->Localize(To, pText, pContext), Prefix);
@@ -448,11 +473,36 @@ void CGameContext::AbortVoteOnTeamChange(int ClientID)
 
 void CGameContext::OnTick()
 {
-	for(auto &[WorldID, pWorld] : m_upWorlds)
+	if(Config()->m_SvWorldThreads > 0 && m_upWorlds.size() > 1)
 	{
-		// copy tuning
-		pWorld->m_Core.m_Tuning = m_Tuning;
-		pWorld->Tick();
+		// worlds about to reset touch the shared controller, keep them on the main thread
+		m_vpTickWorlds.clear();
+		for(auto &[WorldID, pWorld] : m_upWorlds)
+		{
+			pWorld->m_Core.m_Tuning = m_Tuning;
+			if(pWorld->m_ResetRequested)
+				pWorld->Tick();
+			else
+				m_vpTickWorlds.push_back(pWorld);
+		}
+
+		m_WorldTickPool.Run(m_vpTickWorlds, Config()->m_SvWorldThreads);
+
+		// merge in world order so events and messages stay deterministic
+		for(CGameWorld *pWorld : m_vpTickWorlds)
+			pWorld->MergeParallelTick();
+	}
+	else
+	{
+		if(m_WorldTickPool.NumThreads())
+			m_WorldTickPool.Shutdown();
+
+		for(auto &[WorldID, pWorld] : m_upWorlds)
+		{
+			// copy tuning
+			pWorld->m_Core.m_Tuning = m_Tuning;
+			pWorld->Tick();
+		}
 	}
 	// if(world.paused) // make sure that the game object always updates
 	GameModeManager()->OnTick();
@@ -1159,6 +1209,62 @@ void CGameContext::ConTunes(IConsole::IResult *pResult, void *pUserData)
 	}
 }
 
+void CGameContext::ConEntityPools(IConsole::IResult *pResult, void *pUserData)
+{
+	static const char *s_apTypeNames[CGameWorld::NUM_ENTTYPES] = {"projectile", "laser", "pickup", "character", "flag", "bot"};
+
+	CGameContext *pSelf = (CGameContext *) pUserData;
+	char aBuf[256];
+	for(auto &[WorldID, pWorld] : pSelf->m_upWorlds)
+	{
+		str_format(aBuf, sizeof(aBuf), "world '%s'", pSelf->Server()->GetMapName(WorldID));
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "entity_pools", aBuf);
+		for(int i = 0; i < CGameWorld::NUM_ENTTYPES; i++)
+		{
+			const CEntityPool::CStats &Stats = pWorld->EntityPool(i)->Stats();
+			if(!Stats.m_NumAllocs)
+				continue;
+			str_format(aBuf, sizeof(aBuf), "  %s: live=%d peak=%d slabs=%d allocs=%lld frees=%lld", s_apTypeNames[i],
+				Stats.m_NumLive, Stats.m_NumLivePeak, Stats.m_NumSlabs, (long long) Stats.m_NumAllocs, (long long) Stats.m_NumFrees);
+			pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "entity_pools", aBuf);
+		}
+	}
+}
+
+void CGameContext::ConEventStats(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameContext *pSelf = (CGameContext *) pUserData;
+	char aBuf[256];
+	for(auto &[WorldID, pWorld] : pSelf->m_upWorlds)
+	{
+		const CEventHandler::CStats &Stats = pWorld->EventHandler()->Stats();
+		str_format(aBuf, sizeof(aBuf), "world '%s': created=%lld peak=%d dropped=%lld dropped_client=%lld", pSelf->Server()->GetMapName(WorldID),
+			(long long) Stats.m_NumCreated, Stats.m_NumPeak, (long long) Stats.m_NumDropped, (long long) Stats.m_NumDroppedClient);
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "event_stats", aBuf);
+	}
+}
+
+void CGameContext::ConBotStats(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameContext *pSelf = (CGameContext *) pUserData;
+	char aBuf[256];
+	for(auto &[WorldID, pWorld] : pSelf->m_upWorlds)
+	{
+		if(!pWorld->BotManager())
+			continue;
+		const CBotManager::CStats &Stats = pWorld->BotManager()->Stats();
+		str_format(aBuf, sizeof(aBuf), "world '%s': spawns=%d sleeping=%d wakeups=%lld", pSelf->Server()->GetMapName(WorldID),
+			(int) pWorld->m_avSpawnPoints[2].size(), Stats.m_NumSleeping, (long long) Stats.m_NumWakeups);
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "bot_stats", aBuf);
+		str_format(aBuf, sizeof(aBuf), "  slots: updates=%lld skipped=%lld changes=%lld drop_msgs=%lld info_msgs=%lld",
+			(long long) Stats.m_NumUpdates, (long long) Stats.m_NumSkipped, (long long) Stats.m_NumSlotChanges, (long long) Stats.m_NumDropMsgs, (long long) Stats.m_NumInfoMsgs);
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "bot_stats", aBuf);
+		str_format(aBuf, sizeof(aBuf), "  time: tick=%.2fms postsnap=%.2fms",
+			Stats.m_TickTime * 1000.0 / time_freq(), Stats.m_PostSnapTime * 1000.0 / time_freq());
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "bot_stats", aBuf);
+	}
+}
+
 void CGameContext::ConSay(IConsole::IResult *pResult, void *pUserData)
 {
 	CGameContext *pSelf = (CGameContext *) pUserData;
@@ -1389,6 +1495,10 @@ void CGameContext::OnConsoleInit()
 	Console()->Register("remove_vote", "s[option]", CFGFLAG_SERVER, ConRemoveVote, this, "remove a voting option");
 	Console()->Register("clear_votes", "", CFGFLAG_SERVER, ConClearVotes, this, "Clears the voting options");
 	Console()->Register("vote", "r['yes'|'no']", CFGFLAG_SERVER, ConVote, this, "Force a vote to yes/no");
+
+	Console()->Register("entity_pools", "", CFGFLAG_SERVER, ConEntityPools, this, "Show the entity allocation counters of every world");
+	Console()->Register("event_stats", "", CFGFLAG_SERVER, ConEventStats, this, "Show the event counters of every world");
+	Console()->Register("bot_stats", "", CFGFLAG_SERVER, ConBotStats, this, "Show the bot sleep and slot assignment counters of every world");
 }
 
 void CGameContext::NewCommandHook(const CCommandManager::CCommand *pCommand, void *pContext)
@@ -1515,7 +1625,6 @@ void CGameContext::OnInit()
 	m_pConfig = Kernel()->RequestInterface<IConfigManager>()->Values();
 	m_pConsole = Kernel()->RequestInterface<IConsole>();
 	m_pStorage = Kernel()->RequestInterface<IStorage>();
-	m_Events.SetGameServer(this);
 	m_CommandManager.Init(m_pConsole, this, NewCommandHook, RemoveCommandHook);
 
 	// HACK: only set static size for items, which were available in the first 0.7 release
@@ -1574,7 +1683,7 @@ void CGameContext::OnSnap(int ClientID)
 
 	m_apPlayers[ClientID]->GameWorld()->Snap(ClientID);
 	m_apPlayers[ClientID]->GameWorld()->GameController()->Snap(ClientID);
-	m_Events.Snap(ClientID);
+	m_apPlayers[ClientID]->GameWorld()->EventHandler()->Snap(ClientID);
 
 	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
 	{
@@ -1582,12 +1691,18 @@ void CGameContext::OnSnap(int ClientID)
 			m_apPlayers[i]->Snap(ClientID);
 	}
 }
-void CGameContext::OnPreSnap() {}
+void CGameContext::OnPreSnap()
+{
+	for(auto &pPlayer : m_apPlayers)
+	{
+		if(pPlayer)
+			pPlayer->PreSnap();
+	}
+}
 void CGameContext::OnPostSnap()
 {
 	for(auto &[WorldID, pWorld] : m_upWorlds)
 		pWorld->PostSnap();
-	m_Events.Clear();
 	GameModeManager()->OnPostSnap();
 }
 
@@ -1627,10 +1742,10 @@ int NetworkClipped(int SnappingClient, vec2 CheckPos, CGameContext *pGameServer)
 	float dx = pGameServer->m_apPlayers[SnappingClient]->m_ViewPos.x - CheckPos.x;
 	float dy = pGameServer->m_apPlayers[SnappingClient]->m_ViewPos.y - CheckPos.y;
 
-	if(absolute(dx) > 1000.0f || absolute(dy) > 800.0f)
+	if(absolute(dx) > NETWORK_CLIP_X || absolute(dy) > NETWORK_CLIP_Y)
 		return 1;
 
-	if(distance(pGameServer->m_apPlayers[SnappingClient]->m_ViewPos, CheckPos) > 1100.0f)
+	if(distance(pGameServer->m_apPlayers[SnappingClient]->m_ViewPos, CheckPos) > NETWORK_CLIP_RADIUS)
 		return 1;
 
 	return 0;
@@ -1641,6 +1756,14 @@ bool CGameContext::CheckWorldExists(Uuid WorldID)
 	return m_upWorlds.count(WorldID);
 }
 
+static void CreateMapEntity(IGameController *pController, CGameWorld *pWorld, int Index, vec2 Pos)
+{
+	if(Index < ENTITY_OFFSET)
+		pController->OnExtraTile(pWorld, Index, Pos);
+	else
+		pController->OnEntity(pWorld, Index - ENTITY_OFFSET, Pos);
+}
+
 void CGameContext::LoadNewWorld(Uuid WorldID)
 {
 	CGameWorld *pWorld = new CGameWorld();
@@ -1652,8 +1775,20 @@ void CGameContext::LoadNewWorld(Uuid WorldID)
 	m_Layers.Init(Kernel());
 	pWorld->SetCollision(std::make_shared<CCollision>());
 	pWorld->Collision()->Init(&m_Layers);
+	pWorld->Collision()->SetSweptMoveBox(Config()->m_SvSweptCollision);
+	pWorld->InitEntityGrid();
+
+	// create all entities from the game layer, the entity index saves the scan
+	const CMapItemEntity *pEntities;
+	int NumEntities;
+	if(m_Layers.GameEntities(&pEntities, &NumEntities))
+	{
+		for(int i = 0; i < NumEntities; i++)
+			CreateMapEntity(pController, pWorld, pEntities[i].m_Index, vec2(pEntities[i].m_X * 32.0f + 16.0f, pEntities[i].m_Y * 32.0f + 16.0f));
+		m_upWorlds[WorldID] = pWorld;
+		return;
+	}
 
-	// create all entities from the game layer
 	CMapItemLayerTilemap *pTileMap = m_Layers.GameLayer();
 	CTile *pTiles = (CTile *) Kernel()->RequestInterface<IMap>()->GetData(pTileMap->m_Data);
 	for(int y = 0; y < pTileMap->m_Height; y++)
@@ -1661,17 +1796,8 @@ void CGameContext::LoadNewWorld(Uuid WorldID)
 		for(int x = 0; x < pTileMap->m_Width; x++)
 		{
 			int Index = pTiles[y * pTileMap->m_Width + x].m_Index;
-
-			if(Index > TILE_NOHOOK && Index < ENTITY_OFFSET)
-			{
-				vec2 Pos(x * 32.0f + 16.0f, y * 32.0f + 16.0f);
-				pController->OnExtraTile(pWorld, Index, Pos);
-			}
-			else if(Index >= ENTITY_OFFSET)
-			{
-				vec2 Pos(x * 32.0f + 16.0f, y * 32.0f + 16.0f);
-				pController->OnEntity(pWorld, Index - ENTITY_OFFSET, Pos);
-			}
+			if(Index > TILE_NOHOOK)
+				CreateMapEntity(pController, pWorld, Index, vec2(x * 32.0f + 16.0f, y * 32.0f + 16.0f));
 		}
 	}
 	m_upWorlds[WorldID] = pWorld;
@@ -1682,3 +1808,17 @@ void CGameContext::SwitchPlayerWorld(int ClientID, Uuid WorldID)
 	if(m_apPlayers[ClientID])
 		m_apPlayers[ClientID]->SwitchWorld(m_upWorlds[WorldID]);
 }
+
+unsigned CGameContext::WorldHash()
+{
+	// the world map has no stable order, go by uuid
+	std::vector<Uuid> vWorldIDs;
+	for(auto &[WorldID, pWorld] : m_upWorlds)
+		vWorldIDs.push_back(WorldID);
+	std::sort(vWorldIDs.begin(), vWorldIDs.end());
+
+	unsigned Hash = 0;
+	for(const Uuid &WorldID : vWorldIDs)
+		Hash = Hash * 31 + m_upWorlds[WorldID]->Hash();
+	return Hash;
+}
@@ -22,6 +22,7 @@
 #include "eventhandler.h"
 #include "gamemenu.h"
 #include "gameworld.h"
+#include "worldtickpool.h"
 
 #include <cstdio>
 
@@ -79,6 +80,9 @@ class CGameContext : public IGameServer
 	static void ConRemoveVote(IConsole::IResult *pResult, void *pUserData);
 	static void ConClearVotes(IConsole::IResult *pResult, void *pUserData);
 	static void ConVote(IConsole::IResult *pResult, void *pUserData);
+	static void ConEntityPools(IConsole::IResult *pResult, void *pUserData);
+	static void ConEventStats(IConsole::IResult *pResult, void *pUserData);
+	static void ConBotStats(IConsole::IResult *pResult, void *pUserData);
 	static void ConchainSpecialMotdupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainSettingUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 
@@ -108,10 +112,11 @@ public:
 
 	void Clear();
 
-	CEventHandler m_Events;
 	class CPlayer *m_apPlayers[SERVER_MAX_CLIENTS];
 
 	std::unordered_map<Uuid, CGameWorld *> m_upWorlds;
+	CWorldTickPool m_WorldTickPool;
+	std::vector<CGameWorld *> m_vpTickWorlds;
 	CCommandManager m_CommandManager;
 
 	CCommandManager *CommandManager() { return &m_CommandManager; }
@@ -177,17 +182,44 @@ public:
 	{
 		if(To == -1)
 		{
-			for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
-			{
-				if(!Server()->ClientIngame(i))
-					continue;
-				SendChatTargetFormat(i, Server()->Localize(To, pFormat, pContext), Prefix, Args...);
-			}
+			ForEachLanguageGroup([&](const char *pLanguage, const int *pClientIDs, int NumClients) {
+				char aLine[512];
+				sugarformat::format_to(aLine, sizeof(aLine), Server()->Localize(pLanguage, pFormat, pContext), Args...);
+				SendChatGroup(pClientIDs, NumClients, aLine, Prefix);
+			});
 			return;
 		}
 		SendChatTargetFormat(To, Server()->Localize(To, pFormat, pContext), Prefix, Args...);
 	};
 
+	// sends one packed chat line to every listed client
+	void SendChatGroup(const int *pClientIDs, int NumClients, const char *pText, EChatPrefix Prefix = EChatPrefix::NONE);
+
+	// calls Fn(pLanguage, pClientIDs, NumClients) once per language of the ingame clients
+	template<typename F>
+	void ForEachLanguageGroup(const F &Fn)
+	{
+		int aClientIDs[SERVER_MAX_CLIENTS];
+		bool aGrouped[SERVER_MAX_CLIENTS] = {false};
+		for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+		{
+			if(aGrouped[i] || !Server()->ClientIngame(i))
+				continue;
+
+			const char *pLanguage = Server()->ClientLanguage(i);
+			int NumClients = 0;
+			for(int j = i; j < SERVER_MAX_CLIENTS; j++)
+			{
+				if(!aGrouped[j] && Server()->ClientIngame(j) && str_comp(Server()->ClientLanguage(j), pLanguage) == 0)
+				{
+					aGrouped[j] = true;
+					aClientIDs[NumClients++] = j;
+				}
+			}
+			Fn(pLanguage, aClientIDs, NumClients);
+		}
+	}
+
 	void SendGameMsg(int GameMsgID, int ClientID);
 	void SendGameMsg(int GameMsgID, int ParaI1, int ClientID);
 	void SendGameMsg(int GameMsgID, int ParaI1, int ParaI2, int ParaI3, int ClientID);
@@ -237,6 +269,8 @@ public:
 	bool CheckWorldExists(Uuid WorldID) override;
 	void LoadNewWorld(Uuid WorldID) override;
 	void SwitchPlayerWorld(int ClientID, Uuid WorldID) override;
+
+	unsigned WorldHash() override;
 };
 
 inline int64_t CmaskAll() { return -1; }
@@ -244,6 +278,11 @@ inline int64_t CmaskOne(int ClientID) { return (int64_t) 1 << ClientID; }
 inline int64_t CmaskAllExceptOne(int ClientID) { return CmaskAll() ^ CmaskOne(ClientID); }
 inline bool CmaskIsSet(int64_t Mask, int ClientID) { return (Mask & CmaskOne(ClientID)) != 0; }
 
+// NetworkClipped keeps the box of half size NETWORK_CLIP_X by NETWORK_CLIP_Y around the view, with its corners cut off
+constexpr float NETWORK_CLIP_X = 1000.0f;
+constexpr float NETWORK_CLIP_Y = 800.0f;
+constexpr float NETWORK_CLIP_RADIUS = 1100.0f;
+
 int NetworkClipped(int SnappingClient, vec2 CheckPos, CGameContext *pGameServer);
 
 #endif // GAME_SERVER_GAMECONTEXT_H
@@ -124,12 +124,14 @@ int IGameController::OnCharacterDeath(CCharacter *pVictim, CPlayer *pKiller, int
 	if(Weapon == WEAPON_SELF)
 		pVictim->GetPlayer()->m_RespawnTick = Server()->Tick() + Server()->TickSpeed() * 3.0f;
 
-	// update spectator modes for dead players in survival
+	// update spectator modes for dead players in survival, they can be in other worlds
 	if(m_GameFlags & GAMEFLAG_SURVIVAL)
 	{
-		for(int i = 0; i < SERVER_MAX_CLIENTS; ++i)
-			if(GameServer()->m_apPlayers[i] && GameServer()->m_apPlayers[i]->m_DeadSpecMode)
-				GameServer()->m_apPlayers[i]->UpdateDeadSpecMode();
+		pVictim->GameWorld()->Defer([this]() {
+			for(int i = 0; i < SERVER_MAX_CLIENTS; ++i)
+				if(GameServer()->m_apPlayers[i] && GameServer()->m_apPlayers[i]->m_DeadSpecMode)
+					GameServer()->m_apPlayers[i]->UpdateDeadSpecMode();
+		});
 	}
 
 	return 0;
@@ -163,13 +165,13 @@ bool IGameController::OnEntity(CGameWorld *pGameWorld, int Index, vec2 Pos)
 	switch(Index)
 	{
 	case ENTITY_SPAWN: // Player
-		pGameWorld->m_aaSpawnPoints[0][pGameWorld->m_aNumSpawnPoints[0]++] = Pos;
+		pGameWorld->m_avSpawnPoints[0].push_back(Pos);
 		break;
 	case ENTITY_SPAWN_RED: // NPC1
-		pGameWorld->m_aaSpawnPoints[1][pGameWorld->m_aNumSpawnPoints[1]++] = Pos;
+		pGameWorld->m_avSpawnPoints[1].push_back(Pos);
 		break;
 	case ENTITY_SPAWN_BLUE:
-		pGameWorld->m_aaSpawnPoints[2][pGameWorld->m_aNumSpawnPoints[2]++] = Pos;
+		pGameWorld->m_avSpawnPoints[2].push_back(Pos);
 		break;
 	case ENTITY_ARMOR_1:
 		Type = PICKUP_ARMOR;
@@ -193,7 +195,7 @@ bool IGameController::OnEntity(CGameWorld *pGameWorld, int Index, vec2 Pos)
 
 	if(Type != -1)
 	{
-		new CPickup(pGameWorld, Type, Pos);
+		new(pGameWorld) CPickup(pGameWorld, Type, Pos);
 		return true;
 	}
 
@@ -317,13 +319,13 @@ bool IGameController::IsFriendlyFire(class CEntity *pEnt1, class CEntity *pEnt2)
 	{
 		if(pEnt1->GetObjType() != CGameWorld::ENTTYPE_CHARACTER || pEnt2->GetObjType() != CGameWorld::ENTTYPE_CHARACTER)
 			return false;
-		int ClientID1 = static_cast<CCharacter *>(pEnt1)->GetCID();
-		int ClientID2 = static_cast<CCharacter *>(pEnt2)->GetCID();
+		CPlayer *pPlayer1 = static_cast<CCharacter *>(pEnt1)->GetPlayer();
+		CPlayer *pPlayer2 = static_cast<CCharacter *>(pEnt2)->GetPlayer();
 
-		if(!GameServer()->m_apPlayers[ClientID1] || !GameServer()->m_apPlayers[ClientID2])
+		if(!pPlayer1 || !pPlayer2)
 			return false;
 
-		if(!Config()->m_SvTeamdamage && GameServer()->m_apPlayers[ClientID1]->GetTeam() == GameServer()->m_apPlayers[ClientID2]->GetTeam())
+		if(!Config()->m_SvTeamdamage && pPlayer1->GetTeam() == pPlayer2->GetTeam())
 			return true;
 	}
 
@@ -405,50 +407,19 @@ bool IGameController::CanSpawn(CGameWorld *pWorld, int Team, vec2 *pOutPos) cons
 	return Eval.m_Got;
 }
 
-float IGameController::EvaluateSpawnPos(CSpawnEval *pEval, vec2 Pos) const
-{
-	float Score = 0.0f;
-	CCharacter *pC = (CCharacter *) pEval->m_pWorld->FindFirst(CGameWorld::ENTTYPE_CHARACTER);
-	for(; pC; pC = (CCharacter *) pC->TypeNext())
-	{
-		// team mates are not as dangerous as enemies
-		float Scoremod = 1.0f;
-		if(pEval->m_FriendlyTeam != -1 && pC->GetPlayer()->GetTeam() == pEval->m_FriendlyTeam)
-			Scoremod = 0.5f;
-
-		float d = distance(Pos, pC->GetPos());
-		Score += Scoremod * (d == 0 ? 1000000000.0f : 1.0f / d);
-	}
-
-	return Score;
-}
-
 void IGameController::EvaluateSpawnType(CSpawnEval *pEval, int Type) const
 {
 	// get spawn point
-	for(unsigned i = 0; i < pEval->m_pWorld->m_aNumSpawnPoints[Type]; i++)
+	CSpawnEvaluator *pSpawns = pEval->m_pWorld->SpawnEvaluator();
+	for(int i = 0; i < pSpawns->NumSpawnPoints(Type); i++)
 	{
 		// check if the position is occupado
-		CEntity *apEnts[MAX_CHECK_ENTITY];
-		int Num = pEval->m_pWorld->FindEntities(pEval->m_pWorld->m_aaSpawnPoints[Type][i], 64, (CEntity **) apEnts, MAX_CHECK_ENTITY, GameWorldCheck::EntityComponent(pEval->m_pWorld, CHealthComponent::GetTypeHash()));
-		vec2 Positions[5] = {vec2(0.0f, 0.0f), vec2(-32.0f, 0.0f), vec2(0.0f, -32.0f), vec2(32.0f, 0.0f), vec2(0.0f, 32.0f)}; // start, left, up, right, down
-		int Result = -1;
-		for(int Index = 0; Index < 5 && Result == -1; ++Index)
-		{
-			Result = Index;
-			for(int c = 0; c < Num; ++c)
-				if(pEval->m_pWorld->Collision()->CheckPoint(pEval->m_pWorld->m_aaSpawnPoints[Type][i] + Positions[Index]) ||
-					distance(apEnts[c]->GetPos(), pEval->m_pWorld->m_aaSpawnPoints[Type][i] + Positions[Index]) <= apEnts[c]->GetProximityRadius())
-				{
-					Result = -1;
-					break;
-				}
-		}
+		const int Result = pSpawns->FreeOffset(Type, i);
 		if(Result == -1)
 			continue; // try next spawn point
 
-		vec2 P = pEval->m_pWorld->m_aaSpawnPoints[Type][i] + Positions[Result];
-		float S = pEval->m_RandomSpawn ? (Result + random_float()) : EvaluateSpawnPos(pEval, P);
+		vec2 P = pSpawns->SpawnPoint(Type, i) + CSpawnEvaluator::ms_aOffsets[Result];
+		float S = pEval->m_RandomSpawn ? (Result + pEval->m_pWorld->RandomFloat()) : pSpawns->Danger(Type, i, pEval->m_FriendlyTeam);
 		if(!pEval->m_Got || pEval->m_Score > S)
 		{
 			pEval->m_Got = true;
@@ -22,6 +22,13 @@
 	Class: Game Controller
 		Controls the main game logic. Keeping track of team and player score,
 		winning conditions and specific game logic.
+
+		One controller serves every world of its mode. The world tick hooks
+		(OnCharacterDeath, OnCharacterSpawn, OnFlagReturn, IsFriendlyFire,
+		CanSpawn, HandleCharacterTiles) run inside the tick of one world,
+		with sv_world_threads possibly at the same time as the other worlds.
+		They may only touch that world and its players, anything else,
+		including the controller's own state, goes through CGameWorld::Defer.
 */
 class IGameController
 {
@@ -63,7 +70,6 @@ class IGameController
 		float m_Score;
 	};
 
-	float EvaluateSpawnPos(CSpawnEval *pEval, vec2 Pos) const;
 	void EvaluateSpawnType(CSpawnEval *pEval, int Type) const;
 
 	// team
@@ -89,9 +95,11 @@ public:
 	IGameController(class CGameContext *pGameServer);
 	virtual ~IGameController();
 
+	// world tick hooks, see the class comment
 	virtual int OnCharacterDeath(class CCharacter *pVictim, class CPlayer *pKiller, int Weapon);
 	virtual void OnCharacterSpawn(class CCharacter *pChr);
 	virtual void OnFlagReturn(class CFlag *pFlag);
+
 	virtual bool OnEntity(class CGameWorld *pGameWorld, int Index, vec2 Pos);
 	virtual bool OnExtraTile(class CGameWorld *pGameWorld, int Index, vec2 Pos);
 
@@ -110,7 +118,7 @@ public:
 	virtual void Tick();
 
 	// info
-	virtual bool IsFriendlyFire(class CEntity *pEnt1, class CEntity *pEnt2) const;
+	virtual bool IsFriendlyFire(class CEntity *pEnt1, class CEntity *pEnt2) const; // world tick hook
 	virtual bool IsFriendlyTeamFire(int Team1, int Team2) const;
 	virtual bool IsPlayerReadyMode() const;
 	virtual bool IsTeamChangeAllowed() const;
@@ -121,7 +129,7 @@ public:
 	unsigned ModeHash() const;
 
 	// spawn
-	virtual bool CanSpawn(class CGameWorld *pWorld, int Team, vec2 *pPos) const;
+	virtual bool CanSpawn(class CGameWorld *pWorld, int Team, vec2 *pPos) const; // world tick hook
 	virtual bool GetStartRespawnState() const;
 
 	// team
@@ -135,6 +143,7 @@ public:
 	virtual void OnPlayerExtraSnap(class CPlayer *pPlayer, int SnappingClient) {}
 	virtual int GetPlayerScore(int ClientID) const { return 0; }
 
+	// world tick hook, see the class comment
 	virtual void HandleCharacterTiles(class CCharacter *pChr, vec2 LastPos, vec2 NewPos) {};
 	// static void Com_Example(IConsole::IResult *pResult, void *pContext);
 	virtual void RegisterChatCommands(CCommandManager *pManager);
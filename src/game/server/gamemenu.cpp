@@ -9,7 +9,8 @@
  */
 #include <engine/config.h>
 #include <engine/localization.h>
-#include <engine/shared/memheap.h>
+
+#include <game/voteoptiondiff.h>
 
 #include "gamecontext.h"
 #include "gamemenu.h"
@@ -18,6 +19,24 @@
 #include <cstdarg>
 #include <cstdio>
 
+void CMenuOptionList::Clear()
+{
+	m_vOptions.clear();
+	m_Hash = 0;
+}
+
+bool CMenuOptionList::operator==(const CMenuOptionList &Other) const
+{
+	if(m_Hash != Other.m_Hash || m_vOptions.size() != Other.m_vOptions.size())
+		return false;
+	for(unsigned i = 0; i < m_vOptions.size(); i++)
+	{
+		if(str_comp(m_vOptions[i].m_aDescription, Other.m_vOptions[i].m_aDescription) != 0 || m_vOptions[i].m_Command != Other.m_vOptions[i].m_Command)
+			return false;
+	}
+	return true;
+}
+
 CConfig *CGameMenu::Config() const { return GameServer()->Config(); }
 IServer *CGameMenu::Server() const { return GameServer()->Server(); }
 
@@ -76,13 +95,13 @@ void CGameMenu::OnMenuVote(int ClientID, SCallVoteStatus &VoteStatus, bool Sound
 
 	// find command
 	str_copy(VoteStatus.m_aCmd, "DISPLAY", sizeof(VoteStatus.m_aCmd));
-	if(VoteStatus.m_aDesc[0])
+	if(VoteStatus.m_aDesc[0] && m_aPlayerData[ClientID].m_pOptions)
 	{
-		for(CVoteOptionServer *pOption = m_aPlayerData[ClientID].m_pVoteOptionFirst; pOption; pOption = pOption->m_pNext)
+		for(const SMenuOption &Option : m_aPlayerData[ClientID].m_pOptions->m_vOptions)
 		{
-			if(str_comp_nocase(VoteStatus.m_aDesc, pOption->m_aDescription) == 0)
+			if(str_comp_nocase(VoteStatus.m_aDesc, Option.m_aDescription) == 0)
 			{
-				str_format(VoteStatus.m_aCmd, sizeof(VoteStatus.m_aCmd), "%s", pOption->m_aCommand);
+				str_format(VoteStatus.m_aCmd, sizeof(VoteStatus.m_aCmd), "%s", Option.m_Command.c_str());
 				break;
 			}
 		}
@@ -111,22 +130,78 @@ void CGameMenu::OnMenuVote(int ClientID, SCallVoteStatus &VoteStatus, bool Sound
 		AddOptionLocalize(_C("Previous Page", "Vote Menu"), "PREPAGE", "=");
 	}
 
-	CVoteOptionServer *pCurrent = m_aPlayerData[ClientID].m_pVoteOptionFirst;
-	while(pCurrent)
+	CPlayerData &Data = m_aPlayerData[ClientID];
+	std::shared_ptr<const CMenuOptionList> pOptions = ShareOptions(Data.m_Building);
+	Data.m_Building.Clear();
+	SendOptions(ClientID, Data.m_pOptions.get(), *pOptions);
+	Data.m_pOptions = pOptions;
+}
+
+std::shared_ptr<const CMenuOptionList> CGameMenu::ShareOptions(const CMenuOptionList &Options)
+{
+	auto Range = m_SharedOptions.equal_range(Options.m_Hash);
+	for(auto It = Range.first; It != Range.second; ++It)
+	{
+		std::shared_ptr<const CMenuOptionList> pShared = It->second.lock();
+		if(pShared && *pShared == Options)
+			return pShared;
+	}
+
+	// forget pages nobody shows anymore before the map grows
+	if(m_SharedOptions.size() >= SERVER_MAX_CLIENTS * 2)
+	{
+		for(auto It = m_SharedOptions.begin(); It != m_SharedOptions.end();)
+		{
+			if(It->second.expired())
+				It = m_SharedOptions.erase(It);
+			else
+				++It;
+		}
+	}
+
+	std::shared_ptr<const CMenuOptionList> pShared = std::make_shared<const CMenuOptionList>(Options);
+	m_SharedOptions.emplace(Options.m_Hash, pShared);
+	return pShared;
+}
+
+void CGameMenu::SendOptions(int ClientID, const CMenuOptionList *pOld, const CMenuOptionList &New)
+{
+	std::vector<const char *> vpNew;
+	for(const SMenuOption &Option : New.m_vOptions)
+		vpNew.push_back(Option.m_aDescription);
+
+	CVoteOptionDiff Diff;
+	if(pOld)
+	{
+		std::vector<const char *> vpOld;
+		for(const SMenuOption &Option : pOld->m_vOptions)
+			vpOld.push_back(Option.m_aDescription);
+		Diff.Plan(vpOld.data(), vpOld.size(), vpNew.data(), vpNew.size());
+	}
+	else
+		Diff.PlanClear(vpNew.size());
+
+	if(Diff.Clear())
+		GameServer()->SendVoteClearOptions(ClientID);
+
+	for(int Removal : Diff.Removals())
+	{
+		CNetMsg_Sv_VoteOptionRemove Msg;
+		Msg.m_pDescription = pOld->m_vOptions[Removal].m_aDescription;
+		Server()->SendPackMsg(&Msg, MSGFLAG_VITAL, ClientID);
+	}
+
+	int Index = Diff.NumKept();
+	while(Index < (int) vpNew.size())
 	{
 		// count options for actual packet
-		int NumOptions = 0;
-		for(CVoteOptionServer *p = pCurrent; p && NumOptions < MAX_VOTE_OPTION_ADD; p = p->m_pNext, ++NumOptions)
-			;
+		int NumOptions = minimum((int) vpNew.size() - Index, (int) MAX_VOTE_OPTION_ADD);
 
 		// pack and send vote list packet
 		CMsgPacker Msg(NETMSGTYPE_SV_VOTEOPTIONLISTADD);
 		Msg.AddInt(NumOptions);
-		while(pCurrent && NumOptions--)
-		{
-			Msg.AddString(pCurrent->m_aDescription, VOTE_DESC_LENGTH);
-			pCurrent = pCurrent->m_pNext;
-		}
+		for(; NumOptions > 0; NumOptions--, Index++)
+			Msg.AddString(vpNew[Index], VOTE_DESC_LENGTH);
 		Server()->SendMsg(&Msg, MSGFLAG_VITAL, ClientID);
 	}
 }
@@ -138,24 +213,19 @@ void CGameMenu::SendMenuChat(int ClientID, const char *pChat)
 		for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
 		{
 			if(Server()->ClientIngame(i))
-				SendMenuChat(ClientID, pChat);
+				SendMenuChat(i, pChat);
 		}
 		return;
 	}
 
-	str_copy(m_aPlayerData[ClientID].m_aMenuChat, pChat, ClientID);
+	str_copy(m_aPlayerData[ClientID].m_aMenuChat, pChat, sizeof(m_aPlayerData[ClientID].m_aMenuChat));
 	SCallVoteStatus VoteStatus;
 	OnMenuVote(ClientID, VoteStatus);
 }
 
 void CGameMenu::ClearOptions(int ClientID)
 {
-	GameServer()->SendVoteClearOptions(ClientID);
-
-	m_aPlayerData[ClientID].m_pVoteOptionHeap->Reset();
-	m_aPlayerData[ClientID].m_pVoteOptionFirst = nullptr;
-	m_aPlayerData[ClientID].m_pVoteOptionLast = nullptr;
-	m_aPlayerData[ClientID].m_NumVoteOptions = 0;
+	m_aPlayerData[ClientID].m_Building.Clear();
 }
 
 void CGameMenu::SetPlayerPage(int ClientID, unsigned Page)
@@ -309,23 +379,14 @@ void CGameMenu::AddOption(const char *pDesc, const char *pCommand, const char *p
 	if(!pDesc[0] || !pCommand[0])
 		return;
 	// add the option
-	++m_aPlayerData[m_CurrentClientID].m_NumVoteOptions;
-	int Len = str_length(pCommand);
-
-	CVoteOptionServer *pOption = (CVoteOptionServer *) m_aPlayerData[m_CurrentClientID].m_pVoteOptionHeap->Allocate(sizeof(CVoteOptionServer) + Len);
-	pOption->m_pNext = 0;
-	pOption->m_pPrev = m_aPlayerData[m_CurrentClientID].m_pVoteOptionLast;
-	if(pOption->m_pPrev)
-		pOption->m_pPrev->m_pNext = pOption;
-	m_aPlayerData[m_CurrentClientID].m_pVoteOptionLast = pOption;
-	if(!m_aPlayerData[m_CurrentClientID].m_pVoteOptionFirst)
-		m_aPlayerData[m_CurrentClientID].m_pVoteOptionFirst = pOption;
-
+	CMenuOptionList &Building = m_aPlayerData[m_CurrentClientID].m_Building;
+	SMenuOption &Option = Building.m_vOptions.emplace_back();
 	if(pPrefix && pPrefix[0])
-		str_format(pOption->m_aDescription, sizeof(pOption->m_aDescription), "%s %s", pPrefix, pDesc);
+		str_format(Option.m_aDescription, sizeof(Option.m_aDescription), "%s %s", pPrefix, pDesc);
 	else
-		str_copy(pOption->m_aDescription, pDesc, sizeof(pOption->m_aDescription));
-	mem_copy(pOption->m_aCommand, pCommand, Len + 1);
+		str_copy(Option.m_aDescription, pDesc, sizeof(Option.m_aDescription));
+	Option.m_Command = pCommand;
+	Building.m_Hash = (Building.m_Hash * 31 + str_quickhash(Option.m_aDescription)) * 31 + str_quickhash(pCommand);
 }
 
 void CGameMenu::AddOptionLocalize(const char *pDesc, const char *pContext, const char *pCommand, const char *pPrefix)
@@ -346,14 +407,3 @@ const char *CGameMenu::Localize(const char *pStr, const char *pContext)
 
 	return Server()->Localize(m_CurrentClientID, pStr, pContext);
 }
-
-CGameMenu::CPlayerData::CPlayerData()
-{
-	m_pVoteOptionHeap = new CHeap();
-	Reset(true);
-}
-
-CGameMenu::CPlayerData::~CPlayerData()
-{
-	delete m_pVoteOptionHeap;
-}
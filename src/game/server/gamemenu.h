@@ -17,6 +17,8 @@
 #include <game/voting.h>
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #define MENU_MAIN_PAGE_ID str_quickhash("MAIN")
@@ -43,6 +45,23 @@ struct SMenuPage
 	void *m_pUserData = nullptr;
 };
 
+struct SMenuOption
+{
+	char m_aDescription[VOTE_DESC_LENGTH];
+	std::string m_Command;
+};
+
+// a rendered page, never changed once a client shows it
+class CMenuOptionList
+{
+public:
+	std::vector<SMenuOption> m_vOptions;
+	unsigned m_Hash = 0;
+
+	void Clear();
+	bool operator==(const CMenuOptionList &Other) const;
+};
+
 class CGameMenu
 {
 	class CGameContext *m_pGameServer;
@@ -60,6 +79,7 @@ public:
 	void OnMenuVote(int ClientID, SCallVoteStatus &VoteStatus, bool Sound = false);
 	void SendMenuChat(int ClientID, const char *pChat);
 
+	// starts a new page for the client, it's sent when the page callback returns true
 	void ClearOptions(int ClientID);
 	void SetPlayerPage(int ClientID, unsigned Page);
 	void SetPlayerPage(int ClientID, const char *pPage);
@@ -87,13 +107,19 @@ private:
 
 	std::unordered_map<unsigned, std::shared_ptr<SMenuPage>> m_upMenuPages;
 
+	// rendered pages by hash, clients showing the same page share one list
+	std::unordered_multimap<unsigned, std::weak_ptr<const CMenuOptionList>> m_SharedOptions;
+	std::shared_ptr<const CMenuOptionList> ShareOptions(const CMenuOptionList &Options);
+	// sends only what changed between the two pages, pOld is null when the client's list is unknown
+	void SendOptions(int ClientID, const CMenuOptionList *pOld, const CMenuOptionList &New);
+
 	class CPlayerData
 	{
 	public:
-		class CHeap *m_pVoteOptionHeap;
-		CVoteOptionServer *m_pVoteOptionFirst;
-		CVoteOptionServer *m_pVoteOptionLast;
-		int m_NumVoteOptions;
+		// what the client shows, null until the first page was sent
+		std::shared_ptr<const CMenuOptionList> m_pOptions;
+		// the page being rendered
+		CMenuOptionList m_Building;
 
 		unsigned m_CurrentPage;
 		char m_aMenuChat[48];
@@ -102,17 +128,13 @@ private:
 		{
 			if(Clear)
 			{
-				m_pVoteOptionFirst = nullptr;
-				m_pVoteOptionLast = nullptr;
-				m_NumVoteOptions = 0;
+				m_pOptions = nullptr;
+				m_Building.Clear();
 			}
 
 			m_CurrentPage = MENU_MAIN_PAGE_ID;
 			m_aMenuChat[0] = '\0';
 		}
-
-		CPlayerData();
-		~CPlayerData();
 	};
 	CPlayerData m_aPlayerData[SERVER_MAX_CLIENTS];
 };
@@ -20,7 +20,9 @@
 #include "gameworld.inl"
 #include "player.h"
 
-CEventHandler *CGameWorld::EventHandler() { return &GameServer()->m_Events; }
+#include <atomic>
+#include <mutex>
+
 //////////////////////////////////////////////////
 // game world
 //////////////////////////////////////////////////
@@ -30,18 +32,17 @@ CGameWorld::CGameWorld()
 	m_pConfig = nullptr;
 	m_pServer = nullptr;
 
-	// spawn
-	m_aNumSpawnPoints[0] = 0;
-	m_aNumSpawnPoints[1] = 0;
-	m_aNumSpawnPoints[2] = 0;
-
 	m_Paused = false;
 	m_ResetRequested = false;
 	for(int i = 0; i < NUM_ENTTYPES; i++)
 		m_apFirstEntityTypes[i] = nullptr;
 
 	m_pBotManager = nullptr;
-	m_uupComponents.clear();
+	m_TickingParallel = false;
+	// seeded from the global stream on the main thread, runs stay reproducible under srand
+	m_RandomState = ((uint64_t) random_int() << 32) | random_int();
+	mem_zero(m_aaNumComponentEntities, sizeof(m_aaNumComponentEntities));
+	mem_zero(m_aComponentTypeMask, sizeof(m_aComponentTypeMask));
 }
 
 CGameWorld::~CGameWorld()
@@ -53,8 +54,6 @@ CGameWorld::~CGameWorld()
 
 	if(m_pBotManager)
 		delete m_pBotManager;
-
-	m_uupComponents.clear();
 }
 
 void CGameWorld::SetCollision(std::shared_ptr<CCollision> pCollision)
@@ -65,6 +64,7 @@ void CGameWorld::SetCollision(std::shared_ptr<CCollision> pCollision)
 void CGameWorld::SetGameServer(CGameContext *pGameServer)
 {
 	m_pGameServer = pGameServer;
+	m_Events.SetGameServer(pGameServer);
 	m_pConfig = m_pGameServer->Config();
 	m_pServer = m_pGameServer->Server();
 }
@@ -81,6 +81,75 @@ void CGameWorld::SetGameController(IGameController *pGameController)
 	}
 }
 
+void CGameWorld::InitEntityGrid()
+{
+	m_EntityGrid.Clear();
+	if(!Collision())
+		return;
+
+	m_EntityGrid.Init(Collision()->GetWidth() * 32.0f, Collision()->GetHeight() * 32.0f, NUM_ENTTYPES);
+	for(int i = 0; i < NUM_ENTTYPES; i++)
+		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+			m_EntityGrid.Insert(pEnt, i, pEnt->m_Pos, pEnt->m_ProximityRadius);
+}
+
+void CGameWorld::OnEntityMoved(CEntity *pEnt)
+{
+	if(pEnt->InGrid())
+		m_EntityGrid.Move(pEnt, pEnt->m_Pos);
+	UpdateSpawnBlocker(pEnt);
+}
+
+bool CGameWorld::GetSpawnBlocker(CEntity *pEnt, CSpawnEvaluator::SBlocker *pBlocker)
+{
+	static const int s_HealthID = ComponentID(CHealthComponent::GetTypeHash());
+	if(!pEnt->HasComponent(s_HealthID))
+		return false;
+	// only entities in the world block spawns
+	if(!pEnt->m_pNextTypeEntity && !pEnt->m_pPrevTypeEntity && m_apFirstEntityTypes[pEnt->m_ObjType] != pEnt)
+		return false;
+
+	pBlocker->m_pKey = pEnt;
+	pBlocker->m_Pos = pEnt->m_Pos;
+	pBlocker->m_Radius = pEnt->m_ProximityRadius;
+	pBlocker->m_Dangerous = pEnt->m_ObjType == ENTTYPE_CHARACTER;
+	pBlocker->m_Team = -1;
+	if(pBlocker->m_Dangerous)
+	{
+		CPlayer *pPlayer = static_cast<CCharacter *>(pEnt)->GetPlayer();
+		pBlocker->m_Team = pPlayer ? pPlayer->GetTeam() : -1;
+	}
+	return true;
+}
+
+void CGameWorld::UpdateSpawnBlocker(CEntity *pEnt)
+{
+	// while not synced the next evaluation takes all blockers anyway
+	CSpawnEvaluator::SBlocker Blocker;
+	if(m_SpawnEvaluator.IsSynced() && GetSpawnBlocker(pEnt, &Blocker))
+		m_SpawnEvaluator.UpdateBlocker(Blocker);
+}
+
+CSpawnEvaluator *CGameWorld::SpawnEvaluator()
+{
+	m_SpawnEvaluator.SetCollision(Collision());
+	for(int Type = 0; Type < CSpawnEvaluator::NUM_SPAWN_TYPES; Type++)
+		m_SpawnEvaluator.SetSpawnPoints(Type, m_avSpawnPoints[Type]);
+
+	if(!m_SpawnEvaluator.IsSynced())
+	{
+		// the type lists put characters first, in the order their danger was always summed up
+		m_SpawnEvaluator.BeginSync();
+		CSpawnEvaluator::SBlocker Blocker;
+		for(int i = 0; i < NUM_ENTTYPES; i++)
+			for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+				if(GetSpawnBlocker(pEnt, &Blocker))
+					m_SpawnEvaluator.AppendBlocker(Blocker);
+		m_SpawnEvaluator.EndSync();
+	}
+	return &m_SpawnEvaluator;
+}
+
 CEntity *CGameWorld::FindFirst(int Type)
 {
 	return Type < 0 || Type >= NUM_ENTTYPES ? 0 : m_apFirstEntityTypes[Type];
@@ -99,6 +168,10 @@ void CGameWorld::InsertEntity(CEntity *pEnt)
 	pEnt->m_pNextTypeEntity = m_apFirstEntityTypes[pEnt->m_ObjType];
 	pEnt->m_pPrevTypeEntity = 0x0;
 	m_apFirstEntityTypes[pEnt->m_ObjType] = pEnt;
+
+	if(m_EntityGrid.IsActive())
+		m_EntityGrid.Insert(pEnt, pEnt->m_ObjType, pEnt->m_Pos, pEnt->m_ProximityRadius);
+	UpdateSpawnBlocker(pEnt);
 }
 
 void CGameWorld::DestroyEntity(CEntity *pEnt)
@@ -106,16 +179,74 @@ void CGameWorld::DestroyEntity(CEntity *pEnt)
 	pEnt->MarkForDestroy();
 }
 
+// worlds ticking in parallel can meet a new component type at the same time
+static unsigned s_aComponentHashes[CGameWorld::MAX_ENTITY_COMPONENTS];
+static std::atomic<int> s_NumComponents(0);
+static std::mutex s_ComponentRegisterLock;
+
+int CGameWorld::FindComponentID(unsigned TypeHash)
+{
+	const int Num = s_NumComponents.load(std::memory_order_acquire);
+	for(int i = 0; i < Num; i++)
+		if(s_aComponentHashes[i] == TypeHash)
+			return i;
+	return -1;
+}
+
+int CGameWorld::ComponentID(unsigned TypeHash)
+{
+	const int Found = FindComponentID(TypeHash);
+	if(Found >= 0)
+		return Found;
+
+	std::lock_guard<std::mutex> Lock(s_ComponentRegisterLock);
+	int Num = s_NumComponents.load(std::memory_order_relaxed);
+	for(int i = 0; i < Num; i++)
+		if(s_aComponentHashes[i] == TypeHash)
+			return i;
+
+	dbg_assert(Num < MAX_ENTITY_COMPONENTS, "too many entity component types");
+	s_aComponentHashes[Num] = TypeHash;
+	s_NumComponents.store(Num + 1, std::memory_order_release);
+	return Num;
+}
+
+void *CGameWorld::GetComponentByID(CEntity *pEntity, int ComponentID)
+{
+	return pEntity->HasComponent(ComponentID) ? pEntity->m_apComponents[ComponentID] : nullptr;
+}
+
 void CGameWorld::RegisterEntityComponent(CEntity *pThis, unsigned TypeHash, void *pComponent)
 {
-	if(m_uupComponents.count(pThis))
-		dbg_assert(!m_uupComponents[pThis].count(TypeHash), "registered a entity component twice!");
+	const int ID = ComponentID(TypeHash);
+	dbg_assert(!pThis->HasComponent(ID), "registered a entity component twice!");
+
+	pThis->m_apComponents[ID] = pComponent;
+	pThis->m_ComponentMask |= 1u << ID;
+	if(m_aaNumComponentEntities[ID][pThis->m_ObjType]++ == 0)
+		m_aComponentTypeMask[ID] |= 1u << pThis->m_ObjType;
+	UpdateSpawnBlocker(pThis);
+}
 
-	m_uupComponents[pThis][TypeHash] = pComponent;
+void CGameWorld::RemoveEntityComponents(CEntity *pEnt)
+{
+	for(int ID = 0; pEnt->m_ComponentMask; ID++)
+	{
+		if(!pEnt->HasComponent(ID))
+			continue;
+		pEnt->m_ComponentMask &= ~(1u << ID);
+		if(--m_aaNumComponentEntities[ID][pEnt->m_ObjType] == 0)
+			m_aComponentTypeMask[ID] &= ~(1u << pEnt->m_ObjType);
+	}
 }
 
 void CGameWorld::RemoveEntity(CEntity *pEnt)
 {
+	if(m_SpawnEvaluator.IsSynced())
+		m_SpawnEvaluator.RemoveBlocker(pEnt);
+	m_EntityGrid.Remove(pEnt);
+	RemoveEntityComponents(pEnt);
+
 	// not in the list
 	if(!pEnt->m_pNextTypeEntity && !pEnt->m_pPrevTypeEntity && m_apFirstEntityTypes[pEnt->m_ObjType] != pEnt)
 		return;
@@ -134,15 +265,36 @@ void CGameWorld::RemoveEntity(CEntity *pEnt)
 
 	pEnt->m_pNextTypeEntity = 0;
 	pEnt->m_pPrevTypeEntity = 0;
-
-	m_uupComponents.erase(pEnt);
 }
 
 //
 void CGameWorld::Snap(int SnappingClient)
 {
+	// entities clipped at their own position are only looked up in the cells around the view
+	unsigned CulledTypes = 0;
+	if(SnappingClient != -1 && m_EntityGrid.IsActive())
+	{
+		CulledTypes = SNAP_CULLED_TYPES;
+		const vec2 ViewPos = GameServer()->m_apPlayers[SnappingClient]->m_ViewPos;
+		const vec2 ViewBox = vec2(NETWORK_CLIP_X, NETWORK_CLIP_Y);
+		m_EntityGrid.ForEachCell(ViewPos - ViewBox, ViewPos + ViewBox, [&](int Cell) {
+			for(int i = 0; i < NUM_ENTTYPES; i++)
+			{
+				if(!(CulledTypes & (1u << i)))
+					continue;
+				for(CSpatialGridItem *pItem = m_EntityGrid.First(Cell, i); pItem;)
+				{
+					CEntity *pEnt = static_cast<CEntity *>(pItem);
+					pItem = pItem->NextInCell();
+					pEnt->Snap(SnappingClient);
+				}
+			}
+			return true;
+		});
+	}
+
 	for(int i = 0; i < NUM_ENTTYPES; i++)
-		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt;)
+		for(CEntity *pEnt = (CulledTypes & (1u << i)) ? nullptr : m_apFirstEntityTypes[i]; pEnt;)
 		{
 			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
 			pEnt->Snap(SnappingClient);
@@ -152,6 +304,8 @@ void CGameWorld::Snap(int SnappingClient)
 
 void CGameWorld::PostSnap()
 {
+	m_Events.Clear();
+
 	if(BotManager())
 		BotManager()->PostSnap();
 
@@ -164,6 +318,46 @@ void CGameWorld::PostSnap()
 		}
 }
 
+// FNV-1a over the raw bits, float positions must match exactly
+static unsigned HashBytes(unsigned Hash, const void *pData, int Size)
+{
+	const unsigned char *pBytes = (const unsigned char *) pData;
+	for(int i = 0; i < Size; i++)
+		Hash = (Hash ^ pBytes[i]) * 16777619u;
+	return Hash;
+}
+
+unsigned CGameWorld::Hash()
+{
+	unsigned Hash = 2166136261u;
+	for(int i = 0; i < NUM_ENTTYPES; i++)
+	{
+		Hash = HashBytes(Hash, &i, sizeof(i));
+		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+		{
+			Hash = HashBytes(Hash, &pEnt->m_Pos, sizeof(pEnt->m_Pos));
+			if(CHealthComponent *pHealth = GetComponent<CHealthComponent>(pEnt))
+			{
+				const int aHealth[2] = {pHealth->GetHealth(), pHealth->GetArmor()};
+				Hash = HashBytes(Hash, aHealth, sizeof(aHealth));
+			}
+		}
+	}
+
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		const CCharacterCore *pCore = m_Core.m_apCharacters[i];
+		if(!pCore)
+			continue;
+		Hash = HashBytes(Hash, &i, sizeof(i));
+		Hash = HashBytes(Hash, &pCore->m_Vel, sizeof(pCore->m_Vel));
+		Hash = HashBytes(Hash, &pCore->m_HookPos, sizeof(pCore->m_HookPos));
+		const int aHook[2] = {pCore->m_HookState, pCore->m_HookedPlayer};
+		Hash = HashBytes(Hash, aHook, sizeof(aHook));
+	}
+	return Hash;
+}
+
 void CGameWorld::Reset()
 {
 	// reset all entities
@@ -206,6 +400,9 @@ void CGameWorld::Tick()
 	if(BotManager())
 		BotManager()->Tick();
 
+	// everything moves now, the next spawn evaluation syncs again
+	m_SpawnEvaluator.Invalidate();
+
 	if(m_Paused)
 	{
 		// update all objects
@@ -240,16 +437,63 @@ void CGameWorld::Tick()
 	RemoveEntities();
 }
 
+void CGameWorld::TickParallel()
+{
+	m_TickingParallel = true;
+	Server()->SetThreadMsgBuffer(&m_TickMsgs);
+	Tick();
+	Server()->SetThreadMsgBuffer(nullptr);
+}
+
+void CGameWorld::MergeParallelTick()
+{
+	Server()->SendMsgBuffer(&m_TickMsgs);
+
+	m_TickingParallel = false;
+	for(auto &Fn : m_vDeferred)
+		Fn();
+	m_vDeferred.clear();
+}
+
+void CGameWorld::Defer(std::function<void()> &&Fn)
+{
+	if(m_TickingParallel)
+		m_vDeferred.push_back(std::move(Fn));
+	else
+		Fn();
+}
+
+void CGameWorld::ConsolePrint(int Level, const char *pFrom, const char *pStr)
+{
+	Defer([this, Level, From = std::string(pFrom), Str = std::string(pStr)]() {
+		GameServer()->Console()->Print(Level, From.c_str(), Str.c_str());
+	});
+}
+
+int CGameWorld::RandomInt()
+{
+	// 64 bit linear congruential generator, the high bits are the good ones
+	m_RandomState = m_RandomState * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (int) (m_RandomState >> 33);
+}
+
+float CGameWorld::RandomFloat()
+{
+	return RandomInt() / (float) 0x7fffffff;
+}
+
+CPlayer *CGameWorld::GetPlayer(int ClientID)
+{
+	CPlayer *pPlayer = GameServer()->m_apPlayers[ClientID];
+	return pPlayer && pPlayer->GameWorld() == this ? pPlayer : nullptr;
+}
+
 int64_t CGameWorld::CmaskAllInWorld()
 {
 	int64_t Mask = 0LL;
-	for(auto &pPlayer : GameServer()->m_apPlayers)
-	{
-		if(pPlayer && pPlayer->GameWorld() == this)
-		{
-			Mask |= CmaskOne(pPlayer->GetCID());
-		}
-	}
+	for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+		if(GetPlayer(i))
+			Mask |= CmaskOne(i);
 	return Mask;
 }
 
@@ -11,9 +11,18 @@
 #ifndef GAME_SERVER_GAMEWORLD_H
 #define GAME_SERVER_GAMEWORLD_H
 
+#include <engine/server.h>
+
 #include <game/gamecore.h>
+#include <game/spatialgrid.h>
+#include <game/spawnevaluator.h>
 
+#include <functional>
 #include <memory>
+#include <vector>
+
+#include "alloc.h"
+#include "eventhandler.h"
 
 #define MAX_CHECK_ENTITY 128
 
@@ -39,6 +48,15 @@ public:
 		NUM_ENTTYPES
 	};
 
+	enum
+	{
+		MAX_ENTITY_COMPONENTS = 8,
+	};
+
+	// types whose Snap only clips by the entity position, see Snap. Projectiles
+	// clip at their flight position, lasers at both ends and bots by slot
+	static const unsigned SNAP_CULLED_TYPES = (1u << ENTTYPE_PICKUP) | (1u << ENTTYPE_CHARACTER) | (1u << ENTTYPE_FLAG);
+
 private:
 	void Reset();
 	void RemoveEntities();
@@ -52,21 +70,47 @@ private:
 	class IServer *m_pServer;
 
 	std::shared_ptr<CCollision> m_pCollision;
-	std::unordered_map<CEntity *, std::unordered_map<unsigned, void *>> m_uupComponents;
+	CSpatialGrid m_EntityGrid;
+	CEntityPool m_aEntityPools[NUM_ENTTYPES];
+
+	// runs Test on the entities matching the flag's type in a grid cell, or the whole world for Cell -1
+	template<typename F, typename T>
+	bool ForEachCandidate(int Cell, const F &Flag, T &Test);
+	// entity types with at least one entity carrying the component, indexed by component id
+	int m_aaNumComponentEntities[MAX_ENTITY_COMPONENTS][NUM_ENTTYPES];
+	unsigned m_aComponentTypeMask[MAX_ENTITY_COMPONENTS];
+
+	void RemoveEntityComponents(CEntity *pEntity);
 
 	class CBotManager *m_pBotManager;
 
+	CEventHandler m_Events;
+
+	CSpawnEvaluator m_SpawnEvaluator;
+	bool GetSpawnBlocker(CEntity *pEnt, CSpawnEvaluator::SBlocker *pBlocker);
+	void UpdateSpawnBlocker(CEntity *pEnt);
+
+	// side effects of a parallel tick, merged by MergeParallelTick
+	bool m_TickingParallel;
+	IServer::CMsgBuffer m_TickMsgs;
+	std::vector<std::function<void()>> m_vDeferred;
+
+	// worlds ticking in parallel must not share the rand() stream
+	uint64_t m_RandomState;
+
 public:
 	class CBotManager *BotManager() const { return m_pBotManager; }
-	class CEventHandler *EventHandler();
+	class CEventHandler *EventHandler() { return &m_Events; }
 	class IGameController *GameController() { return m_pGameController; }
 	class CGameContext *GameServer() { return m_pGameServer; }
 	class CConfig *Config() { return m_pConfig; }
 	class IServer *Server() { return m_pServer; }
 	CCollision *Collision() { return m_pCollision.get(); }
+	CEntityPool *EntityPool(int Type) { return &m_aEntityPools[Type]; }
+	// synced with the current entities and spawn points
+	CSpawnEvaluator *SpawnEvaluator();
 
-	vec2 m_aaSpawnPoints[3][64];
-	unsigned m_aNumSpawnPoints[3];
+	std::vector<vec2> m_avSpawnPoints[3];
 
 	bool m_ResetRequested;
 	bool m_Paused;
@@ -81,6 +125,15 @@ public:
 	void SetGameServer(CGameContext *pGameServer);
 	void SetGameController(IGameController *pGameController);
 
+	/*
+		Function: InitEntityGrid
+			Sets up the spatial grid used by the entity queries for the
+			current collision map and bins the entities already in the world.
+			Without a grid the queries walk the type lists.
+	*/
+	void InitEntityGrid();
+	void OnEntityMoved(CEntity *pEntity);
+
 	CEntity *FindFirst(int Type);
 
 	/*
@@ -178,7 +231,8 @@ public:
 	/*
 		Function: snap
 			Calls snap on all the entities in the world to create
-			the snapshot.
+			the snapshot. Entities of SNAP_CULLED_TYPES are only
+			visited in the grid cells around the client's view.
 
 		Arguments:
 			snapping_client - ID of the client which snapshot
@@ -188,6 +242,14 @@ public:
 
 	void PostSnap();
 
+	/*
+		Function: Hash
+			Hashes the positions of all entities, their health and the
+			character cores. Two worlds that got the same inputs from the
+			same state must hash equal.
+	*/
+	unsigned Hash();
+
 	/*
 		Function: tick
 			Calls tick on all the entities in the world to progress
@@ -196,6 +258,28 @@ public:
 	*/
 	void Tick();
 
+	/*
+		Function: TickParallel
+			Ticks the world on a worker thread. Network messages go to a
+			buffer of this world, Defer holds back everything else
+			that reaches outside of it. MergeParallelTick applies them on the
+			main thread after every world finished.
+	*/
+	void TickParallel();
+	void MergeParallelTick();
+	bool IsTickingParallel() const { return m_TickingParallel; }
+
+	// runs Fn now, or at the merge when the world is ticking in parallel
+	void Defer(std::function<void()> &&Fn);
+	void ConsolePrint(int Level, const char *pFrom, const char *pStr);
+
+	// random numbers for the world tick, same ranges as random_int and random_float
+	int RandomInt();
+	float RandomFloat();
+
+	// the player if it is in this world, players are only added and removed between ticks
+	class CPlayer *GetPlayer(int ClientID);
+
 	int64_t CmaskAllInWorld();
 	int64_t CmaskAllInWorldExceptOne(int ClientID);
 
@@ -214,23 +298,32 @@ public:
 	void CreateDeath(vec2 Pos, int Who);
 	void CreateSound(vec2 Pos, int Sound);
 
+	/*
+		Function: ComponentID
+			Maps a component type hash to the slot it uses in every entity,
+			the first call for a hash assigns the next free slot.
+	*/
+	static int ComponentID(unsigned TypeHash);
+	// like ComponentID, but -1 for a hash that has no slot yet instead of assigning one
+	static int FindComponentID(unsigned TypeHash);
+	unsigned ComponentTypeMask(int ComponentID) const { return m_aComponentTypeMask[ComponentID]; }
+
+	// defined in gameworld.cpp
+	void *GetComponentByID(CEntity *pEntity, int ComponentID);
+
+	// lookup only, a type no entity registered yet gives nullptr
 	void *GetComponent(CEntity *pEntity, unsigned Hash)
 	{
-		auto IterEntity = m_uupComponents.find(pEntity);
-		if(IterEntity == m_uupComponents.end())
-			return nullptr;
-
-		auto IterComponent = IterEntity->second.find(Hash);
-		if(IterComponent == IterEntity->second.end())
-			return nullptr;
-		return IterComponent->second;
+		const int ID = FindComponentID(Hash);
+		return ID < 0 ? nullptr : GetComponentByID(pEntity, ID);
 	}
 
 	template<typename T>
 	T *GetComponent(CEntity *pEntity)
 	{
 		static_assert(std::is_same_v<decltype(T::GetTypeHash()), unsigned>, "T must have static unsigned GetTypeHash()");
-		return static_cast<T *>(GetComponent(pEntity, T::GetTypeHash()));
+		static const int s_ComponentID = ComponentID(T::GetTypeHash());
+		return static_cast<T *>(GetComponentByID(pEntity, s_ComponentID));
 	}
 };
 
@@ -13,38 +13,63 @@
 #include "entity.h"
 #include "gameworld.h"
 
+template<typename F, typename T>
+bool CGameWorld::ForEachCandidate(int Cell, const F &Flag, T &Test)
+{
+	auto pfnWalk = [&](int Type) -> bool {
+		if(Cell < 0)
+		{
+			for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt; pEnt = pEnt->TypeNext())
+				if(!Test(pEnt))
+					return false;
+			return true;
+		}
+
+		for(CSpatialGridItem *pItem = m_EntityGrid.First(Cell, Type); pItem; pItem = pItem->NextInCell())
+			if(!Test(static_cast<CEntity *>(pItem)))
+				return false;
+		return true;
+	};
+
+	if constexpr(F::Indexable())
+	{
+		const unsigned Mask = Flag.TypeMask();
+		for(int i = 0; i < NUM_ENTTYPES; i++)
+			if((Mask & (1u << i)) && !pfnWalk(i))
+				return false;
+		return true;
+	}
+	else
+	{
+		for(int i = 0; i < NUM_ENTTYPES; i++)
+			if(!pfnWalk(i))
+				return false;
+		return true;
+	}
+}
+
 template<typename F>
 int CGameWorld::FindEntities(vec2 Pos, float Radius, CEntity **ppEnts, int Max, F Flag)
 {
 	int Num = 0;
-	auto pfnTest = [&](int Type)
-	{
-		for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt; pEnt = pEnt->TypeNext())
-		{
-            if(!Flag(pEnt))
-                continue;
-
-			if(distance(pEnt->m_Pos, Pos) < Radius + pEnt->m_ProximityRadius)
-			{
-				if(ppEnts)
-					ppEnts[Num] = pEnt;
-				Num++;
-				if(Num == Max)
-					break;
-			}
-		}
+	auto Test = [&](CEntity *pEnt) -> bool {
+		// distance first, the flag can be a component lookup
+		if(distance(pEnt->m_Pos, Pos) >= Radius + pEnt->m_ProximityRadius || !Flag(pEnt))
+			return true;
+
+		if(ppEnts)
+			ppEnts[Num] = pEnt;
+		Num++;
+		return Num != Max;
 	};
-    if constexpr (F::Indexable())
-    {
-        pfnTest(Flag.TypeIndex());
-    }
-    else
-    {
-        for(int i = 0; i < NUM_ENTTYPES; i++)
-        {
-            pfnTest(i);
-        }
-    }
+
+	if(m_EntityGrid.IsActive())
+	{
+		const vec2 Reach = vec2(1.0f, 1.0f) * (Radius + m_EntityGrid.MaxRadius());
+		m_EntityGrid.ForEachCell(Pos - Reach, Pos + Reach, [&](int Cell) { return ForEachCandidate(Cell, Flag, Test); });
+	}
+	else
+		ForEachCandidate(-1, Flag, Test);
 
 	return Num;
 }
@@ -56,38 +81,36 @@ CEntity *CGameWorld::IntersectEntity(vec2 Pos0, vec2 Pos1, float Radius, F Flag,
 	float ClosestLen = distance(Pos0, Pos1) * 100.0f;
 	CEntity *pClosest = 0;
 
-	auto pfnTest = [&](int Type)
-	{
-		for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt; pEnt = pEnt->TypeNext())
-		{
-			if(!Flag(pEnt) || pEnt == pNotThis)
-				continue;
+	auto Test = [&](CEntity *pEnt) -> bool {
+		if(pEnt == pNotThis)
+			return true;
 
-			vec2 IntersectPos = closest_point_on_line(Pos0, Pos1, pEnt->m_Pos);
-			float Len = distance(pEnt->m_Pos, IntersectPos);
-			if(Len < pEnt->m_ProximityRadius + Radius)
+		vec2 IntersectPos = closest_point_on_line(Pos0, Pos1, pEnt->m_Pos);
+		float Len = distance(pEnt->m_Pos, IntersectPos);
+		if(Len < pEnt->m_ProximityRadius + Radius)
+		{
+			Len = distance(Pos0, IntersectPos);
+			if(Len < ClosestLen && Flag(pEnt))
 			{
-				Len = distance(Pos0, IntersectPos);
-				if(Len < ClosestLen)
-				{
-					NewPos = IntersectPos;
-					ClosestLen = Len;
-					pClosest = pEnt;
-				}
+				NewPos = IntersectPos;
+				ClosestLen = Len;
+				pClosest = pEnt;
 			}
 		}
+		return true;
 	};
-    if constexpr (F::Indexable())
-    {
-        pfnTest(Flag.TypeIndex());
-    }
-    else
-    {
-        for(int i = 0; i < NUM_ENTTYPES; i++)
-        {
-            pfnTest(i);
-        }
-    }
+
+	if(m_EntityGrid.IsActive())
+	{
+		m_EntityGrid.ForEachCellOnRay(Pos0, Pos1, Radius + m_EntityGrid.MaxRadius(), [&](int Cell, float MinDistance) {
+			// the cells left can't hold anything closer than the current hit
+			if(pClosest && MinDistance >= ClosestLen)
+				return false;
+			return ForEachCandidate(Cell, Flag, Test);
+		});
+	}
+	else
+		ForEachCandidate(-1, Flag, Test);
 
 	return pClosest;
 }
@@ -99,39 +122,31 @@ CEntity *CGameWorld::ClosestEntity(vec2 Pos, float Radius, F Flag, CEntity *pNot
 	float ClosestRange = Radius * 2;
 	CEntity *pClosest = 0;
 
-	auto pfnTest = [&](int Type)
-	{
-		for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt; pEnt = pEnt->TypeNext())
-		{
-			if(!Flag(pEnt)|| pEnt == pNotThis)
-				continue;
+	auto Test = [&](CEntity *pEnt) -> bool {
+		if(pEnt == pNotThis)
+			return true;
 
-			float Len = distance(Pos, pEnt->m_Pos);
-			if(Len < pEnt->m_ProximityRadius + Radius)
-			{
-				if(Len < ClosestRange)
-				{
-					ClosestRange = Len;
-					pClosest = pEnt;
-				}
-			}
+		float Len = distance(Pos, pEnt->m_Pos);
+		if(Len < pEnt->m_ProximityRadius + Radius && Len < ClosestRange && Flag(pEnt))
+		{
+			ClosestRange = Len;
+			pClosest = pEnt;
 		}
+		return true;
 	};
-    if constexpr (F::Indexable())
-    {
-        pfnTest(Flag.TypeIndex());
-    }
-    else
-    {
-        for(int i = 0; i < NUM_ENTTYPES; i++)
-        {
-            pfnTest(i);
-        }
-    }
+
+	if(m_EntityGrid.IsActive())
+	{
+		const vec2 Reach = vec2(1.0f, 1.0f) * (Radius + m_EntityGrid.MaxRadius());
+		m_EntityGrid.ForEachCell(Pos - Reach, Pos + Reach, [&](int Cell) { return ForEachCandidate(Cell, Flag, Test); });
+	}
+	else
+		ForEachCandidate(-1, Flag, Test);
 
 	return pClosest;
 }
 
+// query filters, indexable ones name the entity types that can pass them
 namespace GameWorldCheck
 {
     struct EntityType
@@ -141,17 +156,19 @@ namespace GameWorldCheck
         bool operator()(CEntity* pEnt) const { return pEnt->GetObjType() == m_Type; }
 
         static constexpr bool Indexable() { return true; }
-        int TypeIndex() const { return m_Type; }
+        unsigned TypeMask() const { return 1u << m_Type; }
     };
 
     struct EntityComponent
     {
-        CGameWorld *m_pGameWorld;
-        unsigned m_ComponentHash;
-        EntityComponent(CGameWorld *pWorld, int Hash) : m_pGameWorld(pWorld), m_ComponentHash(Hash) {}
-        bool operator()(CEntity* pEnt) const { return m_pGameWorld->GetComponent(pEnt, m_ComponentHash) != nullptr; }
+        int m_ComponentID;
+        unsigned m_TypeMask;
+        // a type no entity registered yet matches nothing
+        EntityComponent(CGameWorld *pWorld, unsigned Hash) : m_ComponentID(CGameWorld::FindComponentID(Hash)), m_TypeMask(m_ComponentID < 0 ? 0 : pWorld->ComponentTypeMask(m_ComponentID)) {}
+        bool operator()(CEntity* pEnt) const { return m_ComponentID >= 0 && pEnt->HasComponent(m_ComponentID); }
 
-        static constexpr bool Indexable() { return false; }
+        static constexpr bool Indexable() { return true; }
+        unsigned TypeMask() const { return m_TypeMask; }
     };
 };
 #endif // GAME_SERVER_GAMEWORLD_INL
@@ -44,6 +44,8 @@ CPlayer::CPlayer(CGameWorld *pGameWorld, int ClientID, bool Dummy, bool AsSpec)
 	m_DeadSpecMode = false;
 	m_Spawning = false;
 	mem_zero(&m_Latency, sizeof(m_Latency));
+	m_SnapIngame = false;
+	mem_zero(&m_SnapInfo, sizeof(m_SnapInfo));
 }
 
 CPlayer::~CPlayer()
@@ -144,27 +146,41 @@ void CPlayer::PostTick()
 	}
 }
 
+void CPlayer::PreSnap()
+{
+	m_SnapIngame = IsDummy() || Server()->ClientIngame(m_ClientID);
+	if(!m_SnapIngame)
+		return;
+
+	m_SnapInfo.m_PlayerFlags = m_PlayerFlags & PLAYERFLAG_CHATTING;
+	if(Server()->IsAuthed(m_ClientID))
+		m_SnapInfo.m_PlayerFlags |= PLAYERFLAG_ADMIN;
+	if(!GameController()->IsPlayerReadyMode() || m_IsReadyToPlay)
+		m_SnapInfo.m_PlayerFlags |= PLAYERFLAG_READY;
+	if(m_RespawnDisabled && (!GetCharacter() || !GetCharacter()->IsAlive()))
+		m_SnapInfo.m_PlayerFlags |= PLAYERFLAG_DEAD;
+
+	// what the demo gets, real receivers see their own view of the latency
+	m_SnapInfo.m_Latency = m_Latency.m_Min;
+	m_SnapInfo.m_Score = GameController()->GetPlayerScore(m_ClientID);
+}
+
 void CPlayer::Snap(int SnappingClient)
 {
-	if(!IsDummy() && !Server()->ClientIngame(m_ClientID))
+	if(!m_SnapIngame)
 		return;
 
 	CNetObj_PlayerInfo *pPlayerInfo = static_cast<CNetObj_PlayerInfo *>(Server()->SnapNewItem(NETOBJTYPE_PLAYERINFO, m_ClientID, sizeof(CNetObj_PlayerInfo)));
 	if(!pPlayerInfo)
 		return;
 
-	pPlayerInfo->m_PlayerFlags = m_PlayerFlags & PLAYERFLAG_CHATTING;
-	if(Server()->IsAuthed(m_ClientID))
-		pPlayerInfo->m_PlayerFlags |= PLAYERFLAG_ADMIN;
-	if(!GameController()->IsPlayerReadyMode() || m_IsReadyToPlay)
-		pPlayerInfo->m_PlayerFlags |= PLAYERFLAG_READY;
-	if(m_RespawnDisabled && (!GetCharacter() || !GetCharacter()->IsAlive()))
-		pPlayerInfo->m_PlayerFlags |= PLAYERFLAG_DEAD;
-	if(SnappingClient != -1 && (m_Team == TEAM_SPECTATORS || m_DeadSpecMode) && (SnappingClient == m_SpectatorID))
-		pPlayerInfo->m_PlayerFlags |= PLAYERFLAG_WATCHING;
-
-	pPlayerInfo->m_Latency = SnappingClient == -1 ? m_Latency.m_Min : GameServer()->m_apPlayers[SnappingClient]->m_aActLatency[m_ClientID];
-	pPlayerInfo->m_Score = GameController()->GetPlayerScore(m_ClientID);
+	mem_copy(pPlayerInfo, &m_SnapInfo, sizeof(m_SnapInfo));
+	if(SnappingClient != -1)
+	{
+		if((m_Team == TEAM_SPECTATORS || m_DeadSpecMode) && SnappingClient == m_SpectatorID)
+			pPlayerInfo->m_PlayerFlags |= PLAYERFLAG_WATCHING;
+		pPlayerInfo->m_Latency = GameServer()->m_apPlayers[SnappingClient]->m_aActLatency[m_ClientID];
+	}
 
 	if(m_ClientID == SnappingClient && (m_Team == TEAM_SPECTATORS || m_DeadSpecMode))
 	{
@@ -478,7 +494,7 @@ void CPlayer::TryRespawn()
 		return;
 
 	m_Spawning = false;
-	m_pCharacter = new(m_ClientID) CCharacter(GameWorld());
+	m_pCharacter = new(GameWorld()) CCharacter(GameWorld());
 	m_pCharacter->Spawn(this, SpawnPos);
 	GameWorld()->CreatePlayerSpawn(SpawnPos);
 }
@@ -35,6 +35,8 @@ public:
 
 	void Tick();
 	void PostTick();
+	// builds the part of the player info that is the same for every receiver, once before the snapshots of a tick
+	void PreSnap();
 	void Snap(int SnappingClient);
 
 	void OnDirectInput(CNetObj_PlayerInput *NewInput);
@@ -132,6 +134,10 @@ private:
 	int m_SpectatorID;
 	class CFlag *m_pSpecFlag;
 	bool m_ActiveSpecSwitch;
+
+	// shared snap data from PreSnap, receivers only patch latency and the watching flag
+	bool m_SnapIngame;
+	CNetObj_PlayerInfo m_SnapInfo;
 };
 
 #endif
@@ -22,6 +22,7 @@ struct STeeInfo
 	int m_aSkinPartColors[NUM_SKINPARTS];
 };
 
-STeeInfo GenerateRandomSkin();
+// picks one of the standard skins, Random comes from the caller's random stream
+STeeInfo GenerateRandomSkin(int Random);
 
 #endif // GAME_SERVER_TEEINFO_H
@@ -34,7 +34,7 @@ public:
 
 void CGrenade::OnFire(CEntity *pFrom, CGameWorld *pWorld, vec2 Pos, vec2 Direction, int *pReloadTimer)
 {
-	new CProjectile(pWorld, WEAPON_GRENADE,
+	new(pWorld) CProjectile(pWorld, WEAPON_GRENADE,
 		pFrom,
 		Pos,
 		Direction,
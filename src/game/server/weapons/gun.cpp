@@ -34,7 +34,7 @@ public:
 
 void CGun::OnFire(CEntity *pFrom, CGameWorld *pWorld, vec2 Pos, vec2 Direction, int *pReloadTimer)
 {
-	new CProjectile(pWorld, WEAPON_GUN,
+	new(pWorld) CProjectile(pWorld, WEAPON_GUN,
 		pFrom,
 		Pos,
 		Direction,
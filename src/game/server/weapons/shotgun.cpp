@@ -43,7 +43,7 @@ void CShotgun::OnFire(CEntity *pFrom, CGameWorld *pWorld, vec2 Pos, vec2 Directi
 		a += Spreading[i + 2];
 		float v = 1 - (absolute(i) / (float) ShotSpread);
 		float Speed = mix((float) pWorld->GameServer()->Tuning()->m_ShotgunSpeeddiff, 1.0f, v);
-		new CProjectile(pWorld, WEAPON_SHOTGUN,
+		new(pWorld) CProjectile(pWorld, WEAPON_SHOTGUN,
 			pFrom,
 			Pos,
 			vec2(cosf(a), sinf(a)) * Speed,
@@ -34,7 +34,7 @@ public:
 
 void CSnipingRifle::OnFire(CEntity *pFrom, CGameWorld *pWorld, vec2 Pos, vec2 Direction, int *pReloadTimer)
 {
-	new CProjectile(pWorld, WEAPON_SHOTGUN,
+	new(pWorld) CProjectile(pWorld, WEAPON_SHOTGUN,
 		pFrom,
 		Pos,
 		Direction * 2.5f,
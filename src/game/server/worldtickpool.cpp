@@ -0,0 +1,91 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "gameworld.h"
+#include "worldtickpool.h"
+
+CWorldTickPool::CWorldTickPool() :
+	m_NextWorld(0)
+{
+	m_pvpWorlds = nullptr;
+	m_NumBusy = 0;
+	m_Batch = 0;
+	m_Shutdown = false;
+}
+
+CWorldTickPool::~CWorldTickPool()
+{
+	Shutdown();
+}
+
+void CWorldTickPool::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		m_Shutdown = true;
+	}
+	m_Start.notify_all();
+	for(std::thread &Thread : m_vThreads)
+		Thread.join();
+	m_vThreads.clear();
+	m_Shutdown = false;
+}
+
+void CWorldTickPool::TickWorlds()
+{
+	const int NumWorlds = m_pvpWorlds->size();
+	for(int i = m_NextWorld++; i < NumWorlds; i = m_NextWorld++)
+		(*m_pvpWorlds)[i]->TickParallel();
+}
+
+void CWorldTickPool::WorkerThread(unsigned LastBatch)
+{
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> Lock(m_Lock);
+			m_Start.wait(Lock, [&]() { return m_Shutdown || m_Batch != LastBatch; });
+			if(m_Shutdown)
+				return;
+			LastBatch = m_Batch;
+		}
+
+		TickWorlds();
+
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		if(--m_NumBusy == 0)
+			m_Finished.notify_one();
+	}
+}
+
+void CWorldTickPool::Run(const std::vector<CGameWorld *> &vpWorlds, int Threads)
+{
+	if(Threads != NumThreads())
+	{
+		Shutdown();
+		for(int i = 0; i < Threads; i++)
+			m_vThreads.emplace_back(&CWorldTickPool::WorkerThread, this, m_Batch);
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		m_pvpWorlds = &vpWorlds;
+		m_NextWorld = 0;
+		m_NumBusy = m_vThreads.size();
+		m_Batch++;
+	}
+	m_Start.notify_all();
+
+	TickWorlds();
+
+	// barrier, nothing may touch the worlds' buffers before every worker is done
+	std::unique_lock<std::mutex> Lock(m_Lock);
+	m_Finished.wait(Lock, [&]() { return m_NumBusy == 0; });
+	m_pvpWorlds = nullptr;
+}
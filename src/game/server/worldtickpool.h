@@ -0,0 +1,52 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef GAME_SERVER_WORLDTICKPOOL_H
+#define GAME_SERVER_WORLDTICKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CGameWorld;
+
+/*
+	Class: World Tick Pool
+		Worker threads that tick independent worlds. The calling thread
+		takes part as well, Run returns once every world has finished.
+*/
+class CWorldTickPool
+{
+	std::vector<std::thread> m_vThreads;
+	std::mutex m_Lock;
+	std::condition_variable m_Start;
+	std::condition_variable m_Finished;
+
+	const std::vector<CGameWorld *> *m_pvpWorlds;
+	std::atomic<int> m_NextWorld;
+	int m_NumBusy;
+	unsigned m_Batch;
+	bool m_Shutdown;
+
+	void WorkerThread(unsigned LastBatch);
+	void TickWorlds();
+
+public:
+	CWorldTickPool();
+	~CWorldTickPool();
+
+	void Run(const std::vector<CGameWorld *> &vpWorlds, int Threads);
+	void Shutdown();
+
+	int NumThreads() const { return m_vThreads.size(); }
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <base/system.h>
+
+#include "spatialgrid.h"
+
+#include <algorithm>
+
+CSpatialGrid::CSpatialGrid()
+{
+	m_Width = 0;
+	m_Height = 0;
+	m_NumLayers = 0;
+	m_MaxRadius = 0.0f;
+	m_VisitStamp = 0;
+}
+
+void CSpatialGrid::Init(float Width, float Height, int NumLayers)
+{
+	m_Width = maximum(1, (int) ceilf(Width / CELL_SIZE));
+	m_Height = maximum(1, (int) ceilf(Height / CELL_SIZE));
+	m_NumLayers = NumLayers;
+	m_MaxRadius = 0.0f;
+	m_vpCells.assign(m_Width * m_Height * m_NumLayers, nullptr);
+	m_vVisited.assign(m_Width * m_Height, 0);
+	m_VisitStamp = 0;
+}
+
+void CSpatialGrid::Clear()
+{
+	// unlink everything so the items don't point into a dead grid
+	for(CSpatialGridItem *&pFirst : m_vpCells)
+	{
+		while(pFirst)
+		{
+			CSpatialGridItem *pItem = pFirst;
+			pFirst = pItem->m_pNextCellItem;
+			pItem->m_pPrevCellItem = nullptr;
+			pItem->m_pNextCellItem = nullptr;
+			pItem->m_GridCell = -1;
+		}
+	}
+	m_Width = 0;
+	m_Height = 0;
+	m_vpCells.clear();
+	m_vVisited.clear();
+}
+
+unsigned CSpatialGrid::NextVisitStamp()
+{
+	if(++m_VisitStamp == 0)
+	{
+		std::fill(m_vVisited.begin(), m_vVisited.end(), 0);
+		m_VisitStamp = 1;
+	}
+	return m_VisitStamp;
+}
+
+void CSpatialGrid::Insert(CSpatialGridItem *pItem, int Layer, vec2 Pos, float Radius)
+{
+	dbg_assert(IsActive() && !pItem->InGrid(), "inserted an item twice or into an inactive grid");
+	dbg_assert(Layer >= 0 && Layer < m_NumLayers, "invalid grid layer");
+
+	m_MaxRadius = maximum(m_MaxRadius, Radius);
+
+	const int Cell = CellAt(Pos);
+	CSpatialGridItem *&pFirst = m_vpCells[Cell * m_NumLayers + Layer];
+	pItem->m_GridCell = Cell;
+	pItem->m_GridLayer = Layer;
+	pItem->m_pPrevCellItem = nullptr;
+	pItem->m_pNextCellItem = pFirst;
+	if(pFirst)
+		pFirst->m_pPrevCellItem = pItem;
+	pFirst = pItem;
+}
+
+void CSpatialGrid::Remove(CSpatialGridItem *pItem)
+{
+	if(!pItem->InGrid())
+		return;
+
+	if(pItem->m_pPrevCellItem)
+		pItem->m_pPrevCellItem->m_pNextCellItem = pItem->m_pNextCellItem;
+	else
+		m_vpCells[pItem->m_GridCell * m_NumLayers + pItem->m_GridLayer] = pItem->m_pNextCellItem;
+	if(pItem->m_pNextCellItem)
+		pItem->m_pNextCellItem->m_pPrevCellItem = pItem->m_pPrevCellItem;
+
+	pItem->m_pPrevCellItem = nullptr;
+	pItem->m_pNextCellItem = nullptr;
+	pItem->m_GridCell = -1;
+}
+
+void CSpatialGrid::Move(CSpatialGridItem *pItem, vec2 Pos)
+{
+	if(!pItem->InGrid() || pItem->m_GridCell == CellAt(Pos))
+		return;
+
+	const int Layer = pItem->m_GridLayer;
+	Remove(pItem);
+	Insert(pItem, Layer, Pos, 0.0f);
+}
@@ -0,0 +1,194 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef GAME_SPATIALGRID_H
+#define GAME_SPATIALGRID_H
+
+#include <base/math.h>
+#include <base/vmath.h>
+
+#include <vector>
+
+/*
+	Class: Spatial Grid Item
+		Intrusive cell membership of an object stored in a CSpatialGrid.
+*/
+class CSpatialGridItem
+{
+	friend class CSpatialGrid;
+
+	CSpatialGridItem *m_pPrevCellItem;
+	CSpatialGridItem *m_pNextCellItem;
+	int m_GridCell;
+	int m_GridLayer;
+
+public:
+	CSpatialGridItem() :
+		m_pPrevCellItem(nullptr), m_pNextCellItem(nullptr), m_GridCell(-1), m_GridLayer(0) {}
+
+	CSpatialGridItem *NextInCell() const { return m_pNextCellItem; }
+	bool InGrid() const { return m_GridCell >= 0; }
+	int GridCell() const { return m_GridCell; }
+};
+
+/*
+	Class: Spatial Grid
+		Uniform grid broad phase. Every cell keeps one list per layer,
+		items outside of the covered area are kept in the border cells.
+		Queries hand out cells, the caller does the exact tests.
+*/
+class CSpatialGrid
+{
+public:
+	enum
+	{
+		CELL_SHIFT = 8, // 256 units, 8 tiles
+		CELL_SIZE = 1 << CELL_SHIFT,
+	};
+
+private:
+	int m_Width;
+	int m_Height;
+	int m_NumLayers;
+	float m_MaxRadius;
+	std::vector<CSpatialGridItem *> m_vpCells;
+	std::vector<unsigned> m_vVisited;
+	unsigned m_VisitStamp;
+
+	int CellCoord(float Pos, int Size) const { return clamp((int) floorf(Pos / CELL_SIZE), 0, Size - 1); }
+	int CellIndex(int x, int y) const { return clamp(y, 0, m_Height - 1) * m_Width + clamp(x, 0, m_Width - 1); }
+	unsigned NextVisitStamp();
+
+public:
+	CSpatialGrid();
+
+	/*
+		Function: Init
+			Sets up an empty grid covering Width x Height world units.
+	*/
+	void Init(float Width, float Height, int NumLayers);
+	void Clear();
+	bool IsActive() const { return m_Width > 0; }
+
+	int CellAt(vec2 Pos) const { return CellCoord(Pos.y, m_Height) * m_Width + CellCoord(Pos.x, m_Width); }
+	int NumCells() const { return m_Width * m_Height; }
+
+	// Radius only widens the queries, it is the largest radius ever inserted
+	void Insert(CSpatialGridItem *pItem, int Layer, vec2 Pos, float Radius);
+	void Remove(CSpatialGridItem *pItem);
+	void Move(CSpatialGridItem *pItem, vec2 Pos);
+
+	float MaxRadius() const { return m_MaxRadius; }
+	CSpatialGridItem *First(int Cell, int Layer) const { return m_vpCells[Cell * m_NumLayers + Layer]; }
+
+	/*
+		Function: ForEachCell
+			Calls Fn(Cell) for every cell overlapping the box.
+			Stops as soon as Fn returns false.
+
+		Returns:
+			False if Fn stopped the walk.
+	*/
+	template<typename FCell>
+	bool ForEachCell(vec2 Min, vec2 Max, FCell &&Fn) const
+	{
+		const int x0 = CellCoord(Min.x, m_Width), x1 = CellCoord(Max.x, m_Width);
+		const int y0 = CellCoord(Min.y, m_Height), y1 = CellCoord(Max.y, m_Height);
+		for(int y = y0; y <= y1; y++)
+			for(int x = x0; x <= x1; x++)
+				if(!Fn(y * m_Width + x))
+					return false;
+		return true;
+	}
+
+	/*
+		Function: ForEachCellOnRay
+			Walks the cells along the segment with a DDA and calls Fn(Cell, MinDistance)
+			for every cell that can hold items within Thickness of the segment, each cell once.
+			MinDistance is a lower bound of the distance from From to the projection onto the
+			segment of anything in that cell, it never decreases during a walk.
+			Stops as soon as Fn returns false.
+	*/
+	template<typename FCell>
+	void ForEachCellOnRay(vec2 From, vec2 To, float Thickness, FCell &&Fn)
+	{
+		const int Ring = (int) ceilf(maximum(Thickness, 0.0f) / CELL_SIZE);
+		const float Slack = Thickness + (Ring + 1) * CELL_SIZE * 1.4143f;
+		const unsigned Stamp = NextVisitStamp();
+
+		int x = (int) floorf(From.x / CELL_SIZE);
+		int y = (int) floorf(From.y / CELL_SIZE);
+		const int EndX = (int) floorf(To.x / CELL_SIZE);
+		const int EndY = (int) floorf(To.y / CELL_SIZE);
+
+		auto VisitRing = [&](int cx, int cy, float MinDistance) -> bool {
+			for(int ny = cy - Ring; ny <= cy + Ring; ny++)
+			{
+				for(int nx = cx - Ring; nx <= cx + Ring; nx++)
+				{
+					const int Cell = CellIndex(nx, ny);
+					if(m_vVisited[Cell] == Stamp)
+						continue;
+					m_vVisited[Cell] = Stamp;
+					if(!Fn(Cell, MinDistance))
+						return false;
+				}
+			}
+			return true;
+		};
+
+		// segments reaching far outside the grid are cheaper as a box
+		const int NumSteps = absolute(EndX - x) + absolute(EndY - y);
+		if(NumSteps > m_Width + m_Height + 4 * (Ring + 1))
+		{
+			const vec2 Reach(Thickness, Thickness);
+			ForEachCell(vec2(minimum(From.x, To.x), minimum(From.y, To.y)) - Reach, vec2(maximum(From.x, To.x), maximum(From.y, To.y)) + Reach,
+				[&](int Cell) { return Fn(Cell, 0.0f); });
+			return;
+		}
+
+		const vec2 Dir = To - From;
+		const float Length = length(Dir);
+		const int StepX = Dir.x > 0.0f ? 1 : -1;
+		const int StepY = Dir.y > 0.0f ? 1 : -1;
+		const float Inf = 1e30f;
+		float tMaxX = Dir.x != 0.0f ? ((x + (StepX > 0)) * (float) CELL_SIZE - From.x) / Dir.x : Inf;
+		float tMaxY = Dir.y != 0.0f ? ((y + (StepY > 0)) * (float) CELL_SIZE - From.y) / Dir.y : Inf;
+		const float tDeltaX = Dir.x != 0.0f ? CELL_SIZE / absolute(Dir.x) : Inf;
+		const float tDeltaY = Dir.y != 0.0f ? CELL_SIZE / absolute(Dir.y) : Inf;
+		float tEntry = 0.0f;
+
+		for(int Step = 0; Step <= NumSteps; Step++)
+		{
+			if(!VisitRing(x, y, tEntry * Length - Slack))
+				return;
+			if(x == EndX && y == EndY)
+				return;
+
+			if(tMaxX < tMaxY)
+			{
+				tEntry = tMaxX;
+				tMaxX += tDeltaX;
+				x += StepX;
+			}
+			else
+			{
+				tEntry = tMaxY;
+				tMaxY += tDeltaY;
+				y += StepY;
+			}
+			tEntry = minimum(tEntry, 1.0f);
+		}
+
+		// rounding can leave the walk next to the last cell
+		VisitRing(EndX, EndY, Length - Slack);
+	}
+};
+
+#endif
@@ -0,0 +1,285 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <game/collision.h>
+
+#include "spawnevaluator.h"
+
+const vec2 CSpawnEvaluator::ms_aOffsets[NUM_OFFSETS] = {vec2(0.0f, 0.0f), vec2(-32.0f, 0.0f), vec2(0.0f, -32.0f), vec2(32.0f, 0.0f), vec2(0.0f, 32.0f)};
+
+CSpawnEvaluator::CSpawnEvaluator()
+{
+	m_pCollision = nullptr;
+	m_MaxRadius = 0.0f;
+	m_Synced = false;
+}
+
+void CSpawnEvaluator::SetCollision(const CCollision *pCollision)
+{
+	if(m_pCollision == pCollision)
+		return;
+
+	m_pCollision = pCollision;
+	for(auto &vSpawns : m_avSpawns)
+		for(SSpawn &Spawn : vSpawns)
+			Spawn.m_Dirty = true;
+}
+
+void CSpawnEvaluator::SetSpawnPoints(int Type, const std::vector<vec2> &vSpawnPoints)
+{
+	std::vector<SSpawn> &vSpawns = m_avSpawns[Type];
+	bool Changed = vSpawns.size() != vSpawnPoints.size();
+	for(unsigned i = 0; i < vSpawns.size() && !Changed; i++)
+		Changed = vSpawns[i].m_Pos != vSpawnPoints[i];
+	if(!Changed)
+		return;
+
+	vSpawns.resize(vSpawnPoints.size());
+	for(unsigned i = 0; i < vSpawns.size(); i++)
+	{
+		vSpawns[i].m_Pos = vSpawnPoints[i];
+		vSpawns[i].m_Dirty = true;
+		vSpawns[i].m_DangerValid = false;
+	}
+}
+
+void CSpawnEvaluator::BeginSync()
+{
+	// the cells keep their memory for the next sync
+	for(auto &[Key, vCell] : m_Cells)
+		vCell.clear();
+	m_BlockerCells.clear();
+	m_vDangerous.clear();
+	m_MaxRadius = 0.0f;
+	for(auto &vSpawns : m_avSpawns)
+	{
+		for(SSpawn &Spawn : vSpawns)
+		{
+			Spawn.m_Dirty = true;
+			Spawn.m_DangerValid = false;
+		}
+	}
+}
+
+void CSpawnEvaluator::InsertBlocker(const SBlocker &Blocker)
+{
+	const int64_t Key = CellKey(CellCoord(Blocker.m_Pos.x), CellCoord(Blocker.m_Pos.y));
+	m_Cells[Key].push_back(Blocker);
+	m_BlockerCells[Blocker.m_pKey] = Key;
+	m_MaxRadius = maximum(m_MaxRadius, Blocker.m_Radius);
+}
+
+void CSpawnEvaluator::AppendBlocker(const SBlocker &Blocker)
+{
+	InsertBlocker(Blocker);
+	if(Blocker.m_Dangerous)
+		m_vDangerous.push_back(Blocker);
+}
+
+bool CSpawnEvaluator::EraseBlocker(const void *pKey, SBlocker *pOld)
+{
+	auto Found = m_BlockerCells.find(pKey);
+	if(Found == m_BlockerCells.end())
+		return false;
+
+	std::vector<SBlocker> &vCell = m_Cells[Found->second];
+	m_BlockerCells.erase(Found);
+	for(unsigned i = 0; i < vCell.size(); i++)
+	{
+		if(vCell[i].m_pKey == pKey)
+		{
+			*pOld = vCell[i];
+			vCell[i] = vCell.back();
+			vCell.pop_back();
+			break;
+		}
+	}
+	return true;
+}
+
+void CSpawnEvaluator::MarkDirty(vec2 Pos, float Radius)
+{
+	for(auto &vSpawns : m_avSpawns)
+		for(SSpawn &Spawn : vSpawns)
+			if(distance(Spawn.m_Pos, Pos) <= CHECK_RADIUS + Radius + 1.0f)
+				Spawn.m_Dirty = true;
+}
+
+void CSpawnEvaluator::UpdateBlocker(const SBlocker &Blocker)
+{
+	MarkDirty(Blocker.m_Pos, Blocker.m_Radius);
+
+	SBlocker Old;
+	const bool Existed = EraseBlocker(Blocker.m_pKey, &Old);
+	if(Existed)
+		MarkDirty(Old.m_Pos, Old.m_Radius);
+	InsertBlocker(Blocker);
+
+	const bool WasDangerous = Existed && Old.m_Dangerous;
+	if(WasDangerous || Blocker.m_Dangerous)
+		UpdateDanger(WasDangerous ? &Old : nullptr, Blocker.m_Dangerous ? &Blocker : nullptr);
+
+	// a moved blocker keeps its place in the danger order, a new one goes in front
+	if(Existed && Old.m_Dangerous)
+	{
+		for(unsigned i = 0; i < m_vDangerous.size(); i++)
+		{
+			if(m_vDangerous[i].m_pKey == Blocker.m_pKey)
+			{
+				if(Blocker.m_Dangerous)
+					m_vDangerous[i] = Blocker;
+				else
+					m_vDangerous.erase(m_vDangerous.begin() + i);
+				return;
+			}
+		}
+	}
+	else if(Blocker.m_Dangerous)
+		m_vDangerous.insert(m_vDangerous.begin(), Blocker);
+}
+
+void CSpawnEvaluator::RemoveBlocker(const void *pKey)
+{
+	SBlocker Old;
+	if(!EraseBlocker(pKey, &Old))
+		return;
+
+	MarkDirty(Old.m_Pos, Old.m_Radius);
+	if(!Old.m_Dangerous)
+		return;
+	UpdateDanger(&Old, nullptr);
+	for(unsigned i = 0; i < m_vDangerous.size(); i++)
+	{
+		if(m_vDangerous[i].m_pKey == pKey)
+		{
+			m_vDangerous.erase(m_vDangerous.begin() + i);
+			return;
+		}
+	}
+}
+
+void CSpawnEvaluator::UpdateSpawn(SSpawn *pSpawn) const
+{
+	bool Near = false;
+	unsigned Blocked = 0;
+	const float Reach = CHECK_RADIUS + m_MaxRadius;
+	const int x0 = CellCoord(pSpawn->m_Pos.x - Reach), x1 = CellCoord(pSpawn->m_Pos.x + Reach);
+	const int y0 = CellCoord(pSpawn->m_Pos.y - Reach), y1 = CellCoord(pSpawn->m_Pos.y + Reach);
+	for(int y = y0; y <= y1; y++)
+	{
+		for(int x = x0; x <= x1; x++)
+		{
+			auto Found = m_Cells.find(CellKey(x, y));
+			if(Found == m_Cells.end())
+				continue;
+			for(const SBlocker &Blocker : Found->second)
+			{
+				if(distance(Blocker.m_Pos, pSpawn->m_Pos) >= CHECK_RADIUS + Blocker.m_Radius)
+					continue;
+				Near = true;
+				for(int i = 0; i < NUM_OFFSETS; i++)
+					if(distance(Blocker.m_Pos, pSpawn->m_Pos + ms_aOffsets[i]) <= Blocker.m_Radius)
+						Blocked |= 1u << i;
+			}
+		}
+	}
+
+	// the collision only counts with somebody around, like it always did
+	if(Near)
+	{
+		for(int i = 0; i < NUM_OFFSETS; i++)
+			if(m_pCollision->CheckPoint(pSpawn->m_Pos + ms_aOffsets[i]))
+				Blocked |= 1u << i;
+	}
+
+	const int OldOffset = pSpawn->m_FreeOffset;
+	pSpawn->m_FreeOffset = -1;
+	for(int i = 0; i < NUM_OFFSETS && pSpawn->m_FreeOffset == -1; i++)
+		if(!(Blocked & (1u << i)))
+			pSpawn->m_FreeOffset = i;
+	pSpawn->m_Dirty = false;
+
+	// the danger was summed up for the old position
+	if(pSpawn->m_FreeOffset != OldOffset)
+		pSpawn->m_DangerValid = false;
+}
+
+int CSpawnEvaluator::FreeOffset(int Type, int Index)
+{
+	SSpawn &Spawn = m_avSpawns[Type][Index];
+	if(Spawn.m_Dirty)
+		UpdateSpawn(&Spawn);
+	return Spawn.m_FreeOffset;
+}
+
+float CSpawnEvaluator::BlockerDanger(const SBlocker &Blocker, vec2 Pos, int FriendlyTeam)
+{
+	// team mates are not as dangerous as enemies
+	float Scoremod = 1.0f;
+	if(FriendlyTeam != -1 && Blocker.m_Team == FriendlyTeam)
+		Scoremod = 0.5f;
+
+	float d = distance(Pos, Blocker.m_Pos);
+	return Scoremod * (d == 0 ? 1000000000.0f : 1.0f / d);
+}
+
+float CSpawnEvaluator::CalculateDanger(vec2 Pos, int FriendlyTeam) const
+{
+	float Score = 0.0f;
+	for(const SBlocker &Blocker : m_vDangerous)
+		Score += BlockerDanger(Blocker, Pos, FriendlyTeam);
+	return Score;
+}
+
+void CSpawnEvaluator::UpdateDanger(const SBlocker *pOld, const SBlocker *pNew)
+{
+	// the last character is gone, start from zero instead of the rounding leftovers
+	const bool Empty = !pNew && m_vDangerous.size() == 1;
+	for(auto &vSpawns : m_avSpawns)
+	{
+		for(SSpawn &Spawn : vSpawns)
+		{
+			if(!Spawn.m_DangerValid)
+				continue;
+			const vec2 Pos = Spawn.m_Pos + ms_aOffsets[maximum(Spawn.m_FreeOffset, 0)];
+			for(int Slot = 0; Slot < 3; Slot++)
+			{
+				if(Empty)
+					Spawn.m_aDanger[Slot] = 0.0;
+				else
+				{
+					if(pOld)
+						Spawn.m_aDanger[Slot] -= BlockerDanger(*pOld, Pos, Slot - 1);
+					if(pNew)
+						Spawn.m_aDanger[Slot] += BlockerDanger(*pNew, Pos, Slot - 1);
+				}
+			}
+		}
+	}
+}
+
+float CSpawnEvaluator::Danger(int Type, int Index, int FriendlyTeam)
+{
+	const int Offset = FreeOffset(Type, Index);
+	SSpawn &Spawn = m_avSpawns[Type][Index];
+	const vec2 Pos = Spawn.m_Pos + ms_aOffsets[maximum(Offset, 0)];
+	if(FriendlyTeam < -1 || FriendlyTeam > 1)
+		return CalculateDanger(Pos, FriendlyTeam);
+
+	if(!Spawn.m_DangerValid)
+	{
+		for(double &Danger : Spawn.m_aDanger)
+			Danger = 0.0;
+		for(const SBlocker &Blocker : m_vDangerous)
+			for(int Slot = 0; Slot < 3; Slot++)
+				Spawn.m_aDanger[Slot] += BlockerDanger(Blocker, Pos, Slot - 1);
+		Spawn.m_DangerValid = true;
+	}
+	return Spawn.m_aDanger[FriendlyTeam + 1];
+}
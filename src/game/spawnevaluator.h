@@ -0,0 +1,127 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef GAME_SPAWNEVALUATOR_H
+#define GAME_SPAWNEVALUATOR_H
+
+#include <base/vmath.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class CCollision;
+
+/*
+	Class: Spawn Evaluator
+		Keeps which offset of every spawn point is free and how dangerous
+		spawning there is. A sync takes all blockers at once, after that
+		only the spawn points near a changed blocker are evaluated again.
+		Blockers are kept by cell, so a spawn point only looks at the
+		ones around it. The danger of a spawn point follows the characters
+		by taking out the old share of a moved one and adding the new one.
+		The results are the same as testing every spawn point against
+		every entity on each request.
+*/
+class CSpawnEvaluator
+{
+public:
+	enum
+	{
+		NUM_SPAWN_TYPES = 3,
+		NUM_OFFSETS = 5,
+	};
+
+	// entities closer than this plus their radius to a spawn point block it
+	static constexpr float CHECK_RADIUS = 64.0f;
+	// start, left, up, right, down
+	static const vec2 ms_aOffsets[NUM_OFFSETS];
+
+	struct SBlocker
+	{
+		const void *m_pKey;
+		vec2 m_Pos;
+		float m_Radius;
+		// only characters make a spawn point dangerous, team mates half as much
+		bool m_Dangerous;
+		int m_Team;
+	};
+
+private:
+	enum
+	{
+		CELL_SHIFT = 7, // 128 units, a spawn point checks the cells around it
+	};
+
+	struct SSpawn
+	{
+		vec2 m_Pos;
+		int m_FreeOffset;
+		bool m_Dirty;
+		// danger at the free offset for friendly team -1, 0 and 1, summed
+		// up again when the free offset changed
+		double m_aDanger[3];
+		bool m_DangerValid;
+	};
+
+	const CCollision *m_pCollision;
+	std::vector<SSpawn> m_avSpawns[NUM_SPAWN_TYPES];
+	// dangerous blockers in the order the danger is summed up
+	std::vector<SBlocker> m_vDangerous;
+	// all blockers by cell, and the cell of every blocker
+	std::unordered_map<int64_t, std::vector<SBlocker>> m_Cells;
+	std::unordered_map<const void *, int64_t> m_BlockerCells;
+	// largest blocker radius since the sync, widens the cell queries
+	float m_MaxRadius;
+	bool m_Synced;
+
+	static int64_t CellKey(int x, int y) { return ((int64_t) y << 32) | (uint32_t) x; }
+	static int CellCoord(float Pos) { return (int) floorf(Pos / (1 << CELL_SHIFT)); }
+	void InsertBlocker(const SBlocker &Blocker);
+	// takes the blocker out of its cell, false if it is unknown
+	bool EraseBlocker(const void *pKey, SBlocker *pOld);
+	void MarkDirty(vec2 Pos, float Radius);
+	void UpdateSpawn(SSpawn *pSpawn) const;
+	static float BlockerDanger(const SBlocker &Blocker, vec2 Pos, int FriendlyTeam);
+	float CalculateDanger(vec2 Pos, int FriendlyTeam) const;
+	// moves the danger of all spawn points from the old state of a blocker to the new one
+	void UpdateDanger(const SBlocker *pOld, const SBlocker *pNew);
+
+public:
+	CSpawnEvaluator();
+
+	void SetCollision(const CCollision *pCollision);
+	// takes over the spawn points of a type when they changed
+	void SetSpawnPoints(int Type, const std::vector<vec2> &vSpawnPoints);
+
+	/*
+		Function: BeginSync
+			Drops all blockers. Append the current ones in danger order
+			and finish with EndSync.
+	*/
+	void BeginSync();
+	void AppendBlocker(const SBlocker &Blocker);
+	void EndSync() { m_Synced = true; }
+	// the blockers are outdated, needs a sync before the next evaluation
+	void Invalidate() { m_Synced = false; }
+	bool IsSynced() const { return m_Synced; }
+
+	// adds a blocker in front or moves an existing one, only while synced
+	void UpdateBlocker(const SBlocker &Blocker);
+	void RemoveBlocker(const void *pKey);
+
+	int NumSpawnPoints(int Type) const { return m_avSpawns[Type].size(); }
+	vec2 SpawnPoint(int Type, int Index) const { return m_avSpawns[Type][Index].m_Pos; }
+	// first offset of the spawn point without anything in the way, -1 when all are blocked
+	int FreeOffset(int Type, int Index);
+	// sum of 1/distance of all characters to the free offset, see SBlocker
+	float Danger(int Type, int Index, int FriendlyTeam);
+};
+
+#endif
@@ -133,6 +133,9 @@ MACRO_CONFIG_INT(SvInactiveKick, sv_inactivekick, 2, 1, 3, CFGFLAG_SAVE | CFGFLA
 MACRO_CONFIG_INT(SvInactiveKickSpec, sv_inactivekick_spec, 0, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Kick inactive spectators")
 
 MACRO_CONFIG_INT(SvSilentSpectatorMode, sv_silent_spectator_mode, 1, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Mute join/leave message of spectator")
+MACRO_CONFIG_INT(SvBotLodRadius, sv_bot_lod_radius, 1600, 0, 100000, CFGFLAG_SAVE | CFGFLAG_SERVER, "Bots farther than this from every player sleep until one comes closer (0=bots never sleep)")
+MACRO_CONFIG_INT(SvWorldThreads, sv_world_threads, 0, 0, 16, CFGFLAG_SAVE | CFGFLAG_SERVER, "Number of extra threads used to tick game worlds (0=tick all worlds on the main thread)")
+MACRO_CONFIG_INT(SvSweptCollision, sv_swept_collision, 0, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Resolve character and flag movement tile edge to tile edge (changes physics slightly, clients predict the old way, applies to newly loaded worlds)")
 
 MACRO_CONFIG_INT(SvStrictSpectateMode, sv_strict_spectate_mode, 0, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Restricts information in spectator mode")
 MACRO_CONFIG_INT(SvVoteSpectate, sv_vote_spectate, 1, 0, 1, CFGFLAG_SAVE | CFGFLAG_SERVER, "Allow voting to move players to spectators")
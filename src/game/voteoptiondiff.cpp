@@ -0,0 +1,122 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <base/system.h>
+
+#include "voteoptiondiff.h"
+#include "voting.h"
+
+#include <string>
+
+// what a client keeps of an added option: leading '#' mark the depth, control characters become spaces
+static std::string ShownDescription(const char *pDesc)
+{
+	while(*pDesc == '#')
+		pDesc++;
+	std::string Shown(pDesc);
+	for(char &c : Shown)
+	{
+		if((unsigned char) c < 32)
+			c = ' ';
+	}
+	return Shown;
+}
+
+// the remove message loses control characters and leading whitespace on the way
+static bool CanRemove(const char *pDesc)
+{
+	if(pDesc[0] == '#' || str_utf8_skip_whitespaces(pDesc) != pDesc)
+		return false;
+	for(; *pDesc; pDesc++)
+	{
+		if((unsigned char) *pDesc < 32)
+			return false;
+	}
+	return true;
+}
+
+CVoteOptionDiff::CVoteOptionDiff()
+{
+	PlanClear(0);
+}
+
+int CVoteOptionDiff::NumAddMessages(int NumOptions)
+{
+	return (NumOptions + MAX_VOTE_OPTION_ADD - 1) / MAX_VOTE_OPTION_ADD;
+}
+
+int CVoteOptionDiff::NumMessages() const
+{
+	if(m_Clear)
+		return 1 + NumAddMessages(m_NumNew);
+	return (int) m_vRemovals.size() + NumAddMessages(m_NumNew - m_NumKept);
+}
+
+void CVoteOptionDiff::PlanClear(int NumNew)
+{
+	m_Clear = true;
+	m_NumNew = NumNew;
+	m_NumKept = 0;
+	m_vRemovals.clear();
+}
+
+void CVoteOptionDiff::Plan(const char *const *ppOld, int NumOld, const char *const *ppNew, int NumNew)
+{
+	m_Clear = false;
+	m_NumNew = NumNew;
+	m_vRemovals.clear();
+
+	// the longest leading part of the new list found in order in the old one
+	m_NumKept = 0;
+	for(int i = 0; i < NumOld; i++)
+	{
+		if(m_NumKept < NumNew && str_comp(ppOld[i], ppNew[m_NumKept]) == 0)
+			m_NumKept++;
+		else
+			m_vRemovals.push_back(i);
+	}
+
+	if(NumMessages() > 1 + NumAddMessages(NumNew))
+	{
+		PlanClear(NumNew);
+		return;
+	}
+
+	// replay the removals the way the client does them, it matches descriptions only
+	std::vector<std::string> vShown;
+	std::vector<int> vShownIndices;
+	for(int i = 0; i < NumOld; i++)
+	{
+		vShown.push_back(ShownDescription(ppOld[i]));
+		vShownIndices.push_back(i);
+	}
+	for(int Removal : m_vRemovals)
+	{
+		const char *pDesc = ppOld[Removal];
+		if(!CanRemove(pDesc))
+		{
+			PlanClear(NumNew);
+			return;
+		}
+		for(unsigned i = 0; i < vShown.size(); i++)
+		{
+			if(vShown[i] == pDesc)
+			{
+				vShown.erase(vShown.begin() + i);
+				vShownIndices.erase(vShownIndices.begin() + i);
+				break;
+			}
+		}
+	}
+	bool Match = (int) vShownIndices.size() == m_NumKept;
+	for(int i = 0; i < m_NumKept && Match; i++)
+		Match = str_comp(ppOld[vShownIndices[i]], ppNew[i]) == 0;
+	if(!Match)
+		PlanClear(NumNew);
+}
@@ -0,0 +1,52 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef GAME_VOTEOPTIONDIFF_H
+#define GAME_VOTEOPTIONDIFF_H
+
+#include <vector>
+
+/*
+	Class: Vote Option Diff
+		Works out the vital messages that turn the vote option list a
+		client shows into a new one. Clients append added options at the
+		end and drop the first option with a removed description, so only
+		a leading part of the new list can stay. Everything behind it is
+		removed and added again.
+
+		When that takes more messages than clearing the list and sending
+		it whole, or when the client would drop the wrong option, the plan
+		clears instead.
+*/
+class CVoteOptionDiff
+{
+	bool m_Clear;
+	int m_NumNew;
+	int m_NumKept;
+	std::vector<int> m_vRemovals;
+
+public:
+	CVoteOptionDiff();
+
+	void Plan(const char *const *ppOld, int NumOld, const char *const *ppNew, int NumNew);
+	// for a client whose list is not known
+	void PlanClear(int NumNew);
+
+	// clear the client's list first, nothing is kept then
+	bool Clear() const { return m_Clear; }
+	// indices into the old list to remove, in this order
+	const std::vector<int> &Removals() const { return m_vRemovals; }
+	// leading new options the client keeps, the rest is added after the removals
+	int NumKept() const { return m_NumKept; }
+
+	int NumMessages() const;
+	static int NumAddMessages(int NumOptions);
+};
+
+#endif
@@ -0,0 +1,215 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+#include <game/collision.h>
+
+#include <vector>
+
+static void ExpectSameIntersection(const CCollision &Collision, vec2 Pos0, vec2 Pos1)
+{
+	vec2 aExpected[2];
+	vec2 aResult[2];
+	const int Expected = IntersectLineSampled(Collision, Pos0, Pos1, &aExpected[0], &aExpected[1]);
+	const int Result = Collision.IntersectLine(Pos0, Pos1, &aResult[0], &aResult[1]);
+	SCOPED_TRACE(testing::Message() << "from " << Pos0.x << "," << Pos0.y << " to " << Pos1.x << "," << Pos1.y);
+	ASSERT_EQ(Expected, Result);
+	ASSERT_EQ(mem_comp(aExpected, aResult, sizeof(aExpected)), 0);
+}
+
+TEST(Collision, IntersectLineRandom)
+{
+	for(int Map = 0; Map < 4; Map++)
+	{
+		CCollision Collision;
+		CreateTestMap(&Collision, 100, 60, 0.01f + Map * 0.05f, Map + 1);
+		CTestRandom Random(Map + 100);
+		for(int i = 0; i < 20000 && !HasFatalFailure(); i++)
+		{
+			// mostly laser and hook sized lines, some across the whole map and beyond its borders
+			vec2 Pos0(Random.Range(-100.0f, 3300.0f), Random.Range(-100.0f, 2000.0f));
+			float Length = Random.Next() < 0.8f ? Random.Range(0.0f, 800.0f) : Random.Range(0.0f, 4000.0f);
+			float Angle = Random.Range(0.0f, 2 * pi);
+			ExpectSameIntersection(Collision, Pos0, Pos0 + direction(Angle) * Length);
+		}
+	}
+}
+
+TEST(Collision, IntersectLineEdgeCases)
+{
+	CCollision Collision;
+	CreateTestMap(&Collision, 40, 40, 0.1f, 7);
+	CTestRandom Random(7);
+
+	for(int i = 0; i < 5000 && !HasFatalFailure(); i++)
+	{
+		// snapped to tile borders and half pixels, where the rounding decides
+		vec2 Pos0(32 * (int) Random.Range(0, 40) + (int) Random.Range(-2, 3) * 0.5f, 32 * (int) Random.Range(0, 40) - 0.5f);
+		vec2 Pos1(32 * (int) Random.Range(0, 40) - 0.5f, 32 * (int) Random.Range(0, 40) + (int) Random.Range(-2, 3) * 0.5f);
+		ExpectSameIntersection(Collision, Pos0, Pos1);
+		// axis aligned along a tile border
+		ExpectSameIntersection(Collision, vec2(Pos0.x, Pos0.y), vec2(Pos0.x, Pos1.y));
+		ExpectSameIntersection(Collision, vec2(Pos0.x, Pos0.y), vec2(Pos1.x, Pos0.y));
+		// diagonals through tile corners
+		ExpectSameIntersection(Collision, Pos0, Pos0 + vec2(1.0f, 1.0f) * (32.0f * (int) Random.Range(1, 20)));
+		ExpectSameIntersection(Collision, Pos0, Pos0 + vec2(-1.0f, 1.0f) * (32.0f * (int) Random.Range(1, 20)));
+	}
+
+	// zero length, very short and completely outside of the map
+	ExpectSameIntersection(Collision, vec2(100.0f, 100.0f), vec2(100.0f, 100.0f));
+	ExpectSameIntersection(Collision, vec2(100.0f, 100.0f), vec2(100.3f, 100.2f));
+	ExpectSameIntersection(Collision, vec2(-500.0f, -500.0f), vec2(-100.0f, -900.0f));
+	ExpectSameIntersection(Collision, vec2(5000.0f, 300.0f), vec2(100.0f, 300.0f));
+}
+
+TEST(Collision, IntersectLineEmptyMap)
+{
+	CCollision Collision;
+	CreateTestMap(&Collision, 300, 300, 0.0f, 1);
+	CTestRandom Random(11);
+	for(int i = 0; i < 2000 && !HasFatalFailure(); i++)
+	{
+		vec2 Pos0(Random.Range(0.0f, 9600.0f), Random.Range(0.0f, 9600.0f));
+		vec2 Pos1(Random.Range(-200.0f, 9800.0f), Random.Range(-200.0f, 9800.0f));
+		ExpectSameIntersection(Collision, Pos0, Pos1);
+	}
+}
+
+TEST(Collision, SetFlagForUpdatesLines)
+{
+	CCollision Collision;
+	CreateTestMap(&Collision, 40, 40, 0.0f, 1);
+
+	vec2 Out, Before;
+	EXPECT_EQ(Collision.IntersectLine(vec2(100.0f, 600.0f), vec2(1100.0f, 600.0f), &Out, &Before), 0);
+	Collision.SetFlagFor(vec2(600.0f, 600.0f), CCollision::COLFLAG_SOLID);
+	EXPECT_EQ(Collision.IntersectLine(vec2(100.0f, 600.0f), vec2(1100.0f, 600.0f), &Out, &Before), (int) CCollision::COLFLAG_SOLID);
+	ExpectSameIntersection(Collision, vec2(100.0f, 600.0f), vec2(1100.0f, 600.0f));
+	Collision.SetFlagFor(vec2(600.0f, 600.0f), 0);
+	EXPECT_EQ(Collision.IntersectLine(vec2(100.0f, 600.0f), vec2(1100.0f, 600.0f), &Out, &Before), 0);
+}
+
+TEST(Collision, MoveBoxExactMatchesStepped)
+{
+	for(int Map = 0; Map < 3; Map++)
+	{
+		CCollision Collision;
+		CreateTestMap(&Collision, 80, 50, 0.05f + Map * 0.05f, Map + 20);
+		CTestRandom Random(Map + 200);
+		std::vector<STestBody> vBodies = CreateTestBodies(&Random, 100, vec2(80 * 32.0f, 50 * 32.0f));
+		const float Elasticity = Map == 0 ? 0.0f : 0.5f;
+
+		for(int Tick = 0; Tick < 500 && !HasFatalFailure(); Tick++)
+		{
+			for(STestBody &Body : vBodies)
+			{
+				KickTestBody(&Random, &Body);
+				vec2 aPos[2] = {Body.m_Pos, Body.m_Pos};
+				vec2 aVel[2] = {Body.m_Vel, Body.m_Vel};
+				bool aDeath[2];
+				MoveBoxStepped(Collision, &aPos[0], &aVel[0], vec2(28.0f, 28.0f), Elasticity, &aDeath[0]);
+				Collision.MoveBox(&aPos[1], &aVel[1], vec2(28.0f, 28.0f), Elasticity, &aDeath[1]);
+				ASSERT_EQ(mem_comp(&aPos[0], &aPos[1], sizeof(vec2)), 0);
+				ASSERT_EQ(mem_comp(&aVel[0], &aVel[1], sizeof(vec2)), 0);
+				ASSERT_EQ(aDeath[0], aDeath[1]);
+				// quantize like the character core does
+				Body.m_Pos = vec2(round_to_int(aPos[1].x), round_to_int(aPos[1].y));
+				Body.m_Vel = vec2(round_to_int(aVel[1].x * 256.0f) / 256.0f, round_to_int(aVel[1].y * 256.0f) / 256.0f);
+			}
+		}
+	}
+}
+
+static bool BoxOverlapsSolid(const CCollision &Collision, vec2 Pos, vec2 Half)
+{
+	for(int y = (int) floorf((Pos.y - Half.y + 0.1f) / 32.0f); y <= (int) floorf((Pos.y + Half.y - 0.1f) / 32.0f); y++)
+		for(int x = (int) floorf((Pos.x - Half.x + 0.1f) / 32.0f); x <= (int) floorf((Pos.x + Half.x - 0.1f) / 32.0f); x++)
+			if(Collision.CheckPoint(x * 32.0f + 16.0f, y * 32.0f + 16.0f))
+				return true;
+	return false;
+}
+
+TEST(Collision, MoveBoxSweptStaysOutside)
+{
+	for(int Map = 0; Map < 3; Map++)
+	{
+		CCollision Collision;
+		CreateTestMap(&Collision, 80, 50, 0.05f + Map * 0.05f, Map + 30);
+		Collision.SetSweptMoveBox(true);
+		CTestRandom Random(Map + 300);
+		std::vector<STestBody> vBodies = CreateTestBodies(&Random, 100, vec2(80 * 32.0f, 50 * 32.0f));
+		const vec2 Half(14.0f, 14.0f);
+
+		for(int Tick = 0; Tick < 500 && !HasFatalFailure(); Tick++)
+		{
+			for(STestBody &Body : vBodies)
+			{
+				KickTestBody(&Random, &Body);
+				const bool Inside = BoxOverlapsSolid(Collision, Body.m_Pos, Half);
+				Collision.MoveBox(&Body.m_Pos, &Body.m_Vel, Half * 2.0f, Map == 0 ? 0.0f : 0.5f);
+				if(!Inside)
+				{
+					SCOPED_TRACE(testing::Message() << "tick " << Tick << " at " << Body.m_Pos.x << "," << Body.m_Pos.y);
+					ASSERT_FALSE(BoxOverlapsSolid(Collision, Body.m_Pos, Half));
+				}
+			}
+		}
+	}
+}
+
+TEST(Collision, MoveBoxSweptEdges)
+{
+	CCollision Collision;
+	CreateTestMap(&Collision, 20, 20, 0.0f, 1);
+	Collision.SetSweptMoveBox(true);
+
+	// free flight moves the whole way
+	vec2 Pos(320.0f, 320.0f);
+	vec2 Vel(37.5f, -12.25f);
+	Collision.MoveBox(&Pos, &Vel, vec2(28.0f, 28.0f), 0.0f);
+	EXPECT_EQ(Pos, vec2(357.5f, 307.75f));
+	EXPECT_EQ(Vel, vec2(37.5f, -12.25f));
+
+	// landing on the bottom border stops exactly on its edge, and keeps sliding
+	Pos = vec2(320.0f, 19 * 32.0f - 20.0f);
+	Vel = vec2(5.0f, 30.0f);
+	Collision.MoveBox(&Pos, &Vel, vec2(28.0f, 28.0f), 0.0f);
+	EXPECT_EQ(Pos, vec2(325.0f, 19 * 32.0f - 14.0f));
+	EXPECT_EQ(Vel.y, 0.0f);
+	Vel = vec2(5.0f, 1.0f);
+	Collision.MoveBox(&Pos, &Vel, vec2(28.0f, 28.0f), 0.0f);
+	EXPECT_EQ(Pos, vec2(330.0f, 19 * 32.0f - 14.0f));
+
+	// bouncing off the left border with the rest of the move
+	Pos = vec2(32.0f + 20.0f, 320.0f);
+	Vel = vec2(-16.0f, 0.0f);
+	Collision.MoveBox(&Pos, &Vel, vec2(28.0f, 28.0f), 0.5f);
+	EXPECT_EQ(Pos, vec2(32.0f + 14.0f + 5.0f, 320.0f));
+	EXPECT_EQ(Vel, vec2(8.0f, 0.0f));
+
+	// fast enough to tunnel through a single tile with per tick tests
+	Collision.SetFlagFor(vec2(10 * 32.0f + 16.0f, 5 * 32.0f + 16.0f), CCollision::COLFLAG_SOLID);
+	Pos = vec2(5 * 32.0f, 5 * 32.0f + 16.0f);
+	Vel = vec2(200.0f, 0.0f);
+	Collision.MoveBox(&Pos, &Vel, vec2(28.0f, 28.0f), 0.0f);
+	EXPECT_EQ(Pos, vec2(10 * 32.0f - 14.0f, 5 * 32.0f + 16.0f));
+
+	// death tiles on the way are found
+	Collision.SetFlagFor(vec2(3 * 32.0f + 16.0f, 10 * 32.0f + 16.0f), CCollision::COLFLAG_DEATH);
+	Pos = vec2(32.0f + 16.0f, 10 * 32.0f + 16.0f);
+	Vel = vec2(150.0f, 0.0f);
+	bool Death;
+	Collision.MoveBox(&Pos, &Vel, vec2(28.0f, 28.0f), 0.0f, &Death);
+	EXPECT_TRUE(Death);
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+
+#include <engine/shared/config.h>
+#include <engine/shared/console.h>
+
+#include <string>
+#include <vector>
+
+struct CCallLog
+{
+	std::vector<std::string> m_vCalls;
+};
+
+static void ConLog(IConsole::IResult *pResult, void *pUserData)
+{
+	CCallLog *pLog = static_cast<CCallLog *>(pUserData);
+	std::string Call = std::to_string(pResult->NumArguments());
+	for(int i = 0; i < pResult->NumArguments(); i++)
+		Call += std::string("|") + pResult->GetString(i);
+	pLog->m_vCalls.push_back(Call);
+}
+
+struct CLateRegister
+{
+	CConsole *m_pConsole;
+	CCallLog *m_pLog;
+};
+
+static void ConRegisterLate(IConsole::IResult *pResult, void *pUserData)
+{
+	CLateRegister *pData = static_cast<CLateRegister *>(pUserData);
+	pData->m_pConsole->Register("late", "i", CFGFLAG_SERVER, ConLog, pData->m_pLog, "");
+}
+
+static std::vector<std::string> RunScript(bool UseCache, const std::vector<std::string> &vLines)
+{
+	CConsole Console(CFGFLAG_SERVER);
+	Console.SetParsedLineCache(UseCache);
+	CCallLog Log;
+	Console.Register("add_vote", "s[name] r[command]", CFGFLAG_SERVER, ConLog, &Log, "");
+	Console.Register("sv_test", "?i", CFGFLAG_SERVER, ConLog, &Log, "");
+	Console.Register("say", "r[text]", CFGFLAG_SERVER, ConLog, &Log, "");
+	Console.StoreCommands(false);
+	for(int Repeat = 0; Repeat < 3; Repeat++)
+	{
+		for(const std::string &Line : vLines)
+			Console.ExecuteLine(Line.c_str());
+	}
+	return Log.m_vCalls;
+}
+
+TEST(Console, FindCommandNoCase)
+{
+	CConsole Console(CFGFLAG_SERVER);
+	Console.StoreCommands(false);
+	CCallLog Log;
+	Console.Register("sv_test", "?i", CFGFLAG_SERVER, ConLog, &Log, "");
+	Console.Register("sv_other", "?i", CFGFLAG_CLIENT, ConLog, &Log, "");
+
+	Console.ExecuteLine("SV_Test 5");
+	Console.ExecuteLine("sv_other 5");
+	ASSERT_EQ(Log.m_vCalls.size(), 1u);
+	EXPECT_EQ(Log.m_vCalls[0], "1|5");
+
+	EXPECT_NE(Console.GetCommandInfo("SV_TEST", CFGFLAG_SERVER, false), nullptr);
+	EXPECT_EQ(Console.GetCommandInfo("sv_other", CFGFLAG_SERVER, false), nullptr);
+	EXPECT_EQ(Console.GetCommandInfo("sv_test", CFGFLAG_SERVER, true), nullptr);
+}
+
+TEST(Console, ParsedLinesMatchParsing)
+{
+	std::vector<std::string> vLines = {
+		"sv_test 3",
+		"sv_test",
+		"sv_test 1; sv_test 2 # comment; sv_test 4",
+		"add_vote \"Restart\" restart 10",
+		"add_vote \"Say \\\"hi\\\"\" say \"quoted; not split\"; say done  ",
+		"add_vote missing_command_argument",
+		"unknown_command 1; sv_test 7",
+		"sv_test 8; ; sv_test 9",
+		"   ",
+		"",
+	};
+	std::vector<std::string> vUncached = RunScript(false, vLines);
+	std::vector<std::string> vCached = RunScript(true, vLines);
+	EXPECT_FALSE(vUncached.empty());
+	EXPECT_EQ(vCached, vUncached);
+}
+
+TEST(Console, ParsedLinesFollowRegistrations)
+{
+	CConsole Console(CFGFLAG_SERVER);
+	Console.StoreCommands(false);
+	CCallLog Log;
+
+	Console.RegisterTemp("temp_cmd", "i", CFGFLAG_SERVER, "");
+	Console.Register("logged", "i", CFGFLAG_SERVER, ConLog, &Log, "");
+	Console.ExecuteLine("logged 1");
+	EXPECT_EQ(Console.NumParsedLines(), 1);
+
+	// re-registering must not leave the old parameters in the cache
+	Console.Register("logged", "i i", CFGFLAG_SERVER, ConLog, &Log, "");
+	Console.ExecuteLine("logged 1");
+	Console.ExecuteLine("logged 1 2");
+	ASSERT_EQ(Log.m_vCalls.size(), 2u);
+	EXPECT_EQ(Log.m_vCalls[1], "2|1|2");
+
+	Console.DeregisterTemp("temp_cmd");
+	EXPECT_EQ(Console.GetCommandInfo("temp_cmd", CFGFLAG_SERVER, true), nullptr);
+	Console.RegisterTemp("temp_cmd", "i", CFGFLAG_SERVER, "");
+	EXPECT_NE(Console.GetCommandInfo("temp_cmd", CFGFLAG_SERVER, true), nullptr);
+	Console.DeregisterTempAll();
+	EXPECT_EQ(Console.GetCommandInfo("temp_cmd", CFGFLAG_SERVER, true), nullptr);
+
+	// commands registered by an earlier command of the same line are found
+	CLateRegister Late = {&Console, &Log};
+	Console.Register("register_late", "", CFGFLAG_SERVER, ConRegisterLate, &Late, "");
+	Console.ExecuteLine("late 1; register_late; late 2");
+	ASSERT_EQ(Log.m_vCalls.size(), 3u);
+	EXPECT_EQ(Log.m_vCalls[2], "1|2");
+}
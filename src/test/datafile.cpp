@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 
 #include <engine/shared/datafile.h>
+#include <engine/shared/protocol_ex.h>
 #include <engine/storage.h>
 
 TEST(Datafile, RoundtripItemDataAndSize)
@@ -73,3 +74,43 @@ TEST(Datafile, RoundtripItemDataAndSize)
 
 	EXPECT_TRUE(pStorage->RemoveFile(aFilename, IStorage::TYPE_SAVE));
 }
+
+TEST(Datafile, UuidItemTypes)
+{
+	CTestInfo Info;
+	char aFilename[64];
+	Info.Filename(aFilename, sizeof(aFilename), ".datafile");
+	IStorage *pStorage = CreateTestStorage();
+	CDataFileWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage, aFilename));
+
+	// any registered uuid works as an item type
+	int aItem[2] = {1, 2};
+	Writer.AddItem(NETMSG_CARBONINFO, 3, sizeof(aItem), aItem);
+	Writer.AddItem(12, 0, sizeof(aItem), aItem);
+	Writer.AddItem(NETMSG_CARBONINFO, 4, sizeof(aItem), aItem);
+	EXPECT_TRUE(Writer.Finish());
+
+	CDataFileReader Reader;
+	ASSERT_TRUE(Reader.Open(pStorage, aFilename, IStorage::TYPE_ALL));
+
+	int Start, Num;
+	Reader.GetType(NETMSG_CARBONINFO, &Start, &Num);
+	ASSERT_EQ(Num, 2);
+	for(int i = 0; i < Num; i++)
+	{
+		int Type, ID;
+		void *pItem = Reader.GetItem(Start + i, &Type, &ID);
+		EXPECT_EQ(Type, NETMSG_CARBONINFO);
+		EXPECT_EQ(ID, 3 + i);
+		EXPECT_TRUE(mem_comp(pItem, aItem, sizeof(aItem)) == 0);
+	}
+	EXPECT_TRUE(Reader.FindItem(NETMSG_CARBONINFO, 4));
+	EXPECT_FALSE(Reader.FindItem(NETMSG_DDNETCLIENTVER, 3));
+	Reader.GetType(12, &Start, &Num);
+	EXPECT_EQ(Num, 1);
+
+	EXPECT_TRUE(Reader.Close());
+
+	EXPECT_TRUE(pStorage->RemoveFile(aFilename, IStorage::TYPE_SAVE));
+}
@@ -0,0 +1,188 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+#include <game/collision.h>
+#include <game/gamecore.h>
+
+#include <vector>
+
+static const int MAP_SIZE = 64;
+
+class CTestWorld
+{
+public:
+	CWorldCore m_World;
+	CCharacterCore m_aCores[MAX_CLIENTS];
+	CCharacterCoreBatch m_Batch;
+
+	void Init(CCollision *pCollision, const std::vector<int> &vClientIDs, unsigned Seed, float Spread)
+	{
+		CTestRandom Random(Seed);
+		for(int ClientID : vClientIDs)
+		{
+			CCharacterCore &Core = m_aCores[ClientID];
+			Core.Init(&m_World, pCollision);
+			Core.Reset();
+			mem_zero(&Core.m_Input, sizeof(Core.m_Input));
+			Core.m_Pos = vec2(MAP_SIZE * 16.0f, MAP_SIZE * 16.0f) + vec2(Random.Next() - 0.5f, Random.Next() - 0.5f) * Spread;
+			Core.m_Vel = vec2(Random.Next() - 0.5f, Random.Next() - 0.5f) * 20.0f;
+			m_World.m_apCharacters[ClientID] = &Core;
+		}
+		m_Batch.Init(&m_World);
+	}
+
+	void SetInputs(unsigned Seed, int Tick)
+	{
+		CTestRandom Random(Seed * 7919u + Tick);
+		for(int i = 0; i < MAX_CLIENTS; i++)
+		{
+			if(!m_World.m_apCharacters[i])
+				continue;
+			CNetObj_PlayerInput &Input = m_aCores[i].m_Input;
+			if(Random.Next() < 0.1f)
+				Input.m_Direction = Random.Int(3) - 1;
+			Input.m_Jump = Random.Next() < 0.08f;
+			if(Random.Next() < 0.05f)
+				Input.m_Hook = !Input.m_Hook;
+			if(Random.Next() < 0.1f)
+			{
+				Input.m_TargetX = Random.Int(600) - 300;
+				Input.m_TargetY = Random.Int(600) - 300;
+			}
+		}
+	}
+
+	void StepScalar()
+	{
+		for(int i = 0; i < MAX_CLIENTS; i++)
+			if(m_World.m_apCharacters[i])
+				m_World.m_apCharacters[i]->Tick(true);
+		for(int i = 0; i < MAX_CLIENTS; i++)
+		{
+			if(!m_World.m_apCharacters[i])
+				continue;
+			m_World.m_apCharacters[i]->AddDragVelocity();
+			m_World.m_apCharacters[i]->ResetDragVelocity();
+			m_World.m_apCharacters[i]->Move();
+			m_World.m_apCharacters[i]->Quantize();
+		}
+	}
+
+	void StepBatch()
+	{
+		m_Batch.Tick(true);
+		m_Batch.Move();
+	}
+};
+
+static bool SameBits(const void *pA, const void *pB, int Size) { return mem_comp(pA, pB, Size) == 0; }
+
+static void ExpectSameCore(const CCharacterCore &A, const CCharacterCore &B, int ClientID, int Tick)
+{
+	SCOPED_TRACE(testing::Message() << "client " << ClientID << " tick " << Tick);
+	ASSERT_TRUE(SameBits(&A.m_Pos, &B.m_Pos, sizeof(A.m_Pos)));
+	ASSERT_TRUE(SameBits(&A.m_Vel, &B.m_Vel, sizeof(A.m_Vel)));
+	ASSERT_TRUE(SameBits(&A.m_HookDragVel, &B.m_HookDragVel, sizeof(A.m_HookDragVel)));
+	ASSERT_TRUE(SameBits(&A.m_HookPos, &B.m_HookPos, sizeof(A.m_HookPos)));
+	ASSERT_TRUE(SameBits(&A.m_HookDir, &B.m_HookDir, sizeof(A.m_HookDir)));
+	ASSERT_EQ(A.m_HookTick, B.m_HookTick);
+	ASSERT_EQ(A.m_HookState, B.m_HookState);
+	ASSERT_EQ(A.m_HookedPlayer, B.m_HookedPlayer);
+	ASSERT_EQ(A.m_Jumped, B.m_Jumped);
+	ASSERT_EQ(A.m_Direction, B.m_Direction);
+	ASSERT_EQ(A.m_Angle, B.m_Angle);
+	ASSERT_EQ(A.m_Death, B.m_Death);
+	ASSERT_EQ(A.m_TriggeredEvents, B.m_TriggeredEvents);
+}
+
+static void RunDifferential(const std::vector<int> &vClientIDs, unsigned Seed, float Spread, int NumTicks)
+{
+	CCollision Collision;
+	// keep the arena in the middle free
+	CreateTestMap(&Collision, MAP_SIZE, MAP_SIZE, 0.06f, Seed, 8);
+
+	CTestWorld *pScalar = new CTestWorld();
+	CTestWorld *pBatch = new CTestWorld();
+	pScalar->Init(&Collision, vClientIDs, Seed, Spread);
+	pBatch->Init(&Collision, vClientIDs, Seed, Spread);
+
+	for(int Tick = 0; Tick < NumTicks; Tick++)
+	{
+		pScalar->SetInputs(Seed, Tick);
+		pBatch->SetInputs(Seed, Tick);
+		pScalar->StepScalar();
+		pBatch->StepBatch();
+		for(int ClientID : vClientIDs)
+		{
+			ExpectSameCore(pScalar->m_aCores[ClientID], pBatch->m_aCores[ClientID], ClientID, Tick);
+			if(testing::Test::HasFatalFailure())
+				break;
+		}
+		if(testing::Test::HasFatalFailure())
+			break;
+	}
+
+	delete pScalar;
+	delete pBatch;
+}
+
+TEST(CharacterCoreBatch, MatchesScalarCrowded)
+{
+	std::vector<int> vClientIDs;
+	for(int i = 0; i < 48; i++)
+		vClientIDs.push_back(i);
+	// everybody in a small arena, lots of collisions and hooks
+	RunDifferential(vClientIDs, 1, 300.0f, 2000);
+}
+
+TEST(CharacterCoreBatch, MatchesScalarSparse)
+{
+	// client ids with gaps, spread over the whole map with its walls
+	std::vector<int> vClientIDs = {0, 3, 4, 17, 31, 63, 64, 90, MAX_CLIENTS - 1};
+	RunDifferential(vClientIDs, 2, MAP_SIZE * 30.0f, 2000);
+}
+
+TEST(CharacterCoreBatch, MatchesScalarTuning)
+{
+	CCollision Collision;
+	CreateTestMap(&Collision, MAP_SIZE, MAP_SIZE, 0.06f, 3, 8);
+
+	std::vector<int> vClientIDs;
+	for(int i = 0; i < 32; i++)
+		vClientIDs.push_back(i * 2);
+
+	// without player collision and hooking the flat passes must not do anything either
+	for(int Variant = 0; Variant < 2; Variant++)
+	{
+		CTestWorld *pScalar = new CTestWorld();
+		CTestWorld *pBatch = new CTestWorld();
+		pScalar->m_World.m_Tuning.m_PlayerCollision = Variant;
+		pScalar->m_World.m_Tuning.m_PlayerHooking = 1 - Variant;
+		pBatch->m_World.m_Tuning = pScalar->m_World.m_Tuning;
+		pScalar->Init(&Collision, vClientIDs, 3, 200.0f);
+		pBatch->Init(&Collision, vClientIDs, 3, 200.0f);
+		for(int Tick = 0; Tick < 500 && !HasFatalFailure(); Tick++)
+		{
+			pScalar->SetInputs(3, Tick);
+			pBatch->SetInputs(3, Tick);
+			pScalar->StepScalar();
+			pBatch->StepBatch();
+			for(int ClientID : vClientIDs)
+				ExpectSameCore(pScalar->m_aCores[ClientID], pBatch->m_aCores[ClientID], ClientID, Tick);
+		}
+		delete pScalar;
+		delete pBatch;
+	}
+}
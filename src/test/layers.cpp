@@ -0,0 +1,170 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+#include <engine/map.h>
+#include <engine/shared/datafile.h>
+#include <engine/storage.h>
+
+#include <game/layers.h>
+#include <game/mapitems.h>
+#include <game/mapitems_ex.h>
+
+#include <vector>
+
+static const int MAP_WIDTH = 40;
+static const int MAP_HEIGHT = 30;
+
+// a map with only the game layer, the entity index is made from pIndexTiles as a layer IndexWidth wide
+// whose tiles are IndexData data items after the game layer's
+static void WriteMap(IStorage *pStorage, const char *pFilename, const std::vector<CTile> &vTiles, const std::vector<CTile> *pIndexTiles, int IndexWidth, int IndexData = 0)
+{
+	CDataFileWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage, pFilename));
+
+	CMapItemVersion Version;
+	Version.m_Version = CMapItemVersion::CURRENT_VERSION;
+	Writer.AddItem(MAPITEMTYPE_VERSION, 0, sizeof(Version), &Version);
+
+	CMapItemGroup Group;
+	mem_zero(&Group, sizeof(Group));
+	Group.m_Version = CMapItemGroup::CURRENT_VERSION;
+	Group.m_ParallaxX = 100;
+	Group.m_ParallaxY = 100;
+	Group.m_NumLayers = 1;
+	Writer.AddItem(MAPITEMTYPE_GROUP, 0, sizeof(Group), &Group);
+
+	// version 3 stores the tiles uncompressed
+	CMapItemLayerTilemap Layer;
+	mem_zero(&Layer, sizeof(Layer));
+	Layer.m_Layer.m_Type = LAYERTYPE_TILES;
+	Layer.m_Version = 3;
+	Layer.m_Width = MAP_WIDTH;
+	Layer.m_Height = MAP_HEIGHT;
+	Layer.m_Flags = TILESLAYERFLAG_GAME;
+	Layer.m_Image = -1;
+	Layer.m_Data = Writer.AddData(vTiles.size() * sizeof(CTile), vTiles.data());
+	Writer.AddItem(MAPITEMTYPE_LAYER, 0, sizeof(Layer), &Layer);
+
+	if(pIndexTiles)
+		CLayers::AddEntityIndex(&Writer, pIndexTiles->data(), IndexWidth, pIndexTiles->size() / IndexWidth, Layer.m_Data + IndexData);
+
+	EXPECT_TRUE(Writer.Finish());
+}
+
+static std::vector<CTile> CreateTiles()
+{
+	std::vector<CTile> vTiles(MAP_WIDTH * MAP_HEIGHT);
+	CTestRandom Random(1);
+	for(CTile &Tile : vTiles)
+	{
+		mem_zero(&Tile, sizeof(Tile));
+		const int Roll = Random.Int(100);
+		if(Roll < 20)
+			Tile.m_Index = TILE_SOLID + Roll % 3;
+		else if(Roll < 25)
+			Tile.m_Index = ENTITY_OFFSET + ENTITY_SPAWN + Roll % NUM_ENTITIES;
+		else if(Roll < 27)
+			Tile.m_Index = TILE_NOHOOK + 1 + Roll % 8; // extra tiles
+	}
+	return vTiles;
+}
+
+TEST(Layers, EntityIndexMatchesScan)
+{
+	CTestInfo Info;
+	char aFilename[64];
+	Info.Filename(aFilename, sizeof(aFilename), ".map");
+	IStorage *pStorage = CreateTestStorage();
+
+	std::vector<CTile> vTiles = CreateTiles();
+	WriteMap(pStorage, aFilename, vTiles, &vTiles, MAP_WIDTH);
+
+	IEngineMap *pMap = CreateEngineMap();
+	ASSERT_TRUE(pMap->Load(aFilename, pStorage));
+	CLayers Layers;
+	Layers.Init(0, pMap);
+	ASSERT_TRUE(Layers.GameLayer());
+
+	const CMapItemEntity *pEntities;
+	int NumEntities;
+	ASSERT_TRUE(Layers.GameEntities(&pEntities, &NumEntities));
+
+	int Found = 0;
+	for(int y = 0; y < MAP_HEIGHT; y++)
+	{
+		for(int x = 0; x < MAP_WIDTH; x++)
+		{
+			const int Index = vTiles[y * MAP_WIDTH + x].m_Index;
+			if(Index <= TILE_NOHOOK)
+				continue;
+			ASSERT_LT(Found, NumEntities);
+			EXPECT_EQ(pEntities[Found].m_X, x);
+			EXPECT_EQ(pEntities[Found].m_Y, y);
+			EXPECT_EQ(pEntities[Found].m_Index, Index);
+			Found++;
+		}
+	}
+	EXPECT_GT(Found, 0);
+	EXPECT_EQ(Found, NumEntities);
+
+	pMap->Unload();
+	delete pMap;
+	EXPECT_TRUE(pStorage->RemoveFile(aFilename, IStorage::TYPE_SAVE));
+}
+
+TEST(Layers, EntityIndexFallback)
+{
+	CTestInfo Info;
+	char aFilename[64];
+	Info.Filename(aFilename, sizeof(aFilename), ".map");
+	IStorage *pStorage = CreateTestStorage();
+	std::vector<CTile> vTiles = CreateTiles();
+
+	// the same size, but one entity moved to the next tile after the index was made
+	std::vector<CTile> vEdited = vTiles;
+	int Moved = 0;
+	while(vEdited[Moved].m_Index <= TILE_NOHOOK || vEdited[Moved + 1].m_Index > TILE_NOHOOK)
+		Moved++;
+	vEdited[Moved + 1].m_Index = vEdited[Moved].m_Index;
+	vEdited[Moved].m_Index = TILE_AIR;
+
+	// without the item, with one made for a differently sized game layer, for other tile data and for other tiles
+	struct SCase
+	{
+		const std::vector<CTile> *m_pLayerTiles;
+		const std::vector<CTile> *m_pIndexTiles;
+		int m_IndexWidth;
+		int m_IndexData;
+	};
+	const SCase aCases[] = {{&vTiles, nullptr, MAP_WIDTH, 0}, {&vTiles, &vTiles, MAP_WIDTH / 2, 0}, {&vTiles, &vTiles, MAP_WIDTH, 1}, {&vEdited, &vTiles, MAP_WIDTH, 0}};
+	for(const SCase &Case : aCases)
+	{
+		WriteMap(pStorage, aFilename, *Case.m_pLayerTiles, Case.m_pIndexTiles, Case.m_IndexWidth, Case.m_IndexData);
+
+		IEngineMap *pMap = CreateEngineMap();
+		ASSERT_TRUE(pMap->Load(aFilename, pStorage));
+		CLayers Layers;
+		Layers.Init(0, pMap);
+
+		const CMapItemEntity *pEntities;
+		int NumEntities;
+		EXPECT_FALSE(Layers.GameEntities(&pEntities, &NumEntities));
+		EXPECT_EQ(NumEntities, 0);
+
+		pMap->Unload();
+		delete pMap;
+		EXPECT_TRUE(pStorage->RemoveFile(aFilename, IStorage::TYPE_SAVE));
+	}
+}
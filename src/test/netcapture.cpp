@@ -0,0 +1,180 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <engine/shared/netcapture.h>
+#include <engine/storage.h>
+
+static NETADDR TestAddr(int Port)
+{
+	NETADDR Addr;
+	mem_zero(&Addr, sizeof(Addr));
+	Addr.type = NETTYPE_IPV4;
+	Addr.ip[0] = 127;
+	Addr.ip[3] = 1;
+	Addr.port = Port;
+	return Addr;
+}
+
+TEST(NetCapture, Roundtrip)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+
+	static const unsigned char RECV_DATA[] = {0x10, 0x00, 0x01, 0xde, 0xad, 0xbe, 0xef, 0x42};
+	static const unsigned char SENT_DATA[] = {0x04, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff};
+	NETADDR Addr = TestAddr(8303);
+
+	CNetCaptureWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE)));
+	Writer.Write(NETCAPTURE_DIR_RECV, &Addr, RECV_DATA, sizeof(RECV_DATA));
+	Writer.Write(NETCAPTURE_DIR_SENT, &Addr, SENT_DATA, sizeof(SENT_DATA));
+	EXPECT_EQ(Writer.NumRecords(), 2);
+	Writer.Close();
+
+	CNetCaptureReader Reader;
+	ASSERT_TRUE(Reader.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE)));
+
+	CNetCaptureRecord Record;
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Direction, NETCAPTURE_DIR_RECV);
+	EXPECT_EQ(net_addr_comp(&Record.m_Addr, &Addr, 1), 0);
+	ASSERT_EQ(Record.m_DataSize, (int) sizeof(RECV_DATA));
+	EXPECT_EQ(mem_comp(Record.m_aData, RECV_DATA, sizeof(RECV_DATA)), 0);
+	int64_t FirstTime = Record.m_Time;
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Direction, NETCAPTURE_DIR_SENT);
+	ASSERT_EQ(Record.m_DataSize, (int) sizeof(SENT_DATA));
+	EXPECT_EQ(mem_comp(Record.m_aData, SENT_DATA, sizeof(SENT_DATA)), 0);
+	EXPECT_GE(Record.m_Time, FirstTime);
+
+	EXPECT_FALSE(Reader.Read(&Record));
+	Reader.Close();
+
+	EXPECT_TRUE(pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE));
+}
+
+TEST(NetCapture, ReplayMaxSpeed)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+
+	CNetCaptureWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE)));
+	for(int i = 0; i < 8; i++)
+	{
+		CNetCaptureRecord Record;
+		Record.m_Time = i * 1000000; // one datagram per second
+		Record.m_Direction = i % 2 ? NETCAPTURE_DIR_SENT : NETCAPTURE_DIR_RECV;
+		Record.m_Addr = TestAddr(8303 + i);
+		Record.m_DataSize = i + 1;
+		mem_zero(Record.m_aData, sizeof(Record.m_aData));
+		Record.m_aData[0] = i;
+		Writer.WriteRecord(&Record);
+	}
+	Writer.Close();
+
+	CNetReplay Replay;
+	ASSERT_TRUE(Replay.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE), true));
+
+	// only received datagrams are fed back, without waiting for their timestamps
+	unsigned char aBuffer[NET_MAX_PACKETSIZE];
+	NETADDR Addr;
+	for(int i = 0; i < 8; i += 2)
+	{
+		EXPECT_FALSE(Replay.Done());
+		EXPECT_EQ(Replay.NextDue(), 0);
+		ASSERT_EQ(Replay.Recv(&Addr, aBuffer, sizeof(aBuffer)), i + 1);
+		EXPECT_EQ(aBuffer[0], i);
+		EXPECT_EQ(Addr.port, 8303 + i);
+	}
+	EXPECT_TRUE(Replay.Done());
+	EXPECT_EQ(Replay.NextDue(), -1);
+	EXPECT_EQ(Replay.Recv(&Addr, aBuffer, sizeof(aBuffer)), 0);
+
+	Replay.Send(&Addr, aBuffer, 3);
+	EXPECT_EQ(Replay.Stats()->m_RecvPackets, 4);
+	EXPECT_EQ(Replay.Stats()->m_SentPackets, 1);
+	EXPECT_EQ(Replay.Stats()->m_SentBytes, 3);
+	Replay.Close();
+
+	EXPECT_TRUE(pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE));
+}
+
+TEST(NetCapture, ReplayMaxSpeedPerPump)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+
+	static const int NUM_RECORDS = NETREPLAY_MAX_PER_PUMP + 10;
+	CNetCaptureWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE)));
+	CNetCaptureRecord Record;
+	Record.m_Time = 0;
+	Record.m_Direction = NETCAPTURE_DIR_RECV;
+	Record.m_Addr = TestAddr(8303);
+	Record.m_DataSize = 1;
+	Record.m_aData[0] = 0;
+	for(int i = 0; i < NUM_RECORDS; i++)
+		Writer.WriteRecord(&Record);
+	Writer.Close();
+
+	CNetReplay Replay;
+	ASSERT_TRUE(Replay.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE), true));
+
+	// a pump stops at the budget, the next one gets the rest
+	unsigned char aBuffer[NET_MAX_PACKETSIZE];
+	NETADDR Addr;
+	int aReceived[2] = {0, 0};
+	for(int &Received : aReceived)
+	{
+		Replay.BeginPump();
+		while(Replay.Recv(&Addr, aBuffer, sizeof(aBuffer)))
+			Received++;
+	}
+	EXPECT_EQ(aReceived[0], (int) NETREPLAY_MAX_PER_PUMP);
+	EXPECT_EQ(aReceived[1], NUM_RECORDS - NETREPLAY_MAX_PER_PUMP);
+	EXPECT_TRUE(Replay.Done());
+	Replay.Close();
+
+	EXPECT_TRUE(pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE));
+}
+
+TEST(NetCapture, ReplayRecordedSpeed)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+
+	CNetCaptureWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE)));
+	CNetCaptureRecord Record;
+	Record.m_Time = 60 * 1000000; // far in the future
+	Record.m_Direction = NETCAPTURE_DIR_RECV;
+	Record.m_Addr = TestAddr(8303);
+	Record.m_DataSize = 1;
+	Record.m_aData[0] = 0;
+	Writer.WriteRecord(&Record);
+	Writer.Close();
+
+	CNetReplay Replay;
+	ASSERT_TRUE(Replay.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE), false));
+
+	unsigned char aBuffer[NET_MAX_PACKETSIZE];
+	NETADDR Addr;
+	EXPECT_EQ(Replay.Recv(&Addr, aBuffer, sizeof(aBuffer)), 0);
+	EXPECT_GT(Replay.NextDue(), 0);
+	EXPECT_FALSE(Replay.Done());
+	Replay.Close();
+
+	EXPECT_TRUE(pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE));
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+#include <engine/shared/network.h>
+
+TEST(NetResendPool, Empty)
+{
+	CNetResendPool Pool;
+	EXPECT_EQ(Pool.Stats()->m_NumSlabs, 0);
+	EXPECT_EQ(Pool.Stats()->m_NumBlocks, 0);
+	EXPECT_EQ(Pool.Stats()->m_BytesInUse, 0);
+}
+
+TEST(NetResendPool, SizeClasses)
+{
+	EXPECT_EQ(CNetResendPool::AllocSize(1), 64);
+	EXPECT_EQ(CNetResendPool::AllocSize(200), 256);
+	EXPECT_EQ(CNetResendPool::AllocSize(sizeof(CNetChunkResend) + NET_MAX_PAYLOAD), 2048);
+	EXPECT_EQ(CNetResendPool::AllocSize(1024 * 1024), -1);
+
+	CNetResendPool Pool;
+	EXPECT_EQ(Pool.Allocate(1024 * 1024), nullptr);
+}
+
+TEST(NetResendPool, GrowAndRelease)
+{
+	CNetResendPool Pool;
+	void *apBlocks[256];
+	for(int i = 0; i < 256; i++)
+	{
+		apBlocks[i] = Pool.Allocate(sizeof(CNetChunkResend) + 1000);
+		ASSERT_NE(apBlocks[i], nullptr);
+		mem_zero(apBlocks[i], sizeof(CNetChunkResend) + 1000);
+	}
+	EXPECT_EQ(Pool.Stats()->m_NumBlocks, 256);
+	EXPECT_EQ(Pool.Stats()->m_BytesInUse, 256 * 2048);
+	EXPECT_GT(Pool.Stats()->m_NumSlabs, 1);
+	const int Peak = Pool.Stats()->m_NumSlabs;
+
+	for(int i = 0; i < 256; i++)
+		Pool.Free(apBlocks[i]);
+	EXPECT_EQ(Pool.Stats()->m_NumBlocks, 0);
+	EXPECT_EQ(Pool.Stats()->m_BytesInUse, 0);
+	EXPECT_EQ(Pool.Stats()->m_NumSlabs, (int) CNetResendPool::NUM_SPARE_SLABS);
+	EXPECT_EQ(Pool.Stats()->m_NumSlabsPeak, Peak);
+}
+
+TEST(NetResendPool, ReuseFreedBlocks)
+{
+	CNetResendPool Pool;
+	void *pFirst = Pool.Allocate(100);
+	void *pSecond = Pool.Allocate(100);
+	ASSERT_NE(pFirst, nullptr);
+	ASSERT_NE(pSecond, nullptr);
+	EXPECT_NE(pFirst, pSecond);
+
+	Pool.Free(pFirst);
+	EXPECT_EQ(Pool.Allocate(100), pFirst);
+	EXPECT_EQ(Pool.Stats()->m_NumSlabs, 1);
+
+	// different size classes never share a slab
+	void *pLarge = Pool.Allocate(1000);
+	ASSERT_NE(pLarge, nullptr);
+	EXPECT_EQ(Pool.Stats()->m_NumSlabs, 2);
+}
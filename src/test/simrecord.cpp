@@ -0,0 +1,156 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <engine/shared/simrecord.h>
+#include <engine/storage.h>
+
+#include <iterator>
+
+TEST(SimRecord, Roundtrip)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+
+	static const int SNAP_CLIENTS[] = {-1, 0, 3, 17};
+	static const unsigned char MESSAGE[] = {0x22, 0x05, 0x00, 0x7f, 0x80};
+	int aInput[MAX_INPUT_SIZE] = {0};
+	aInput[0] = -1;
+	aInput[1] = 250;
+	aInput[2] = -300;
+	aInput[5] = 7;
+
+	CSimRecorder Writer;
+	ASSERT_TRUE(Writer.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE), 0x9e3779b9u, "dm1"));
+	Writer.RecordLoadWorld("dm1", 0xc0ffee42u);
+	Writer.RecordConnect(3, true, 0x0705, 2, 19000);
+	Writer.RecordSwitchWorld(3, "dm1");
+	Writer.RecordMessage(3, MESSAGE, sizeof(MESSAGE));
+	Writer.RecordEnter(3);
+	Writer.RecordTick(1);
+	Writer.RecordInput(SIMREC_PREDICTED_INPUT, 3, aInput, MAX_INPUT_SIZE);
+	Writer.RecordTickEnd(0xdeadbeefu);
+	Writer.RecordSnap(SNAP_CLIENTS, std::size(SNAP_CLIENTS));
+	Writer.RecordDrop(3, "timeout");
+	EXPECT_EQ(Writer.NumTicks(), 1);
+	Writer.Close();
+
+	CSimRecordReader Reader;
+	ASSERT_TRUE(Reader.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE)));
+
+	CSimRecord Record;
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_INIT);
+	ASSERT_EQ(Record.m_NumInts, 1);
+	EXPECT_EQ((unsigned) Record.m_aInts[0], 0x9e3779b9u);
+	EXPECT_STREQ(Record.m_aString, "dm1");
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_LOAD_WORLD);
+	ASSERT_EQ(Record.m_NumInts, 1);
+	EXPECT_EQ((unsigned) Record.m_aInts[0], 0xc0ffee42u);
+	EXPECT_STREQ(Record.m_aString, "dm1");
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_CONNECT);
+	EXPECT_EQ(Record.m_ClientID, 3);
+	ASSERT_EQ(Record.m_NumInts, 4);
+	EXPECT_EQ(Record.m_aInts[0], 1);
+	EXPECT_EQ(Record.m_aInts[1], 0x0705);
+	EXPECT_EQ(Record.m_aInts[2], 2);
+	EXPECT_EQ(Record.m_aInts[3], 19000);
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_SWITCH_WORLD);
+	EXPECT_EQ(Record.m_ClientID, 3);
+	EXPECT_STREQ(Record.m_aString, "dm1");
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_MESSAGE);
+	ASSERT_EQ(Record.m_DataSize, (int) sizeof(MESSAGE));
+	EXPECT_EQ(mem_comp(Record.m_aData, MESSAGE, sizeof(MESSAGE)), 0);
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_ENTER);
+	EXPECT_EQ(Record.m_ClientID, 3);
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_TICK);
+	ASSERT_EQ(Record.m_NumInts, 1);
+	EXPECT_EQ(Record.m_aInts[0], 1);
+
+	// trailing zeros are dropped
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_PREDICTED_INPUT);
+	ASSERT_EQ(Record.m_NumInts, 6);
+	EXPECT_EQ(mem_comp(Record.m_aInts, aInput, 6 * sizeof(int)), 0);
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_TICK_END);
+	EXPECT_EQ((unsigned) Record.m_aInts[0], 0xdeadbeefu);
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_SNAP);
+	ASSERT_EQ(Record.m_NumInts, (int) std::size(SNAP_CLIENTS));
+	EXPECT_EQ(mem_comp(Record.m_aInts, SNAP_CLIENTS, sizeof(SNAP_CLIENTS)), 0);
+
+	ASSERT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_DROP);
+	EXPECT_STREQ(Record.m_aString, "timeout");
+
+	EXPECT_FALSE(Reader.Read(&Record));
+	Reader.Close();
+
+	EXPECT_TRUE(pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE));
+}
+
+TEST(SimRecord, Truncated)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+
+	CSimRecorder Writer;
+	ASSERT_TRUE(Writer.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE), 1, "dm1"));
+	Writer.RecordDrop(0, "a reason long enough to be cut off");
+	Writer.Close();
+
+	// cut the last record in half
+	IOHANDLE File = pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	const int Size = (int) io_length(File);
+	char aBuf[256];
+	ASSERT_LT(Size, (int) sizeof(aBuf));
+	ASSERT_EQ(io_read(File, aBuf, Size), (unsigned) Size);
+	io_close(File);
+	File = pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	io_write(File, aBuf, Size - 10);
+	io_close(File);
+
+	CSimRecordReader Reader;
+	ASSERT_TRUE(Reader.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE)));
+	CSimRecord Record;
+	EXPECT_TRUE(Reader.Read(&Record));
+	EXPECT_EQ(Record.m_Type, SIMREC_INIT);
+	EXPECT_FALSE(Reader.Read(&Record));
+	Reader.Close();
+
+	// not a simulation record at all
+	CSimRecordReader Other;
+	File = pStorage->OpenFile(Info.m_aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	io_write(File, "TWNETCAP\0\0\0\1", 12);
+	io_close(File);
+	EXPECT_FALSE(Other.Open(pStorage->OpenFile(Info.m_aFilename, IOFLAG_READ, IStorage::TYPE_SAVE)));
+
+	EXPECT_TRUE(pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE));
+}
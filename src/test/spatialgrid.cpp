@@ -0,0 +1,178 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+#include <game/spatialgrid.h>
+
+#include <algorithm>
+#include <vector>
+
+static const float WORLD_SIZE = 200 * 32.0f;
+static const int NUM_LAYERS = 3;
+
+struct CTestItem : public CSpatialGridItem
+{
+	vec2 m_Pos;
+	float m_Radius;
+	int m_Layer;
+};
+
+// includes a margin outside of the grid
+static vec2 RandomPos(CTestRandom *pRandom)
+{
+	return vec2(pRandom->Next() * (WORLD_SIZE + 512.0f) - 256.0f, pRandom->Next() * (WORLD_SIZE + 512.0f) - 256.0f);
+}
+
+static void CreateItems(CSpatialGrid *pGrid, std::vector<CTestItem> *pvItems, int Num)
+{
+	CTestRandom Random(1337);
+	pvItems->resize(Num);
+	pGrid->Init(WORLD_SIZE, WORLD_SIZE, NUM_LAYERS);
+	for(int i = 0; i < Num; i++)
+	{
+		CTestItem &Item = (*pvItems)[i];
+		Item.m_Pos = RandomPos(&Random);
+		Item.m_Radius = i % 10 == 0 ? 28.0f : 14.0f;
+		Item.m_Layer = i % NUM_LAYERS;
+		pGrid->Insert(&Item, Item.m_Layer, Item.m_Pos, Item.m_Radius);
+	}
+}
+
+static std::vector<const CTestItem *> GridRadius(const CSpatialGrid &Grid, vec2 Pos, float Radius, int Layer)
+{
+	std::vector<const CTestItem *> vpFound;
+	const vec2 Reach = vec2(1.0f, 1.0f) * (Radius + Grid.MaxRadius());
+	Grid.ForEachCell(Pos - Reach, Pos + Reach, [&](int Cell) {
+		for(CSpatialGridItem *pItem = Grid.First(Cell, Layer); pItem; pItem = pItem->NextInCell())
+		{
+			const CTestItem *pTest = static_cast<const CTestItem *>(pItem);
+			if(distance(pTest->m_Pos, Pos) < Radius + pTest->m_Radius)
+				vpFound.push_back(pTest);
+		}
+		return true;
+	});
+	std::sort(vpFound.begin(), vpFound.end());
+	return vpFound;
+}
+
+static std::vector<const CTestItem *> BruteRadius(const std::vector<CTestItem> &vItems, vec2 Pos, float Radius, int Layer)
+{
+	std::vector<const CTestItem *> vpFound;
+	for(const CTestItem &Item : vItems)
+		if(Item.m_Layer == Layer && distance(Item.m_Pos, Pos) < Radius + Item.m_Radius)
+			vpFound.push_back(&Item);
+	std::sort(vpFound.begin(), vpFound.end());
+	return vpFound;
+}
+
+static bool TestRay(const CTestItem *pItem, vec2 Pos0, vec2 Pos1, float Radius, float *pClosestLen)
+{
+	vec2 IntersectPos = closest_point_on_line(Pos0, Pos1, pItem->m_Pos);
+	if(distance(pItem->m_Pos, IntersectPos) >= pItem->m_Radius + Radius)
+		return false;
+	float Len = distance(Pos0, IntersectPos);
+	if(Len >= *pClosestLen)
+		return false;
+	*pClosestLen = Len;
+	return true;
+}
+
+static const CTestItem *GridRay(CSpatialGrid &Grid, vec2 Pos0, vec2 Pos1, float Radius, int Layer)
+{
+	float ClosestLen = distance(Pos0, Pos1) * 100.0f;
+	const CTestItem *pClosest = nullptr;
+	Grid.ForEachCellOnRay(Pos0, Pos1, Radius + Grid.MaxRadius(), [&](int Cell, float MinDistance) {
+		if(pClosest && MinDistance >= ClosestLen)
+			return false;
+		for(CSpatialGridItem *pItem = Grid.First(Cell, Layer); pItem; pItem = pItem->NextInCell())
+			if(TestRay(static_cast<const CTestItem *>(pItem), Pos0, Pos1, Radius, &ClosestLen))
+				pClosest = static_cast<const CTestItem *>(pItem);
+		return true;
+	});
+	return pClosest;
+}
+
+static const CTestItem *BruteRay(const std::vector<CTestItem> &vItems, vec2 Pos0, vec2 Pos1, float Radius, int Layer)
+{
+	float ClosestLen = distance(Pos0, Pos1) * 100.0f;
+	const CTestItem *pClosest = nullptr;
+	for(const CTestItem &Item : vItems)
+		if(Item.m_Layer == Layer && TestRay(&Item, Pos0, Pos1, Radius, &ClosestLen))
+			pClosest = &Item;
+	return pClosest;
+}
+
+TEST(SpatialGrid, InsertMoveRemove)
+{
+	CSpatialGrid Grid;
+	EXPECT_FALSE(Grid.IsActive());
+	Grid.Init(1000.0f, 600.0f, 1);
+	ASSERT_TRUE(Grid.IsActive());
+	EXPECT_EQ(Grid.NumCells(), 4 * 3);
+
+	CTestItem Item;
+	EXPECT_FALSE(Item.InGrid());
+	Grid.Insert(&Item, 0, vec2(10.0f, 10.0f), 14.0f);
+	EXPECT_EQ(Item.GridCell(), 0);
+	EXPECT_EQ(Grid.MaxRadius(), 14.0f);
+
+	// positions outside of the grid end up in the border cells
+	Grid.Move(&Item, vec2(5000.0f, -100.0f));
+	EXPECT_EQ(Item.GridCell(), 3);
+	EXPECT_EQ(Grid.First(3, 0), &Item);
+	EXPECT_EQ(Grid.First(0, 0), nullptr);
+
+	Grid.Remove(&Item);
+	EXPECT_FALSE(Item.InGrid());
+	EXPECT_EQ(Grid.First(3, 0), nullptr);
+
+	// moving an item that isn't in the grid does nothing
+	Grid.Move(&Item, vec2(10.0f, 10.0f));
+	EXPECT_FALSE(Item.InGrid());
+
+	Grid.Insert(&Item, 0, vec2(10.0f, 10.0f), 14.0f);
+	Grid.Clear();
+	EXPECT_FALSE(Item.InGrid());
+}
+
+TEST(SpatialGrid, QueriesMatchBruteForce)
+{
+	CSpatialGrid Grid;
+	std::vector<CTestItem> vItems;
+	CreateItems(&Grid, &vItems, 2000);
+
+	CTestRandom Random(42);
+	for(int Round = 0; Round < 4; Round++)
+	{
+		for(int i = 0; i < 500; i++)
+		{
+			const vec2 Pos = RandomPos(&Random);
+			const float Radius = 32.0f + Random.Next() * 600.0f;
+			const int Layer = i % NUM_LAYERS;
+			ASSERT_EQ(GridRadius(Grid, Pos, Radius, Layer), BruteRadius(vItems, Pos, Radius, Layer));
+
+			// short projectile steps and long laser beams, some of them leaving the grid
+			const vec2 Pos1 = i % 2 ? Pos + (RandomPos(&Random) - Pos) * 0.02f : RandomPos(&Random);
+			const float RayRadius = i % 3 ? 0.0f : 6.0f;
+			ASSERT_EQ(GridRay(Grid, Pos, Pos1, RayRadius, Layer), BruteRay(vItems, Pos, Pos1, RayRadius, Layer));
+		}
+
+		// shuffle the items around between rounds
+		for(CTestItem &Item : vItems)
+		{
+			Item.m_Pos = Round % 2 ? RandomPos(&Random) : Item.m_Pos + vec2(Random.Next() - 0.5f, Random.Next() - 0.5f) * 200.0f;
+			Grid.Move(&Item, Item.m_Pos);
+		}
+	}
+}
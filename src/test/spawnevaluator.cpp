@@ -0,0 +1,95 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "spawntest.h"
+
+#include <gtest/gtest.h>
+
+static void ExpectSame(CSpawnTest *pTest)
+{
+	for(int Type = 0; Type < CSpawnEvaluator::NUM_SPAWN_TYPES; Type++)
+	{
+		for(unsigned i = 0; i < pTest->m_avSpawnPoints[Type].size(); i++)
+			ASSERT_EQ(pTest->OldFreeOffset(pTest->m_avSpawnPoints[Type][i]), pTest->m_Evaluator.FreeOffset(Type, i)) << "type " << Type << " spawn " << i;
+
+		for(int Team = -1; Team <= 1; Team++)
+		{
+			vec2 OldPos, NewPos;
+			const int Old = pTest->OldChoice(Type, Team, &OldPos);
+			ASSERT_EQ(Old, pTest->NewChoice(Type, Team, &NewPos)) << "type " << Type << " team " << Team;
+			if(Old != -1)
+			{
+				ASSERT_EQ(OldPos, NewPos);
+			}
+		}
+	}
+}
+
+TEST(SpawnEvaluator, MatchesOldEvaluation)
+{
+	for(int Seed = 1; Seed <= 20; Seed++)
+	{
+		CSpawnTest Test(Seed);
+		for(int i = 0; i < 40; i++)
+		{
+			// crowd the spawn points
+			int Type = Test.m_Random.Int(CSpawnEvaluator::NUM_SPAWN_TYPES);
+			vec2 Pos = Test.m_avSpawnPoints[Type][Test.m_Random.Int(Test.m_avSpawnPoints[Type].size())];
+			Test.m_vBlockers.push_back(Test.NewBlocker(Pos + vec2(Test.m_Random.Range(-80.0f, 80.0f), Test.m_Random.Range(-80.0f, 80.0f))));
+		}
+		Test.Sync();
+		ExpectSame(&Test);
+		if(HasFatalFailure())
+			return;
+	}
+}
+
+TEST(SpawnEvaluator, FollowsChanges)
+{
+	CSpawnTest Test(42);
+	Test.Sync();
+	ExpectSame(&Test);
+
+	for(int Step = 0; Step < 300 && !HasFatalFailure(); Step++)
+	{
+		const float Action = Test.m_Random.Next();
+		if(Action < 0.3f)
+		{
+			// spawn at the chosen point, like a bot refill does
+			int Type = Test.m_Random.Int(CSpawnEvaluator::NUM_SPAWN_TYPES);
+			vec2 Pos;
+			if(Test.NewChoice(Type, Test.m_Random.Int(3) - 1, &Pos) != -1)
+				Test.Add(Test.NewBlocker(Pos));
+		}
+		else if(Action < 0.7f && !Test.m_vBlockers.empty())
+		{
+			CSpawnEvaluator::SBlocker &Blocker = Test.m_vBlockers[Test.m_Random.Int(Test.m_vBlockers.size())];
+			Blocker.m_Pos += vec2(Test.m_Random.Range(-40.0f, 40.0f), Test.m_Random.Range(-40.0f, 40.0f));
+			Test.m_Evaluator.UpdateBlocker(Blocker);
+		}
+		else if(Action < 0.85f && !Test.m_vBlockers.empty())
+		{
+			int Index = Test.m_Random.Int(Test.m_vBlockers.size());
+			Test.m_Evaluator.RemoveBlocker(Test.m_vBlockers[Index].m_pKey);
+			Test.m_vBlockers.erase(Test.m_vBlockers.begin() + Index);
+		}
+		else if(Action < 0.9f)
+		{
+			// new spawn points, the whole evaluation for that type starts over
+			int Type = Test.m_Random.Int(CSpawnEvaluator::NUM_SPAWN_TYPES);
+			Test.m_avSpawnPoints[Type].push_back(Test.RandomPos());
+			Test.m_Evaluator.SetSpawnPoints(Type, Test.m_avSpawnPoints[Type]);
+		}
+		else
+		{
+			Test.Sync();
+		}
+		ExpectSame(&Test);
+	}
+}
@@ -0,0 +1,175 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#ifndef TEST_SPAWNTEST_H
+#define TEST_SPAWNTEST_H
+
+#include "test.h"
+
+#include <game/collision.h>
+#include <game/spawnevaluator.h>
+
+#include <vector>
+
+// a spawn evaluator next to the evaluation it replaces, shared by the test and the benchmark
+class CSpawnTest
+{
+public:
+	enum
+	{
+		MAP_SIZE = 64,
+	};
+
+	CCollision m_Collision;
+	std::vector<vec2> m_avSpawnPoints[CSpawnEvaluator::NUM_SPAWN_TYPES];
+	// front is the newest, like the entity lists of the world
+	std::vector<CSpawnEvaluator::SBlocker> m_vBlockers;
+	CSpawnEvaluator m_Evaluator;
+	CTestRandom m_Random;
+	int m_NextKey;
+
+	CSpawnTest(unsigned Seed) :
+		m_Random(Seed), m_NextKey(1)
+	{
+		CreateTestMap(&m_Collision, MAP_SIZE, MAP_SIZE, 0.1f, Seed);
+
+		// clustered spawn points, some next to walls
+		for(auto &vSpawnPoints : m_avSpawnPoints)
+		{
+			vec2 Center = RandomPos();
+			for(int i = 0; i < 12; i++)
+				vSpawnPoints.push_back(vec2((int) (Center.x + m_Random.Range(-160.0f, 160.0f)) / 32 * 32 + 16.0f, (int) (Center.y + m_Random.Range(-160.0f, 160.0f)) / 32 * 32 + 16.0f));
+		}
+
+		m_Evaluator.SetCollision(&m_Collision);
+		for(int Type = 0; Type < CSpawnEvaluator::NUM_SPAWN_TYPES; Type++)
+			m_Evaluator.SetSpawnPoints(Type, m_avSpawnPoints[Type]);
+	}
+
+	// spread over the whole map, like the bot spawns of a crowded world
+	void AddRandomSpawnPoints(int Num)
+	{
+		for(int Type = 0; Type < CSpawnEvaluator::NUM_SPAWN_TYPES; Type++)
+		{
+			for(int i = 0; i < Num; i++)
+				m_avSpawnPoints[Type].push_back(RandomPos());
+			m_Evaluator.SetSpawnPoints(Type, m_avSpawnPoints[Type]);
+		}
+	}
+
+	vec2 RandomPos() { return vec2(m_Random.Range(200.0f, MAP_SIZE * 32.0f - 200.0f), m_Random.Range(200.0f, MAP_SIZE * 32.0f - 200.0f)); }
+
+	CSpawnEvaluator::SBlocker NewBlocker(vec2 Pos)
+	{
+		CSpawnEvaluator::SBlocker Blocker;
+		Blocker.m_pKey = (const void *) (uintptr_t) m_NextKey++;
+		Blocker.m_Pos = Pos;
+		Blocker.m_Dangerous = m_Random.Next() < 0.7f;
+		Blocker.m_Radius = Blocker.m_Dangerous ? 28.0f : 14.0f;
+		Blocker.m_Team = Blocker.m_Dangerous ? m_Random.Int(2) : -1;
+		return Blocker;
+	}
+
+	void Sync()
+	{
+		m_Evaluator.BeginSync();
+		for(const CSpawnEvaluator::SBlocker &Blocker : m_vBlockers)
+			m_Evaluator.AppendBlocker(Blocker);
+		m_Evaluator.EndSync();
+	}
+
+	void Add(const CSpawnEvaluator::SBlocker &Blocker)
+	{
+		m_vBlockers.insert(m_vBlockers.begin(), Blocker);
+		m_Evaluator.UpdateBlocker(Blocker);
+	}
+
+	// the evaluation IGameController::EvaluateSpawnType did on every call
+	int OldFreeOffset(vec2 SpawnPoint) const
+	{
+		std::vector<const CSpawnEvaluator::SBlocker *> vpNear;
+		for(const CSpawnEvaluator::SBlocker &Blocker : m_vBlockers)
+			if(distance(Blocker.m_Pos, SpawnPoint) < CSpawnEvaluator::CHECK_RADIUS + Blocker.m_Radius)
+				vpNear.push_back(&Blocker);
+
+		int Result = -1;
+		for(int Index = 0; Index < CSpawnEvaluator::NUM_OFFSETS && Result == -1; ++Index)
+		{
+			Result = Index;
+			for(const CSpawnEvaluator::SBlocker *pBlocker : vpNear)
+				if(m_Collision.CheckPoint(SpawnPoint + CSpawnEvaluator::ms_aOffsets[Index]) ||
+					distance(pBlocker->m_Pos, SpawnPoint + CSpawnEvaluator::ms_aOffsets[Index]) <= pBlocker->m_Radius)
+				{
+					Result = -1;
+					break;
+				}
+		}
+		return Result;
+	}
+
+	float OldDanger(vec2 Pos, int FriendlyTeam) const
+	{
+		float Score = 0.0f;
+		for(const CSpawnEvaluator::SBlocker &Blocker : m_vBlockers)
+		{
+			if(!Blocker.m_Dangerous)
+				continue;
+			float Scoremod = 1.0f;
+			if(FriendlyTeam != -1 && Blocker.m_Team == FriendlyTeam)
+				Scoremod = 0.5f;
+			float d = distance(Pos, Blocker.m_Pos);
+			Score += Scoremod * (d == 0 ? 1000000000.0f : 1.0f / d);
+		}
+		return Score;
+	}
+
+	// least dangerous spawn point of a type, -1 if all are blocked
+	int OldChoice(int Type, int FriendlyTeam, vec2 *pPos) const
+	{
+		int Best = -1;
+		float BestScore = 0.0f;
+		for(unsigned i = 0; i < m_avSpawnPoints[Type].size(); i++)
+		{
+			const int Offset = OldFreeOffset(m_avSpawnPoints[Type][i]);
+			if(Offset == -1)
+				continue;
+			vec2 P = m_avSpawnPoints[Type][i] + CSpawnEvaluator::ms_aOffsets[Offset];
+			float Score = OldDanger(P, FriendlyTeam);
+			if(Best == -1 || BestScore > Score)
+			{
+				Best = i;
+				BestScore = Score;
+				*pPos = P;
+			}
+		}
+		return Best;
+	}
+
+	int NewChoice(int Type, int FriendlyTeam, vec2 *pPos)
+	{
+		int Best = -1;
+		float BestScore = 0.0f;
+		for(int i = 0; i < m_Evaluator.NumSpawnPoints(Type); i++)
+		{
+			const int Offset = m_Evaluator.FreeOffset(Type, i);
+			if(Offset == -1)
+				continue;
+			float Score = m_Evaluator.Danger(Type, i, FriendlyTeam);
+			if(Best == -1 || BestScore > Score)
+			{
+				Best = i;
+				BestScore = Score;
+				*pPos = m_Evaluator.SpawnPoint(Type, i) + CSpawnEvaluator::ms_aOffsets[Offset];
+			}
+		}
+		return Best;
+	}
+};
+
+#endif // TEST_SPAWNTEST_H
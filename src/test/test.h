@@ -10,6 +10,11 @@
  */
 #ifndef TEST_TEST_H
 #define TEST_TEST_H
+
+#include <base/vmath.h>
+
+#include <vector>
+
 class CTestInfo
 {
 public:
@@ -18,4 +23,40 @@ public:
 	char m_aFilenamePrefix[64];
 	char m_aFilename[64];
 };
+
+// small linear congruential generator, the same sequence everywhere
+class CTestRandom
+{
+	unsigned m_State;
+
+public:
+	CTestRandom(unsigned Seed) :
+		m_State(Seed) {}
+	float Next()
+	{
+		m_State = m_State * 1664525u + 1013904223u;
+		return (m_State >> 8) / (float) (1 << 24);
+	}
+	float Range(float Min, float Max) { return Min + Next() * (Max - Min); }
+	int Int(int Max) { return (int) (Next() * Max) % Max; }
+};
+
+// solid border with scattered solid, nohook and death blocks, the tiles closer than FreeRadius to the middle stay free
+void CreateTestMap(class CCollision *pCollision, int Width, int Height, float Density, unsigned Seed, int FreeRadius = 0);
+
+// the sampling CCollision::IntersectLine used before, kept as reference
+int IntersectLineSampled(const class CCollision &Collision, vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision);
+
+// the per pixel CCollision::MoveBox, kept as reference for the exact mode
+void MoveBoxStepped(const class CCollision &Collision, vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath);
+
+struct STestBody
+{
+	vec2 m_Pos;
+	vec2 m_Vel;
+};
+
+// bodies falling, jumping and running around like characters and flags do
+std::vector<STestBody> CreateTestBodies(CTestRandom *pRandom, int Num, vec2 MapSize);
+void KickTestBody(CTestRandom *pRandom, STestBody *pBody);
 #endif // TEST_TEST_H
@@ -0,0 +1,134 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <base/math.h>
+#include <base/system.h>
+
+#include <game/collision.h>
+#include <game/mapitems.h>
+
+#include <vector>
+
+void CreateTestMap(CCollision *pCollision, int Width, int Height, float Density, unsigned Seed, int FreeRadius)
+{
+	CTestRandom Random(Seed);
+	std::vector<CTile> vTiles(Width * Height);
+	for(int y = 0; y < Height; y++)
+	{
+		for(int x = 0; x < Width; x++)
+		{
+			CTile &Tile = vTiles[y * Width + x];
+			mem_zero(&Tile, sizeof(Tile));
+			if(x == 0 || y == 0 || x == Width - 1 || y == Height - 1)
+				Tile.m_Index = TILE_SOLID;
+			else if(absolute(x - Width / 2) < FreeRadius && absolute(y - Height / 2) < FreeRadius)
+				continue;
+			else if(Random.Next() < Density)
+				Tile.m_Index = Random.Next() < 0.8f ? TILE_SOLID : (Random.Next() < 0.5f ? TILE_NOHOOK : TILE_DEATH);
+		}
+	}
+	pCollision->Init(vTiles.data(), Width, Height);
+}
+
+int IntersectLineSampled(const CCollision &Collision, vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision)
+{
+	const int End = distance(Pos0, Pos1) + 1;
+	const float InverseEnd = 1.0f / End;
+	vec2 Last = Pos0;
+
+	for(int i = 0; i <= End; i++)
+	{
+		vec2 Pos = mix(Pos0, Pos1, i * InverseEnd);
+		if(Collision.CheckPoint(Pos.x, Pos.y))
+		{
+			*pOutCollision = Pos;
+			*pOutBeforeCollision = Last;
+			return Collision.GetCollisionAt(Pos.x, Pos.y);
+		}
+		Last = Pos;
+	}
+	*pOutCollision = Pos1;
+	*pOutBeforeCollision = Pos1;
+	return 0;
+}
+
+void MoveBoxStepped(const CCollision &Collision, vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath)
+{
+	vec2 Pos = *pInoutPos;
+	vec2 Vel = *pInoutVel;
+
+	const float Distance = length(Vel);
+	const int Max = (int) Distance;
+
+	if(pDeath)
+		*pDeath = false;
+
+	if(Distance > 0.00001f)
+	{
+		const float Fraction = 1.0f / (Max + 1);
+		for(int i = 0; i <= Max; i++)
+		{
+			vec2 NewPos = Pos + Vel * Fraction;
+			if(pDeath && Collision.TestBox(vec2(NewPos.x, NewPos.y), Size * (2.0f / 3.0f), CCollision::COLFLAG_DEATH))
+				*pDeath = true;
+
+			if(Collision.TestBox(vec2(NewPos.x, NewPos.y), Size))
+			{
+				int Hits = 0;
+				if(Collision.TestBox(vec2(Pos.x, NewPos.y), Size))
+				{
+					NewPos.y = Pos.y;
+					Vel.y *= -Elasticity;
+					Hits++;
+				}
+				if(Collision.TestBox(vec2(NewPos.x, Pos.y), Size))
+				{
+					NewPos.x = Pos.x;
+					Vel.x *= -Elasticity;
+					Hits++;
+				}
+				if(Hits == 0)
+				{
+					NewPos.y = Pos.y;
+					Vel.y *= -Elasticity;
+					NewPos.x = Pos.x;
+					Vel.x *= -Elasticity;
+				}
+			}
+			Pos = NewPos;
+		}
+	}
+
+	*pInoutPos = Pos;
+	*pInoutVel = Vel;
+}
+
+std::vector<STestBody> CreateTestBodies(CTestRandom *pRandom, int Num, vec2 MapSize)
+{
+	std::vector<STestBody> vBodies;
+	for(int i = 0; i < Num; i++)
+	{
+		STestBody Body;
+		Body.m_Pos = vec2(pRandom->Range(32.0f, MapSize.x - 32.0f), pRandom->Range(32.0f, MapSize.y - 32.0f));
+		Body.m_Vel = vec2(pRandom->Range(-20.0f, 20.0f), pRandom->Range(-20.0f, 20.0f));
+		vBodies.push_back(Body);
+	}
+	return vBodies;
+}
+
+void KickTestBody(CTestRandom *pRandom, STestBody *pBody)
+{
+	pBody->m_Vel.y += 0.5f;
+	if(pRandom->Next() < 0.05f)
+		pBody->m_Vel = vec2(pRandom->Range(-30.0f, 30.0f), pRandom->Range(-30.0f, 10.0f));
+	pBody->m_Vel.x = clamp(pBody->m_Vel.x, -60.0f, 60.0f);
+	pBody->m_Vel.y = clamp(pBody->m_Vel.y, -60.0f, 60.0f);
+}
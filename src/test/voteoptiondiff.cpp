@@ -0,0 +1,193 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+#include <game/voteoptiondiff.h>
+#include <game/voting.h>
+
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static std::vector<const char *> Pointers(const std::vector<std::string> &vOptions)
+{
+	std::vector<const char *> vpOptions;
+	for(const std::string &Option : vOptions)
+		vpOptions.push_back(Option.c_str());
+	return vpOptions;
+}
+
+// applies a plan like the client does, it removes the first option with the description
+static std::vector<std::string> Apply(const CVoteOptionDiff &Diff, const std::vector<std::string> &vOld, const std::vector<std::string> &vNew)
+{
+	std::vector<std::string> vShown = Diff.Clear() ? std::vector<std::string>() : vOld;
+	for(int Removal : Diff.Removals())
+	{
+		for(unsigned i = 0; i < vShown.size(); i++)
+		{
+			if(vShown[i] == vOld[Removal])
+			{
+				vShown.erase(vShown.begin() + i);
+				break;
+			}
+		}
+	}
+	vShown.insert(vShown.end(), vNew.begin() + Diff.NumKept(), vNew.end());
+	return vShown;
+}
+
+static CVoteOptionDiff Plan(const std::vector<std::string> &vOld, const std::vector<std::string> &vNew)
+{
+	std::vector<const char *> vpOld = Pointers(vOld);
+	std::vector<const char *> vpNew = Pointers(vNew);
+	CVoteOptionDiff Diff;
+	Diff.Plan(vpOld.data(), vpOld.size(), vpNew.data(), vpNew.size());
+	return Diff;
+}
+
+// the main menu with its tip, as a client sees it after entering
+static std::vector<std::string> MainMenu(bool Tip, bool Addr)
+{
+	std::vector<std::string> vOptions = {"===============================", "= Main Menu", "==============================="};
+	if(Tip)
+	{
+		vOptions.insert(vOptions.end(), {"If you don't want to close menu when you use a option,", "then you can input this in your console:",
+							"ui_close_window_after_changing_setting 0", "(Click this to hide this tip)", "−−−−−−−−−−−−−−−−−−−−−"});
+	}
+	vOptions.insert(vOptions.end(), {"- Name: nameless tee", "- Level: 0", Addr ? "- IP Address: 127.0.0.1:8303 (Click to hide)" : "- IP Address: (Click to display)",
+						"−−−−−−−−−−−−−−−−−−−−−", "★ Server Vote", "★ Language Settings"});
+	return vOptions;
+}
+
+static std::vector<std::string> ServerVotes(int Num)
+{
+	std::vector<std::string> vOptions = {"===============================", "= Server Vote", "==============================="};
+	for(int i = 0; i < Num; i++)
+		vOptions.push_back("Change map to ctf" + std::to_string(i));
+	vOptions.insert(vOptions.end(), {"−−−−−−−−−−−−−−−−−−−−−", "= Previous Page"});
+	return vOptions;
+}
+
+TEST(VoteOptionDiff, Unchanged)
+{
+	std::vector<std::string> vMain = MainMenu(true, false);
+	CVoteOptionDiff Diff = Plan(vMain, vMain);
+	EXPECT_FALSE(Diff.Clear());
+	EXPECT_EQ(Diff.NumKept(), (int) vMain.size());
+	EXPECT_EQ(Diff.NumMessages(), 0);
+}
+
+TEST(VoteOptionDiff, TailChanges)
+{
+	std::vector<std::string> vOld = {"a", "b", "c"};
+	std::vector<std::string> vNew = {"a", "b", "c", "d"};
+	CVoteOptionDiff Diff = Plan(vOld, vNew);
+	EXPECT_FALSE(Diff.Clear());
+	EXPECT_EQ(Diff.NumMessages(), 1);
+	EXPECT_EQ(Apply(Diff, vOld, vNew), vNew);
+
+	// removing one option from the middle
+	Diff = Plan(vNew, vOld);
+	ASSERT_FALSE(Diff.Clear());
+	ASSERT_EQ(Diff.Removals().size(), 1u);
+	EXPECT_EQ(Diff.Removals()[0], 3);
+	EXPECT_EQ(Apply(Diff, vNew, vOld), vOld);
+}
+
+TEST(VoteOptionDiff, ClearsWhenCheaper)
+{
+	CVoteOptionDiff Diff = Plan(MainMenu(true, false), ServerVotes(4));
+	EXPECT_TRUE(Diff.Clear());
+	EXPECT_EQ(Diff.NumMessages(), 2);
+}
+
+TEST(VoteOptionDiff, Unremovable)
+{
+	// the client would drop the wrong duplicate or can't match the stripped or trimmed one
+	const std::vector<std::string> avOld[] = {{"=", "a", "="}, {"#x", "x", "a"}, {" a", "b"}, {"a", "#b", "c"}};
+	const std::vector<std::string> avNew[] = {{"=", "a"}, {"#x"}, {"b"}, {"a", "c"}};
+	for(unsigned i = 0; i < std::size(avOld); i++)
+	{
+		CVoteOptionDiff Diff = Plan(avOld[i], avNew[i]);
+		EXPECT_TRUE(Diff.Clear()) << i;
+		EXPECT_EQ(Apply(Diff, avOld[i], avNew[i]), avNew[i]) << i;
+	}
+
+	// duplicates are fine as long as the kept ones come out in order
+	std::vector<std::string> vOld = {"=", "=", "a"};
+	std::vector<std::string> vNew = {"=", "a"};
+	CVoteOptionDiff Diff = Plan(vOld, vNew);
+	EXPECT_FALSE(Diff.Clear());
+	EXPECT_EQ(Diff.NumMessages(), 1);
+	EXPECT_EQ(Apply(Diff, vOld, vNew), vNew);
+}
+
+TEST(VoteOptionDiff, RandomLists)
+{
+	static const char *const s_apWords[] = {"=", "-", "a", "b", "c", "d"};
+	CTestRandom Random(5);
+	for(int Run = 0; Run < 2000; Run++)
+	{
+		std::vector<std::string> vOld, vNew;
+		for(int i = Random.Int(12); i > 0; i--)
+			vOld.push_back(s_apWords[Random.Int(std::size(s_apWords))]);
+		// mostly edits of the old list
+		vNew = vOld;
+		for(int i = Random.Int(4); i > 0; i--)
+		{
+			if(!vNew.empty() && Random.Next() < 0.5f)
+				vNew.erase(vNew.begin() + Random.Int(vNew.size()));
+			else
+				vNew.insert(vNew.begin() + Random.Int(vNew.size() + 1), s_apWords[Random.Int(std::size(s_apWords))]);
+		}
+
+		CVoteOptionDiff Diff = Plan(vOld, vNew);
+		ASSERT_EQ(Apply(Diff, vOld, vNew), vNew) << "run " << Run;
+		EXPECT_LE(Diff.NumMessages(), 1 + CVoteOptionDiff::NumAddMessages(vNew.size())) << "run " << Run;
+	}
+}
+
+TEST(VoteOptionDiff, MessageCounts)
+{
+	struct SStep
+	{
+		const char *m_pName;
+		std::vector<std::string> m_vOld;
+		std::vector<std::string> m_vNew;
+	};
+	const SStep aSteps[] = {
+		{"refresh main", MainMenu(true, false), MainMenu(true, false)},
+		{"show address", MainMenu(false, false), MainMenu(false, true)},
+		{"hide tip", MainMenu(true, false), MainMenu(false, false)},
+		{"open server votes", MainMenu(false, false), ServerVotes(40)},
+		{"refresh server votes", ServerVotes(40), ServerVotes(40)},
+		{"new server vote", ServerVotes(40), ServerVotes(41)},
+	};
+
+	int aTotal[2] = {0, 0};
+	for(const SStep &Step : aSteps)
+	{
+		CVoteOptionDiff Diff = Plan(Step.m_vOld, Step.m_vNew);
+		EXPECT_EQ(Apply(Diff, Step.m_vOld, Step.m_vNew), Step.m_vNew) << Step.m_pName;
+
+		// a clear and the whole list is what every page change sent before
+		const int Full = 1 + CVoteOptionDiff::NumAddMessages(Step.m_vNew.size());
+		EXPECT_LE(Diff.NumMessages(), Full) << Step.m_pName;
+		aTotal[0] += Full;
+		aTotal[1] += Diff.NumMessages();
+		printf("[ BENCH    ] %s: %d vital messages full, %d diffed\n", Step.m_pName, Full, Diff.NumMessages());
+	}
+	printf("[ BENCH    ] all steps: %d vital messages full, %d diffed\n", aTotal[0], aTotal[1]);
+}
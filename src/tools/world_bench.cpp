@@ -0,0 +1,867 @@
+/*
+ * This file is part of Carbon, a modified version of Teeworlds.
+ *
+ * Copyright (C) 2025 TeeMidnight
+ *
+ * This software is provided 'as-is', under the zlib License.
+ * See license.txt in the root of the distribution for more information.
+ * If you are missing that file, acquire a complete release at github.com/TeeMidnight/teeworlds-carbon
+ */
+#include <base/system.h>
+
+#include <engine/config.h>
+#include <engine/console.h>
+#include <engine/localization.h>
+#include <engine/map.h>
+#include <engine/server.h>
+#include <engine/shared/compression.h>
+#include <engine/shared/config.h>
+#include <engine/message.h>
+#include <engine/shared/network.h>
+#include <engine/shared/protocol.h>
+#include <engine/shared/simrecord.h>
+#include <engine/shared/snapshot.h>
+#include <engine/storage.h>
+
+#include <game/server/botmanager.h>
+#include <game/server/entity.h>
+#include <game/server/gamecontext.h>
+#include <game/server/gameworld.h>
+#include <game/server/gameworld.inl>
+#include <game/version.h>
+
+#include <generated/protocol.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+	Class: Packet Model
+		Packs the chunks sent to each client into connection packets
+		like CNetConnection::QueueChunkEx, once flushing on every flush
+		send (sv_net_coalesce 0) and once holding the flush of non-vital
+		sends until the end of the tick (sv_net_coalesce 1).
+*/
+class CPacketModel
+{
+public:
+	enum
+	{
+		MODE_FLUSH = 0,
+		MODE_COALESCE,
+		NUM_MODES
+	};
+
+private:
+	struct CConnection
+	{
+		int m_Size;
+		int m_NumChunks;
+		bool m_FlushPending;
+	};
+
+	CConnection m_aaConnections[NUM_MODES][SERVER_MAX_CLIENTS];
+
+	void Flush(int Mode, int ClientID)
+	{
+		CConnection &Connection = m_aaConnections[Mode][ClientID];
+		Connection.m_FlushPending = false;
+		if(!Connection.m_NumChunks)
+			return;
+		m_aNumPackets[Mode]++;
+		m_aPayloadBytes[Mode] += Connection.m_Size;
+		Connection.m_Size = 0;
+		Connection.m_NumChunks = 0;
+	}
+
+public:
+	int64_t m_aNumPackets[NUM_MODES];
+	int64_t m_aPayloadBytes[NUM_MODES];
+
+	CPacketModel()
+	{
+		mem_zero(m_aaConnections, sizeof(m_aaConnections));
+		mem_zero(m_aNumPackets, sizeof(m_aNumPackets));
+		mem_zero(m_aPayloadBytes, sizeof(m_aPayloadBytes));
+	}
+
+	void Queue(int ClientID, int Flags, int DataSize)
+	{
+		for(int Mode = 0; Mode < NUM_MODES; Mode++)
+		{
+			CConnection &Connection = m_aaConnections[Mode][ClientID];
+			if(Connection.m_Size + DataSize + NET_MAX_CHUNKHEADERSIZE > NET_MAX_PAYLOAD || Connection.m_NumChunks == NET_MAX_PACKET_CHUNKS)
+				Flush(Mode, ClientID);
+			Connection.m_Size += (Flags & MSGFLAG_VITAL ? 3 : 2) + DataSize;
+			Connection.m_NumChunks++;
+
+			if(Flags & MSGFLAG_FLUSH)
+			{
+				if(Mode == MODE_COALESCE && !(Flags & MSGFLAG_VITAL))
+					Connection.m_FlushPending = true;
+				else
+					Flush(Mode, ClientID);
+			}
+		}
+	}
+
+	// what CNetServer::FlushPending does once per server loop
+	void EndTick()
+	{
+		for(int ClientID = 0; ClientID < SERVER_MAX_CLIENTS; ClientID++)
+			if(m_aaConnections[MODE_COALESCE][ClientID].m_FlushPending)
+				Flush(MODE_COALESCE, ClientID);
+	}
+
+	double Fill(int Mode) const { return m_aNumPackets[Mode] ? m_aPayloadBytes[Mode] / (double) (m_aNumPackets[Mode] * NET_MAX_PAYLOAD) : 0.0; }
+};
+
+/*
+	Class: Bench Server
+		IServer without a network. Clients only exist as slots that are
+		ingame, messages are packed and dropped and snapshots are built
+		and delta packed but not sent. What would be sent goes through
+		the packet model. Maps are loaded synchronously when requested.
+*/
+class CBenchServer : public IServer
+{
+	enum
+	{
+		STATE_EMPTY = 0,
+		STATE_CONNECTING,
+		STATE_INGAME,
+	};
+
+	struct CClient
+	{
+		int m_State;
+		char m_aName[MAX_NAME_ARRAY_SIZE];
+		char m_aClan[MAX_CLAN_ARRAY_SIZE];
+		int m_Country;
+		int m_Score;
+		Uuid m_MapID; // zeroed for the base map
+		int m_Version;
+		int m_CarbonVersion;
+		int m_DDNetVersion;
+	};
+
+	struct CMapInfo
+	{
+		std::string m_Name;
+		unsigned m_ModeID;
+	};
+
+	CClient m_aClients[SERVER_MAX_CLIENTS];
+
+	CConfig *m_pConfig;
+	IConsole *m_pConsole;
+	IEngineMap *m_pMap;
+	ILocalization *m_pLocalization;
+
+	Uuid m_MapID;
+	std::map<Uuid, CMapInfo> m_Maps;
+	Uuid m_LoadedMapID;
+
+	CSnapshotBuilder m_SnapshotBuilder;
+	CSnapshotDelta m_SnapshotDelta;
+	std::vector<char> m_avLastSnapshots[SERVER_MAX_CLIENTS]; // every snapshot counts as acked right away
+	std::vector<int> m_vFreeSnapIDs;
+	int m_NextSnapID;
+
+	void QueueMsg(int Flags, int ClientID, int Size)
+	{
+		if(Flags & MSGFLAG_NOSEND)
+			return;
+		if(ClientID != -1)
+		{
+			if(ClientID >= 0 && ClientID < SERVER_MAX_CLIENTS && m_aClients[ClientID].m_State != STATE_EMPTY)
+				m_Packets.Queue(ClientID, Flags, Size);
+			return;
+		}
+		for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+			if(m_aClients[i].m_State == STATE_INGAME)
+				m_Packets.Queue(i, Flags, Size);
+	}
+
+public:
+	int64_t m_NumMsgs;
+	int64_t m_NumSnapBytes;
+	CPacketModel m_Packets;
+
+	CBenchServer()
+	{
+		m_CurrentGameTick = 0;
+		m_TickSpeed = SERVER_TICK_SPEED;
+		mem_zero(m_aClients, sizeof(m_aClients));
+		m_pConfig = nullptr;
+		m_pConsole = nullptr;
+		m_pMap = nullptr;
+		m_pLocalization = nullptr;
+		m_MapID = UUID_ZEROED;
+		m_LoadedMapID = UUID_ZEROED;
+		m_NextSnapID = 0;
+		m_NumMsgs = 0;
+		m_NumSnapBytes = 0;
+	}
+
+	void InitInterfaces(IKernel *pKernel)
+	{
+		m_pConfig = pKernel->RequestInterface<IConfigManager>()->Values();
+		m_pConsole = pKernel->RequestInterface<IConsole>();
+		m_pMap = pKernel->RequestInterface<IEngineMap>();
+		m_pLocalization = pKernel->RequestInterface<ILocalization>();
+	}
+
+	void AdvanceTick() { m_CurrentGameTick++; }
+	void SetTick(int Tick) { m_CurrentGameTick = Tick; }
+	Uuid MapID() const { return m_MapID; }
+	bool MapLoaded() const { return !m_Maps.empty(); }
+
+	// makes the map the one the game server reads new worlds from
+	bool LoadMap(const char *pMapName, unsigned ModeID)
+	{
+		const Uuid MapID = CalculateUuid(pMapName);
+		if(m_LoadedMapID != MapID)
+		{
+			char aBuf[IO_MAX_PATH_LENGTH];
+			str_format(aBuf, sizeof(aBuf), "maps/%s.map", pMapName);
+			if(!m_pMap->Load(aBuf))
+			{
+				dbg_msg("world_bench", "failed to load map '%s'", aBuf);
+				return false;
+			}
+			m_LoadedMapID = MapID;
+		}
+
+		if(m_Maps.empty())
+			m_MapID = MapID;
+		m_Maps[MapID] = {pMapName, ModeID};
+		return true;
+	}
+
+	void ConnectClient(int ClientID, int Version, int CarbonVersion, int DDNetVersion)
+	{
+		m_aClients[ClientID].m_State = STATE_CONNECTING;
+		m_aClients[ClientID].m_Version = Version;
+		m_aClients[ClientID].m_CarbonVersion = CarbonVersion;
+		m_aClients[ClientID].m_DDNetVersion = DDNetVersion;
+	}
+	void EnterClient(int ClientID) { m_aClients[ClientID].m_State = STATE_INGAME; }
+	// like a map change of the server, the client has to connect again
+	void SetClientMap(int ClientID, Uuid MapID)
+	{
+		if(m_aClients[ClientID].m_State == STATE_INGAME)
+			m_aClients[ClientID].m_State = STATE_CONNECTING;
+		m_aClients[ClientID].m_MapID = MapID;
+		m_avLastSnapshots[ClientID].clear();
+	}
+	void DropClient(int ClientID)
+	{
+		mem_zero(&m_aClients[ClientID], sizeof(m_aClients[ClientID]));
+		m_avLastSnapshots[ClientID].clear();
+	}
+
+	// builds the snapshot of a client and packs its delta into messages like the server does, returns its size
+	int Snap(IGameServer *pGameServer, int ClientID)
+	{
+		static char s_aData[CSnapshot::MAX_SIZE];
+		static char s_aDeltaData[CSnapshot::MAX_SIZE];
+		static char s_aCompData[CSnapshot::MAX_SIZE];
+		m_SnapshotBuilder.Init();
+		pGameServer->OnSnap(ClientID);
+		CSnapshot *pData = (CSnapshot *) s_aData;
+		const int Size = m_SnapshotBuilder.Finish(pData);
+		m_NumSnapBytes += Size;
+		if(ClientID < 0)
+			return Size;
+
+		static CSnapshot s_EmptySnap;
+		std::vector<char> &vLast = m_avLastSnapshots[ClientID];
+		const CSnapshot *pDeltashot = vLast.empty() ? &s_EmptySnap : (const CSnapshot *) vLast.data();
+		const int DeltaSize = m_SnapshotDelta.CreateDelta(pDeltashot, pData, s_aDeltaData);
+		vLast.assign(s_aData, s_aData + Size);
+		if(DeltaSize <= 0)
+			return Size;
+
+		// the parts of a big snapshot are separate messages, the ints are only placeholders of the right size
+		const int CompSize = CVariableInt::Compress(s_aDeltaData, DeltaSize, s_aCompData, sizeof(s_aCompData));
+		const int NumParts = (CompSize + MAX_SNAPSHOT_PACKSIZE - 1) / MAX_SNAPSHOT_PACKSIZE;
+		for(int n = 0, Left = CompSize; Left > 0; n++)
+		{
+			const int Chunk = minimum(Left, (int) MAX_SNAPSHOT_PACKSIZE);
+			Left -= Chunk;
+			CMsgPacker Msg(NumParts == 1 ? NETMSG_SNAPSINGLE : NETMSG_SNAP, true);
+			Msg.AddInt(m_CurrentGameTick);
+			Msg.AddInt(1);
+			if(NumParts > 1)
+			{
+				Msg.AddInt(NumParts);
+				Msg.AddInt(n);
+			}
+			Msg.AddInt(pData->Crc());
+			Msg.AddInt(Chunk);
+			Msg.AddRaw(&s_aCompData[n * MAX_SNAPSHOT_PACKSIZE], Chunk);
+			QueueMsg(MSGFLAG_FLUSH, ClientID, Msg.Size());
+		}
+		return Size;
+	}
+
+	const char *ClientLanguage(int ClientID) const override { return m_pConfig->m_SvDefaultLanguage; }
+	const char *ClientName(int ClientID) const override
+	{
+		if(ClientID < 0 || ClientID >= SERVER_MAX_CLIENTS || m_aClients[ClientID].m_State == STATE_EMPTY)
+			return "(invalid)";
+		return m_aClients[ClientID].m_State == STATE_INGAME ? m_aClients[ClientID].m_aName : "(connecting)";
+	}
+	const char *ClientClan(int ClientID) const override { return ClientIngame(ClientID) ? m_aClients[ClientID].m_aClan : ""; }
+	int ClientCountry(int ClientID) const override { return ClientIngame(ClientID) ? m_aClients[ClientID].m_Country : -1; }
+	int ClientScore(int ClientID) const override { return ClientIngame(ClientID) ? m_aClients[ClientID].m_Score : 0; }
+	bool ClientIngame(int ClientID) const override { return ClientID >= 0 && ClientID < SERVER_MAX_CLIENTS && m_aClients[ClientID].m_State == STATE_INGAME; }
+	Uuid GetClientMapID(int ClientID) const override { return m_aClients[ClientID].m_MapID == UUID_ZEROED ? m_MapID : m_aClients[ClientID].m_MapID; }
+	int GetClientInfo(int ClientID, CClientInfo *pInfo) const override
+	{
+		if(!ClientIngame(ClientID))
+			return 0;
+		pInfo->m_pName = m_aClients[ClientID].m_aName;
+		pInfo->m_Latency = 0;
+		return 1;
+	}
+	void GetClientAddr(int ClientID, char *pAddrStr, int Size) const override { str_format(pAddrStr, Size, "bench:%d", ClientID); }
+	int GetClientVersion(int ClientID) const override { return ClientIngame(ClientID) ? m_aClients[ClientID].m_Version : 0; }
+	int GetCarbonClientVersion(int ClientID) const override { return ClientIngame(ClientID) ? m_aClients[ClientID].m_CarbonVersion : 0; }
+	int GetDDNetClientVersion(int ClientID) const override { return ClientIngame(ClientID) ? m_aClients[ClientID].m_DDNetVersion : 0; }
+
+	int SendMsg(CMsgPacker *pMsg, int Flags, int ClientID) override
+	{
+		m_NumMsgs++;
+		QueueMsg(Flags, ClientID, pMsg->Size());
+		return 0;
+	}
+	void SetThreadMsgBuffer(CMsgBuffer *pBuffer) override {}
+	void SendMsgBuffer(CMsgBuffer *pBuffer) override
+	{
+		m_NumMsgs += pBuffer->m_vMsgs.size();
+		for(const CMsgBuffer::CMsg &Msg : pBuffer->m_vMsgs)
+			QueueMsg(Msg.m_Flags, Msg.m_ClientID, Msg.m_Size);
+		pBuffer->m_vData.clear();
+		pBuffer->m_vMsgs.clear();
+	}
+
+	void SetClientLanguage(int ClientID, char const *pLanguage) override {}
+	void SetClientName(int ClientID, char const *pName) override { str_copy(m_aClients[ClientID].m_aName, pName, sizeof(m_aClients[ClientID].m_aName)); }
+	void SetClientClan(int ClientID, char const *pClan) override { str_copy(m_aClients[ClientID].m_aClan, pClan, sizeof(m_aClients[ClientID].m_aClan)); }
+	void SetClientCountry(int ClientID, int Country) override { m_aClients[ClientID].m_Country = Country; }
+	void SetClientScore(int ClientID, int Score) override { m_aClients[ClientID].m_Score = Score; }
+
+	int SnapNewID() override
+	{
+		if(m_vFreeSnapIDs.empty())
+			return m_NextSnapID++;
+		const int ID = m_vFreeSnapIDs.back();
+		m_vFreeSnapIDs.pop_back();
+		return ID;
+	}
+	void SnapFreeID(int ID) override { m_vFreeSnapIDs.push_back(ID); }
+	void *SnapNewItem(int Type, int ID, int Size) override
+	{
+		dbg_assert(ID >= 0 && ID <= 0xffff, "incorrect id");
+		return ID < 0 ? 0 : m_SnapshotBuilder.NewItem(Type, ID, Size);
+	}
+	void SnapSetStaticsize(int ItemType, int Size) override { m_SnapshotDelta.SetStaticsize(ItemType, Size); }
+
+	void SetRconCID(int ClientID) override {}
+	bool IsAuthed(int ClientID) const override { return false; }
+	bool IsBanned(int ClientID) override { return false; }
+	void Kick(int ClientID, const char *pReason) override {}
+
+	void DemoRecorder_HandleAutoStart() override {}
+	bool DemoRecorder_IsRecording() override { return false; }
+
+	const char *Localize(const char *pCode, const char *pStr, const char *pContext = "") override { return m_pLocalization->Localize(pCode, pStr, pContext); }
+	const char *Localize(int ClientID, const char *pStr, const char *pContext = "") override { return m_pLocalization->Localize(ClientLanguage(ClientID), pStr, pContext); }
+	int GetLanguagesInfo(struct SLanguageInfo **ppInfo) override { return m_pLocalization->GetLanguagesInfo(ppInfo); }
+
+	// the world switches of a re-simulation come from the record
+	void SwitchClientMap(int ClientID, Uuid MapID) override {}
+	void RequestNewMap(int ClientID, const char *pMapName, unsigned ModeID) override
+	{
+		// like the server, a known map only gets its mode updated
+		const Uuid MapID = CalculateUuid(pMapName);
+		if(m_Maps.count(MapID))
+			m_Maps[MapID].m_ModeID = ModeID;
+		else
+			LoadMap(pMapName, ModeID);
+	}
+
+	Uuid GetBaseMapUuid() const override { return m_MapID; }
+	const char *GetMapName(Uuid MapID) override { return m_Maps.count(MapID) ? m_Maps[MapID].m_Name.c_str() : "Unknowned World"; }
+	unsigned GetMapModeID(Uuid MapID) override
+	{
+		dbg_assert(m_Maps.count(MapID), "Couldn't find this map");
+		return m_Maps[MapID].m_ModeID;
+	}
+};
+
+// deterministic inputs, every character changes its mind now and then
+class CScriptedInput
+{
+	unsigned m_State;
+
+	int Next()
+	{
+		m_State = m_State * 1664525u + 1013904223u;
+		return m_State >> 8;
+	}
+
+public:
+	CScriptedInput(unsigned Seed) :
+		m_State(Seed) {}
+
+	void Update(CNetObj_PlayerInput *pInput)
+	{
+		if(Next() % 20 == 0)
+			pInput->m_Direction = Next() % 3 - 1;
+		pInput->m_Jump = Next() % 12 == 0;
+		if(Next() % 25 == 0)
+			pInput->m_Hook = !pInput->m_Hook;
+		if(Next() % 8 == 0)
+		{
+			pInput->m_TargetX = Next() % 600 - 300;
+			pInput->m_TargetY = Next() % 600 - 300;
+		}
+		// an even count is a released button
+		if(Next() % 6 == 0)
+			pInput->m_Fire++;
+		if(Next() % 100 == 0)
+			pInput->m_WantedWeapon = Next() % NUM_WEAPONS + 1;
+	}
+};
+
+// random free tiles as bot spawn points, the bot manager fills every one with a bot
+static int AddBotSpawns(CGameWorld *pWorld, int Count)
+{
+	// fixed seed, so runs with the same options are comparable
+	unsigned State = 1;
+	const vec2 ColBox(CCharacterCore::PHYS_SIZE, CCharacterCore::PHYS_SIZE);
+	CCollision *pCollision = pWorld->Collision();
+	int Added = 0;
+	for(int Try = 0; Added < Count && Try < Count * 32; Try++)
+	{
+		State = State * 1664525u + 1013904223u;
+		const int X = (State >> 8) % pCollision->GetWidth();
+		State = State * 1664525u + 1013904223u;
+		const int Y = (State >> 8) % pCollision->GetHeight();
+		vec2 Pos = vec2(X + 0.5f, Y + 0.5f) * 32.0f;
+		if(pCollision->TestBox(Pos, ColBox) || pCollision->CheckPoint(Pos, CCollision::COLFLAG_DEATH))
+			continue;
+		pWorld->m_avSpawnPoints[2].push_back(Pos);
+		Added++;
+	}
+	return Added;
+}
+
+static void Usage()
+{
+	dbg_msg("world_bench", "usage: world_bench [-m map] [-c characters] [-b bots] [-t ticks] [-s snapping clients] [-w write simulation record] [-r re-simulate record]");
+	dbg_msg("world_bench", "a record written with -w re-simulates with the same -b, bot spawns are not in the record");
+}
+
+static void PrintPackets(const CPacketModel *pPackets, int NumTicks)
+{
+	const double Seconds = NumTicks / (double) SERVER_TICK_SPEED;
+	dbg_msg("world_bench", "connection packets: %.0f/s flushing every send, %.0f/s coalescing per tick; average fill %.1f%% -> %.1f%%",
+		pPackets->m_aNumPackets[CPacketModel::MODE_FLUSH] / Seconds, pPackets->m_aNumPackets[CPacketModel::MODE_COALESCE] / Seconds,
+		pPackets->Fill(CPacketModel::MODE_FLUSH) * 100.0, pPackets->Fill(CPacketModel::MODE_COALESCE) * 100.0);
+}
+
+// feeds a record of sv_sim_record into the game server as fast as it goes and
+// compares the world hash after every tick, returns the number of mismatches.
+// NumBots re-adds the bot spawns of a record written by -w with the same -b
+static int Resimulate(CBenchServer *pServer, IGameServer *pGameServer, CSimRecordReader *pReader, int NumBots)
+{
+	int NumTicks = 0;
+	int NumSnaps = 0;
+	int NumMismatches = 0;
+	int FirstTick = -1;
+	int FirstMismatch = -1;
+	int64_t TickTime = 0;
+	int64_t SnapTime = 0;
+	int aInput[MAX_INPUT_SIZE];
+
+	const int64_t StartTime = time_get();
+	CSimRecord Record;
+	while(pReader->Read(&Record))
+	{
+		const int ClientID = Record.m_ClientID;
+		if(Record.m_Type != SIMREC_TICK && Record.m_Type != SIMREC_TICK_END && Record.m_Type != SIMREC_SNAP && Record.m_Type != SIMREC_LOAD_WORLD &&
+			(ClientID < 0 || ClientID >= SERVER_MAX_CLIENTS))
+		{
+			dbg_msg("world_bench", "record has an invalid client id %d", ClientID);
+			return -1;
+		}
+
+		switch(Record.m_Type)
+		{
+		case SIMREC_TICK:
+			pServer->m_Packets.EndTick();
+			pServer->SetTick(Record.m_aInts[0]);
+			if(FirstTick < 0)
+				FirstTick = Record.m_aInts[0];
+			break;
+		case SIMREC_TICK_END:
+		{
+			int64_t Start = time_get();
+			pGameServer->OnTick();
+			TickTime += time_get() - Start;
+			NumTicks++;
+
+			const unsigned Hash = pGameServer->WorldHash();
+			if(Hash != (unsigned) Record.m_aInts[0])
+			{
+				if(NumMismatches == 0)
+				{
+					FirstMismatch = pServer->Tick();
+					dbg_msg("world_bench", "world hash mismatch at tick %d: recorded %08x, got %08x", FirstMismatch, (unsigned) Record.m_aInts[0], Hash);
+				}
+				NumMismatches++;
+			}
+			break;
+		}
+		case SIMREC_SNAP:
+		{
+			int64_t Start = time_get();
+			pGameServer->OnPreSnap();
+			for(int i = 0; i < Record.m_NumInts; i++)
+				pServer->Snap(pGameServer, Record.m_aInts[i]);
+			pGameServer->OnPostSnap();
+			SnapTime += time_get() - Start;
+			NumSnaps++;
+			break;
+		}
+		case SIMREC_CONNECT:
+			pServer->ConnectClient(ClientID, Record.m_aInts[1], Record.m_aInts[2], Record.m_aInts[3]);
+			pGameServer->OnClientConnected(ClientID, Record.m_aInts[0]);
+			break;
+		case SIMREC_ENTER:
+			pServer->EnterClient(ClientID);
+			pGameServer->OnClientEnter(ClientID);
+			break;
+		case SIMREC_DROP:
+			pGameServer->OnClientDrop(ClientID, Record.m_aString);
+			pServer->DropClient(ClientID);
+			break;
+		case SIMREC_DIRECT_INPUT:
+		case SIMREC_PREDICTED_INPUT:
+			mem_zero(aInput, sizeof(aInput));
+			mem_copy(aInput, Record.m_aInts, Record.m_NumInts * sizeof(int));
+			if(Record.m_Type == SIMREC_DIRECT_INPUT)
+				pGameServer->OnClientDirectInput(ClientID, aInput);
+			else
+				pGameServer->OnClientPredictedInput(ClientID, aInput);
+			break;
+		case SIMREC_MESSAGE:
+		{
+			CMsgUnpacker Unpacker(Record.m_aData, Record.m_DataSize);
+			if(!Unpacker.Error() && !Unpacker.System())
+				pGameServer->OnMessage(Unpacker.Type(), &Unpacker, ClientID);
+			break;
+		}
+		case SIMREC_LOAD_WORLD:
+			if(!pServer->LoadMap(Record.m_aString, Record.m_aInts[0]))
+				return -1;
+		{
+			const Uuid MapID = CalculateUuid(Record.m_aString);
+			pGameServer->LoadNewWorld(MapID);
+			CGameWorld *pWorld = static_cast<CGameContext *>(pGameServer)->m_upWorlds[MapID];
+			if(NumBots && pWorld->BotManager())
+				AddBotSpawns(pWorld, NumBots);
+			break;
+		}
+		case SIMREC_SWITCH_WORLD:
+		{
+			const Uuid MapID = CalculateUuid(Record.m_aString);
+			pServer->SetClientMap(ClientID, MapID);
+			pGameServer->SwitchPlayerWorld(ClientID, MapID);
+			break;
+		}
+		}
+	}
+	const int64_t Duration = time_get() - StartTime;
+
+	const double NsPerTime = 1000000000.0 / time_freq();
+	dbg_msg("world_bench", "re-simulated %d ticks (%.1fs of game time from tick %d) in %.3fs, %.0f ticks/s", NumTicks,
+		NumTicks / (double) SERVER_TICK_SPEED, FirstTick, Duration / (double) time_freq(), Duration ? NumTicks * (double) time_freq() / Duration : 0.0);
+	dbg_msg("world_bench", "world tick: %.0f ns/tick, snap: %.0f ns per snap over %d snaps", NumTicks ? TickTime * NsPerTime / NumTicks : 0.0,
+		NumSnaps ? SnapTime * NsPerTime / NumSnaps : 0.0, NumSnaps);
+	pServer->m_Packets.EndTick();
+	PrintPackets(&pServer->m_Packets, NumTicks);
+	if(NumMismatches)
+		dbg_msg("world_bench", "NOT deterministic: %d of %d ticks hashed differently, the first at tick %d", NumMismatches, NumTicks, FirstMismatch);
+	else
+		dbg_msg("world_bench", "deterministic: all %d world hashes match the record", NumTicks);
+	return NumMismatches;
+}
+
+// scripted characters and bots on a single world, pRecorder gets what a server would record
+static int RunScripted(CBenchServer *pServer, IGameServer *pGameServer, CSimRecorder *pRecorder, const char *pMapName, int NumCharacters, int NumBots, int NumTicks, int NumSnapping)
+{
+	pRecorder->RecordLoadWorld(pMapName, pServer->GetMapModeID(pServer->MapID()));
+	pGameServer->LoadNewWorld(pServer->MapID());
+
+	CGameWorld *pWorld = static_cast<CGameContext *>(pGameServer)->m_upWorlds[pServer->MapID()];
+	if(NumBots && pWorld->BotManager())
+		AddBotSpawns(pWorld, NumBots);
+
+	// connect the characters the way a client does: start info, then enter
+	for(int i = 0; i < NumCharacters; i++)
+	{
+		pServer->ConnectClient(i, CLIENT_VERSION, 0, 0);
+		pRecorder->RecordConnect(i, false, CLIENT_VERSION, 0, 0);
+		pGameServer->OnClientConnected(i, false);
+
+		CNetMsg_Cl_StartInfo StartInfo;
+		char aName[16];
+		str_format(aName, sizeof(aName), "bench%d", i);
+		StartInfo.m_pName = aName;
+		StartInfo.m_pClan = "";
+		StartInfo.m_Country = -1;
+		for(int p = 0; p < NUM_SKINPARTS; p++)
+		{
+			StartInfo.m_apSkinPartNames[p] = "standard";
+			StartInfo.m_aUseCustomColors[p] = 0;
+			StartInfo.m_aSkinPartColors[p] = 0;
+		}
+		CMsgPacker Packer(StartInfo.MsgID());
+		StartInfo.Pack(&Packer);
+		pRecorder->RecordMessage(i, Packer.Data(), Packer.Size());
+		CUnpacker Unpacker;
+		Unpacker.Reset(Packer.Data(), Packer.Size());
+		Unpacker.GetInt(); // message id
+		pGameServer->OnMessage(StartInfo.MsgID(), &Unpacker, i);
+
+		if(!pGameServer->IsClientReady(i))
+		{
+			dbg_msg("world_bench", "client %d did not get ready", i);
+			return -1;
+		}
+		pServer->EnterClient(i);
+		pRecorder->RecordEnter(i);
+		pGameServer->OnClientEnter(i);
+	}
+
+	std::vector<CScriptedInput> vScripts;
+	std::vector<CNetObj_PlayerInput> vInputs(NumCharacters);
+	for(int i = 0; i < NumCharacters; i++)
+	{
+		vScripts.emplace_back(i * 7919u + 1);
+		mem_zero(&vInputs[i], sizeof(vInputs[i]));
+	}
+
+	dbg_msg("world_bench", "map=%s characters=%d bot_spawns=%d ticks=%d snapping=%d", pMapName, NumCharacters,
+		(int) pWorld->m_avSpawnPoints[2].size(), NumTicks, NumSnapping);
+
+	int64_t TickTime = 0;
+	int64_t SnapTime = 0;
+	int NumSnaps = 0;
+	for(int Tick = 0; Tick < NumTicks; Tick++)
+	{
+		pServer->AdvanceTick();
+		pRecorder->RecordTick(pServer->Tick());
+		for(int i = 0; i < NumCharacters; i++)
+		{
+			vScripts[i].Update(&vInputs[i]);
+			pRecorder->RecordInput(SIMREC_DIRECT_INPUT, i, (const int *) &vInputs[i], sizeof(vInputs[i]) / sizeof(int));
+			pGameServer->OnClientDirectInput(i, &vInputs[i]);
+			pRecorder->RecordInput(SIMREC_PREDICTED_INPUT, i, (const int *) &vInputs[i], sizeof(vInputs[i]) / sizeof(int));
+			pGameServer->OnClientPredictedInput(i, &vInputs[i]);
+		}
+
+		int64_t Start = time_get();
+		pGameServer->OnTick();
+		TickTime += time_get() - Start;
+		if(pRecorder->IsOpen())
+			pRecorder->RecordTickEnd(pGameServer->WorldHash());
+
+		// the server snaps every second tick
+		if(Tick % 2 == 0)
+		{
+			Start = time_get();
+			pGameServer->OnPreSnap();
+			for(int i = 0; i < NumSnapping; i++)
+				pServer->Snap(pGameServer, i);
+			pGameServer->OnPostSnap();
+			SnapTime += time_get() - Start;
+			NumSnaps++;
+
+			if(pRecorder->IsOpen())
+			{
+				std::vector<int> vSnapping;
+				for(int i = 0; i < NumSnapping; i++)
+					vSnapping.push_back(i);
+				pRecorder->RecordSnap(vSnapping.data(), NumSnapping);
+			}
+		}
+		pServer->m_Packets.EndTick();
+	}
+
+	int NumBotEntities = 0;
+	for(CEntity *pEnt = pWorld->FindFirst(CGameWorld::ENTTYPE_BOTENTITY); pEnt; pEnt = pEnt->TypeNext())
+		NumBotEntities++;
+
+	const double NsPerTime = 1000000000.0 / time_freq();
+	dbg_msg("world_bench", "bots alive at the end: %d, messages: %lld, snapshot bytes per snap: %lld", NumBotEntities,
+		(long long) pServer->m_NumMsgs, NumSnaps && NumSnapping ? (long long) (pServer->m_NumSnapBytes / NumSnaps / NumSnapping) : 0LL);
+	dbg_msg("world_bench", "world tick: %.0f ns/tick", TickTime * NsPerTime / NumTicks);
+	dbg_msg("world_bench", "snap:       %.0f ns/tick (%.0f ns per snapshot)", SnapTime * NsPerTime / NumTicks,
+		NumSnaps && NumSnapping ? SnapTime * NsPerTime / NumSnaps / NumSnapping : 0.0);
+	PrintPackets(&pServer->m_Packets, NumTicks);
+	if(pWorld->BotManager())
+	{
+		const CBotManager::CStats &Stats = pWorld->BotManager()->Stats();
+		dbg_msg("world_bench", "bot manager: %.0f ns/tick (%.0f in tick, %.0f in post snap)",
+			(Stats.m_TickTime + Stats.m_PostSnapTime) * NsPerTime / NumTicks, Stats.m_TickTime * NsPerTime / NumTicks, Stats.m_PostSnapTime * NsPerTime / NumTicks);
+	}
+	return 0;
+}
+
+int main(int argc, const char **argv)
+{
+	cmdline_fix(&argc, &argv);
+	dbg_logger_stdout();
+
+	const char *pMapName = "ctf5";
+	int NumCharacters = 16;
+	int NumBots = -1;
+	int NumTicks = 3000;
+	int NumSnapping = -1;
+	const char *pRecordFile = nullptr;
+	const char *pWriteFile = nullptr;
+	for(int i = 1; i < argc; i++)
+	{
+		if(i + 1 >= argc || argv[i][0] != '-')
+		{
+			Usage();
+			return -1;
+		}
+		const char *pValue = argv[++i];
+		switch(argv[i - 1][1])
+		{
+		case 'm': pMapName = pValue; break;
+		case 'c': NumCharacters = clamp(str_toint(pValue), 0, (int) SERVER_MAX_CLIENTS); break;
+		case 'b': NumBots = maximum(str_toint(pValue), 0); break;
+		case 't': NumTicks = maximum(str_toint(pValue), 1); break;
+		case 's': NumSnapping = str_toint(pValue); break;
+		case 'r': pRecordFile = pValue; break;
+		case 'w': pWriteFile = pValue; break;
+		default: Usage(); return -1;
+		}
+	}
+	// a record of a real server has no extra bot spawns
+	if(NumBots < 0 && !pRecordFile)
+		NumBots = 32;
+	// snapshots are built from the view of the characters
+	NumSnapping = NumSnapping < 0 ? NumCharacters : minimum(NumSnapping, NumCharacters);
+
+	if(secure_random_init() != 0)
+	{
+		dbg_msg("secure", "could not initialize secure RNG");
+		return -1;
+	}
+
+	CBenchServer *pServer = new CBenchServer();
+	IKernel *pKernel = IKernel::Create();
+
+	IEngineMap *pEngineMap = CreateEngineMap();
+	IGameServer *pGameServer = CreateGameServer();
+	IConsole *pConsole = CreateConsole(CFGFLAG_SERVER);
+	IStorage *pStorage = CreateStorage("Teeworlds", IStorage::STORAGETYPE_SERVER, argc, argv);
+	IConfigManager *pConfigManager = CreateConfigManager();
+	ILocalization *pLocalization = CreateLocalization(pStorage, pConsole, pConfigManager->Values());
+	{
+		bool RegisterFail = false;
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(static_cast<IServer *>(pServer));
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(static_cast<IEngineMap *>(pEngineMap)); // register as both
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(static_cast<IMap *>(pEngineMap));
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pGameServer);
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pConsole);
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pStorage);
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pConfigManager);
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pLocalization);
+		if(RegisterFail)
+			return -1;
+	}
+
+	pConfigManager->Init(CFGFLAG_SERVER);
+	pConsole->Init();
+	pLocalization->Init();
+	pServer->InitInterfaces(pKernel);
+	pGameServer->OnConsoleInit();
+	pConfigManager->RestoreStrings();
+
+	// the record starts with the seed of the random numbers and the map the server started on
+	CSimRecordReader Reader;
+	CSimRecord Init;
+	if(pRecordFile)
+	{
+		if(!Reader.Open(pStorage->OpenFile(pRecordFile, IOFLAG_READ, IStorage::TYPE_ALL)) || !Reader.Read(&Init) || Init.m_Type != SIMREC_INIT)
+		{
+			dbg_msg("world_bench", "failed to open simulation record '%s'", pRecordFile);
+			return -1;
+		}
+		srand((unsigned) Init.m_aInts[0]);
+		pMapName = Init.m_aString;
+	}
+
+	CSimRecorder Recorder;
+	if(pWriteFile && !pRecordFile)
+	{
+		const unsigned Seed = (unsigned) time_get();
+		if(!Recorder.Open(pStorage->OpenFile(pWriteFile, IOFLAG_WRITE, IStorage::TYPE_SAVE), Seed, pMapName))
+		{
+			dbg_msg("world_bench", "failed to open '%s' for writing", pWriteFile);
+			return -1;
+		}
+		srand(Seed);
+	}
+
+	CConfig *pConfig = pConfigManager->Values();
+	str_copy(pConfig->m_SvMap, pMapName, sizeof(pConfig->m_SvMap));
+	pConfig->m_SvMaxClients = SERVER_MAX_CLIENTS;
+	pConfig->m_SvSpamprotection = 0;
+
+	pGameServer->OnInit();
+	if(!pServer->MapLoaded())
+		return -1;
+
+	int Result;
+	if(pRecordFile)
+	{
+		dbg_msg("world_bench", "re-simulating '%s' on map=%s", pRecordFile, pMapName);
+		Result = Resimulate(pServer, pGameServer, &Reader, maximum(NumBots, 0)) == 0 ? 0 : 1;
+		Reader.Close();
+	}
+	else
+	{
+		Result = RunScripted(pServer, pGameServer, &Recorder, pMapName, NumCharacters, NumBots, NumTicks, NumSnapping);
+		if(Recorder.IsOpen())
+			dbg_msg("world_bench", "wrote %d ticks to '%s'", Recorder.NumTicks(), pWriteFile);
+		Recorder.Close();
+	}
+
+	pGameServer->OnShutdown();
+	pEngineMap->Unload();
+
+	delete pServer;
+	delete pKernel;
+	delete pEngineMap;
+	delete pGameServer;
+	delete pConsole;
+	delete pStorage;
+	delete pConfigManager;
+	delete pLocalization;
+
+	secure_random_uninit();
+	cmdline_free(argc, argv);
+	return Result;
+}